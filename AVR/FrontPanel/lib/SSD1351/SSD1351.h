@@ -500,25 +500,20 @@ class SSD1351OLED {
          */
 
         void DrawString(char *s, uint8_t x, uint8_t y,  FontConfig font,
-                uint16_t color = WHITE ) {
+                uint16_t color = WHITE,
+                uint16_t background = OLED_BACKGROUND_COLOR) {
             uint8_t width;
-            if (font.height==14){//if font 1
-                while (*s) {
-                    width = DrawCharRAM(*s,x,y,font,color);
-                    x += (width + 1);
-                    s++;
-                }
-            }else{
-                while (*s) {
-                    width = DrawChar(*s,x,y,font,color);
-                    x += (width + 1);
-                    s++;
-                }
+            while (*s) {
+                width = DrawCharRAM(*s,x,y,font,color,background);
+                x += (width + 1);
+                s++;
             }
         }
 
         /**
-         * Draw a character using a custom font
+         * Draw a character using a custom font, one pixel at a time
+         * Only the set pixels are written, so this is slow but leaves the
+         * background untouched
          */
         uint8_t DrawChar(char c, uint8_t x, uint8_t y, FontConfig font,
                 uint16_t color) {
@@ -551,45 +546,53 @@ class SSD1351OLED {
             return var_width;
         }
 
-        //Only works with vertical address increment mode
-        //doesn't work for Font2 for unknown reasons (Font2 might use horizontal increment mode)
-        uint8_t DrawCharRAM(char c, uint8_t x, uint8_t y,
-                FontConfig font, uint16_t color) {
+        /**
+         * Draw a character using a custom font by setting a single address
+         * window over its cell (glyph columns plus the trailing space column)
+         * and streaming every pixel of the cell, in foreground or background
+         * color, in one SPI burst
+         * Relies on the vertical address increment mode set in ScreenInit()
+         * Falls back to DrawChar() for cells that don't fit on the screen
+         */
+        uint8_t DrawCharRAM(char c, uint8_t x, uint8_t y, FontConfig font,
+                uint16_t color, uint16_t background = OLED_BACKGROUND_COLOR) {
             
             if (c < font.start_char ) c = font.start_char;
             if (c > font.end_char ) c = font.end_char;
             
             uint8_t bytes_high = font.height / 8 + 1;
             uint8_t bytes_per_char = font.width * bytes_high + 1;
-            uint8_t i;
             uint8_t var_width;
             unsigned const char *p;
             p = font.font_table + (c - font.start_char) * bytes_per_char;
             var_width = pgm_read_byte(p);
             p++;
-            SetColumnAddress(SSD1351_WIDTH-var_width-x-1,SSD1351_WIDTH-x); //invert  x 
-            SetRowAddress(SSD1351_HEIGHT-font.height-y-2,SSD1351_HEIGHT-y-1); //invert y
+
+            // cell is var_width glyph columns plus one space column, and
+            // font.height rows, using the same (inverted) mapping as DrawPixel
+            if ((uint16_t)x + var_width + 2 > SSD1351_WIDTH ||
+                (uint16_t)y + font.height + 1 > SSD1351_HEIGHT) {
+                return DrawChar(c,x,y,font,color);
+            }
+            SetColumnAddress(SSD1351_WIDTH-x-var_width-2,SSD1351_WIDTH-x-2); //invert x
+            SetRowAddress(SSD1351_HEIGHT-y-font.height-1,SSD1351_HEIGHT-y-2); //invert y
             SetWriteRAM();
-            uint8_t j;
-            i=var_width;
+
+            uint8_t i = var_width + 1;
             digitalWrite(_dc,HIGH);
             digitalWrite(_cs,LOW);
-            while(i-- > 0){//invert bitmap
-                j=bytes_high;
-                while(j-- > 0){//invert bitmap
-                    uint8_t dat = pgm_read_byte( p + i*bytes_high + j );
-                    uint8_t bit;
-                    bit=8;
-                    uint16_t pixel;
-                    while(bit-- > 0){
-                        if (dat & (1<<bit)) {
+            while(i-- > 0){//invert bitmap, starting with the space column
+                uint8_t row = font.height;
+                while(row-- > 0){//invert bitmap
+                    uint16_t pixel = background;
+                    if (i < var_width) {
+                        uint8_t dat = pgm_read_byte( p + i*bytes_high + row/8 );
+                        if (dat & (1<<(row & 7))) {
                             pixel = color;
-                        } else {
-                            pixel = BLACK;
                         }
-                        SPI.transfer(pixel>>8);
-                        SPI.transfer(pixel);
                     }
+                    SPI.transfer(pixel>>8);
+                    SPI.transfer(pixel);
                 }
             }
             digitalWrite(_cs,HIGH);
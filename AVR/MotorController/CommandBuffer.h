@@ -57,6 +57,22 @@ public:
         return receivedCommandCount == commandCapacity;
     }
 
+    // Return the number of complete commands in the buffer
+    inline uint8_t Count()
+    {
+        return receivedCommandCount;
+    }
+
+    // Return whether or not the specified data represents the address of a
+    // register the host will read from, rather than part of a command
+    // data The byte to check
+    inline bool IsReadRegister(unsigned char data)
+    {
+        return (data == MC_STATUS_REG || data == MC_QUEUE_REG ||
+                (data > MC_PROFILE_REG_LOW_FENCEPOST && data < MC_PROFILE_REG_HIGH_FENCEPOST)) &&
+                bytesRemaining == COMMAND_SIZE;
+    }
+
     // Handle adding a byte or bytes to the buffer
     //
     // If the specified data is a general command and the buffer is not in the
@@ -72,7 +88,7 @@ public:
     // data The byte to conditionally add to the buffer
     inline void AddCommandByte(unsigned char data)
     {
-        if (data == MC_STATUS_REG && bytesRemaining == COMMAND_SIZE)
+        if (IsReadRegister(data))
             // The controller received a read register address
             // Ignore as the data does not represent a command
             return;
@@ -55,6 +55,12 @@ const static uint8_t RAxisActionCommandMap[MC_ACTION_HIGH_FENCEPOST] PROGMEM =
     HomeRAxisRequested          // MC_HOME
 };
 
+const static uint8_t SequenceCommandMap[MC_SEQUENCE_HIGH_FENCEPOST] PROGMEM =
+{
+    MC_SEQUENCE_HIGH_FENCEPOST, // Map size
+    InterruptRequested          // MC_TAG
+};
+
 const static uint8_t* const RegisterMap[MC_COMMAND_REG_HIGH_FENCEPOST- MC_COMMAND_REG_LOW_FENCEPOST] PROGMEM =
 {
     0,                       // Invalid
@@ -62,7 +68,8 @@ const static uint8_t* const RegisterMap[MC_COMMAND_REG_HIGH_FENCEPOST- MC_COMMAN
     0,                       // MC_ROT_SETTINGS_REG
     RAxisActionCommandMap,   // MC_ROT_ACTION_REG
     0,                       // MC_Z_SETTINGS_REG
-    ZAxisActionCommandMap    // MC_Z_ACTION_REG
+    ZAxisActionCommandMap,   // MC_Z_ACTION_REG
+    SequenceCommandMap       // MC_SEQUENCE_REG
 };
 
 uint8_t CommandMap::GetEventCode(uint8_t commandRegister, uint8_t commandAction)
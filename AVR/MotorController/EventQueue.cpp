@@ -77,3 +77,9 @@ bool EventQueue::IsEmpty() const
 {
     return head == tail;
 }
+
+// Return the number of elements in the queue
+uint8_t EventQueue::Count() const
+{
+    return (head - tail + EVENT_QUEUE_LENGTH) % EVENT_QUEUE_LENGTH;
+}
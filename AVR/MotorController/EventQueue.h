@@ -43,6 +43,7 @@ public:
     void Remove(SM_EVENT_CODE_TYPE& eventCode, EventData& eventData);
     void Clear();
     bool IsEmpty() const;
+    uint8_t Count() const;
 
 private:
     EventQueue(const EventQueue&);
@@ -166,10 +166,24 @@
 #define LOAD_TIMER_CTRLA    TCCR2A            // Control register A
 #define LOAD_TIMER_CTRLB    TCCR2B            // Control register B
 #define LOAD_TIMER_IMSK     TIMSK2            // Interrupt mask register
-#define LOAD_TIMER_PERIOD   OCR2A             // Output compare register A (period of the timer)
 #define LOAD_TIMER_ISR_vect TIMER2_COMPA_vect // Output compare interrupt service routine vector
+#define LOAD_TIMER_OCIE_BM  (1<<OCIE2A)       // Enable output compare match interrupt
+#ifdef PROFILE
+// The timer runs continuously, also providing the profiler's time base, so the
+// software interrupt is requested by setting the compare register ahead of the
+// count rather than by starting the timer
+#define LOAD_TIMER_COMPARE  OCR2A             // Output compare register A
+#define LOAD_TIMER_CNT      TCNT2             // Timer count register
+#define LOAD_TIMER_IFR      TIFR2             // Interrupt flag register
+#define LOAD_TIMER_OVF_vect TIMER2_OVF_vect   // Overflow interrupt service routine vector
+#define LOAD_TIMER_CS_BM    (1<<CS21)         // Set clock source to F_CPU/8 (MC_PROFILE_CYCLES_PER_TICK)
+#define LOAD_TIMER_OCF_BM   (1<<OCF2A)        // Output compare match flag
+#define LOAD_TIMER_TOV_BM   (1<<TOV2)         // Overflow flag
+#define LOAD_TIMER_TOIE_BM  (1<<TOIE2)        // Enable overflow interrupt
+#else
+#define LOAD_TIMER_PERIOD   OCR2A             // Output compare register A (period of the timer)
 #define LOAD_TIMER_CS_BM    (1<<CS20)         // Set clock source to F_CPU
 #define LOAD_TIMER_WGM_BM   (1<<WGM21)        // Waveform generation mode
-#define LOAD_TIMER_OCIE_BM  (1<<OCIE2A)       // Enable output compare match interrupt
+#endif  // PROFILE
 
 #endif  // HARDWARE_H
@@ -29,10 +29,39 @@
 
 #include "I2CInterface.h"
 #include "CommandBuffer.h"
+#include "MotorController.h"
+#include "Profiler.h"
 
 #define I2C_ADDRESS 0x10
 
 static MotorController_t *mcState;
+static uint8_t transmitCount;
+static uint8_t transmitLength;
+static uint8_t transmitBuffer[MC_PROFILE_DATA_SIZE]; // Sized for the longest read register
+
+// Load the contents of the register last addressed for reading into the transmit buffer
+static void LoadTransmitBuffer()
+{
+    uint8_t readRegister = mcState->readRegister;
+
+    if (readRegister == MC_QUEUE_REG)
+    {
+        // The last completed tag, followed by the free command slots
+        transmitBuffer[0] = mcState->lastCompletedTag;
+        transmitBuffer[1] = mcState->freeCommandSlots;
+        transmitLength = 2;
+    }
+    else if (readRegister > MC_PROFILE_REG_LOW_FENCEPOST && readRegister < MC_PROFILE_REG_HIGH_FENCEPOST)
+    {
+        Profiler::Read(readRegister, transmitBuffer);
+        transmitLength = MC_PROFILE_DATA_SIZE;
+    }
+    else
+    {
+        transmitBuffer[0] = mcState->status;
+        transmitLength = 1;
+    }
+}
 
 // Initialize the I2C interface
 void I2CInterface::Initialize(MotorController_t *mc)
@@ -53,6 +82,8 @@ void I2CInterface::Initialize(MotorController_t *mc)
 // I2C (TWI) interrupt service routine
 ISR(TWI_vect)
 {
+    PROFILE_BEGIN();
+
     switch(TW_STATUS)
     {
         // Slave Receiver status codes
@@ -69,8 +100,13 @@ ISR(TWI_vect)
         case TW_SR_GCALL_DATA_ACK:          // 0x90: data byte has been received, ACK has been returned
             // SR->DATA_ACK
 
+            // Record which register the master will read from next
+            if (commandBuffer.IsReadRegister(TWDR))
+                mcState->readRegister = TWDR;
+
             // Store previously received data byte in buffer
             commandBuffer.AddCommandByte(TWDR);
+            MotorController::UpdateFreeCommandSlots(mcState);
 
             // Check receive buffer status
             if(commandBuffer.IsFull())
@@ -99,11 +135,19 @@ ISR(TWI_vect)
         case TW_ST_ARB_LOST_SLA_ACK:        // 0xB0:     GCA+R has been received, ACK has been returned
             // ST->SLA_ACK
             // We are being addressed as slave for reading (data must be transmitted back to master)
+            transmitCount = 0;
+            LoadTransmitBuffer();
             // Fall-through to transmit first data byte
         case TW_ST_DATA_ACK:                // 0xB8: data byte has been transmitted, ACK has been received
             // ST->DATA_ACK
             // Transmit data byte
-            TWDR = mcState->status;
+            TWDR = transmitBuffer[transmitCount++];
+            if (transmitCount < transmitLength)
+            {
+                // Expect ACK to data byte
+                TWCR |= (1<<TWIE) | (1<<TWINT) | (1<<TWEA) | (1<<TWEN);
+                break;
+            }
             // End of data to write reached, expect NACK to data byte
             TWCR |= (1<<TWIE) | (1<<TWINT) | (0<<TWEA) | (1<<TWEN);
         case TW_ST_DATA_NACK:               // 0xC0: data byte has been transmitted, NACK has been received
@@ -125,5 +169,7 @@ ISR(TWI_vect)
             TWCR |= (1<<TWIE) | (1<<TWINT) | (1<<TWEA) | (1<<TWEN) | (1<<TWSTO);
             break;
     }
+
+    PROFILE_END(MC_PROFILE_I2C_ISR_REG);
 }
 
@@ -21,6 +21,7 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <avr/interrupt.h>
 #include <util/delay.h>
 #include <string.h>
 
@@ -30,6 +31,9 @@
 #include "Hardware.h"
 #include "MachineDefinitions.h"
 #include "PlannerBufferPool.h"
+#include "Profiler.h"
+#include "CommandBuffer.h"
+#include "EventQueue.h"
 #include "../../C++/include/MotorController.h" // Shared header defining commands
 
 #ifdef DEBUG
@@ -62,19 +66,43 @@ void MotorController::Initialize(MotorController_t* mcState)
     LIMIT_SW_PCMSK &= ~R_AXIS_LIMIT_SW_PCINT_BM;
 
     Motors::Initialize(mcState);
+    Profiler::Initialize();
     Planner::Initialize(mcState);
     PlannerBufferPool::Initialize();
 }
 
 // Generate a 50ms low pulse on the otherwise high interrupt signal line
+// If the request carries a sequence tag, record it as the last completed tag
+// first, so the host can read it in response to the interrupt
+// General interrupt requests have a parameter of 0
 // This function blocks for the pulse duration
-void MotorController::GenerateInterrupt()
+void MotorController::GenerateInterrupt(EventData eventData, MotorController_t* mcState)
 {
+    if (eventData.parameter != 0)
+        mcState->lastCompletedTag = eventData.parameter;
+
     INTERRUPT_PORT &= ~INTERRUPT_BM;
     _delay_ms(50);
     INTERRUPT_PORT |= INTERRUPT_BM;
 }
 
+// Update the number of commands the host can send without overflowing the
+// command buffer or the event queue, for the host to read over I2C
+// The event queue holds one fewer event than its length, and another slot is
+// reserved for the interrupt request requeued while waiting to handle an action
+// Called whenever either queue changes, from the main loop and the I2C ISR
+void MotorController::UpdateFreeCommandSlots(MotorController_t* mcState)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    int16_t freeSlots = (EVENT_QUEUE_LENGTH - 2) -
+            MotorController_State_Machine_EventQueue_Count() - commandBuffer.Count();
+    mcState->freeCommandSlots = freeSlots > 0 ? freeSlots : 0;
+
+    SREG = sreg;
+}
+
 // Inspect settings event data and update specified settings object accordingly
 Status MotorController::UpdateSettings(uint8_t axis, EventData eventData, AxisSettings& axisSettings)
 {
@@ -33,7 +33,8 @@
 namespace MotorController
 {
 void Initialize(MotorController_t* mcState);
-void GenerateInterrupt();
+void GenerateInterrupt(EventData eventData, MotorController_t* mcState);
+void UpdateFreeCommandSlots(MotorController_t* mcState);
 Status UpdateSettings(uint8_t axis, EventData eventData, AxisSettings& axisSettings);
 Status HomeZAxis(int32_t homingDistance, MotorController_t* mcState);
 Status HomeRAxis(int32_t homingDistance, MotorController_t* mcState);
@@ -43,6 +43,9 @@ struct MotorControllerState
     bool reset;                                 // Reset the controller immediately?
     bool axisAtLimit;                           // Raise an axis at limit event immediately?
     Status volatile status = MC_STATUS_SUCCESS; // Status code (possibly set in exec timer ISR)
+    uint8_t volatile lastCompletedTag;          // Tag of the last completed sequence (read in I2C ISR)
+    uint8_t volatile freeCommandSlots;          // Commands that can be received without overflowing the queues (read in I2C ISR)
+    uint8_t volatile readRegister;              // Status register last addressed for reading (set in I2C ISR)
     EventData queuedEventData;                  // EventData for the next queued event to handle
     SM_EVENT_CODE_TYPE queuedEventCode;         // The state machine code of the next queued event to handle
 };
@@ -36,6 +36,7 @@
 #include "Hardware.h"
 #include "MachineDefinitions.h"
 #include "PlannerBufferPool.h"
+#include "Profiler.h"
 
 #ifdef DEBUG
 #include "Debug.h"
@@ -44,6 +45,9 @@
 #define _f_to_period(f) (uint16_t)((float)F_CPU / (float)f)
 #define F_DDA (float)40000  // DDA frequency in hz.
 #define SOFTWARE_INTERRUPT_PERIOD 99 // Cycles (less one) before interrupt is actually generated after software interrupt is called
+#ifdef PROFILE
+#define LOAD_INTERRUPT_DELAY 12 // Load timer ticks (of 8 cycles) before interrupt is actually generated after software interrupt is called
+#endif  // PROFILE
 
 // DDA_SUBSTEPS sets the amount of fractional precision for substepping.
 // Substepping is kind of like microsteps done in software to make
@@ -122,11 +126,18 @@ void Motors::Initialize(MotorController_t* mc)
     DDA_TIMER_PERIOD = _f_to_period(F_DDA);
 
     // Setup load software interrupt timer
+#ifdef PROFILE
+    // Run timer continuously and only generate interrupt on compare match when requested
+    LOAD_TIMER_CTRLA  = 0;
+    LOAD_TIMER_CTRLB  = LOAD_TIMER_CS_BM;
+    LOAD_TIMER_IMSK   = 0;
+#else
     // Clear timer and generate interrupt on compare match
     LOAD_TIMER_CTRLA  = LOAD_TIMER_WGM_BM;
     LOAD_TIMER_CTRLB  = 0;
     LOAD_TIMER_IMSK   = LOAD_TIMER_OCIE_BM;
     LOAD_TIMER_PERIOD = SOFTWARE_INTERRUPT_PERIOD;
+#endif  // PROFILE
 
     // Setup exec software interrupt timer
     // Clear timer and generate interrupt on compare match
@@ -293,6 +304,18 @@ void Motors::RequestMoveExecution()
         EXEC_TIMER_CTRLB |= EXEC_TIMER_CS_BM;
 }
 
+// Request loading of next move using timer-driven software interrupt
+static inline void requestLoad()
+{
+#ifdef PROFILE
+    LOAD_TIMER_COMPARE = LOAD_TIMER_CNT + LOAD_INTERRUPT_DELAY;
+    LOAD_TIMER_IFR = LOAD_TIMER_OCF_BM; // Clear match flag set while not requested
+    LOAD_TIMER_IMSK |= LOAD_TIMER_OCIE_BM;
+#else
+    LOAD_TIMER_CTRLB |= LOAD_TIMER_CS_BM;
+#endif  // PROFILE
+}
+
 // Dequeue move and load into stepper struct
 // This routine can only be called be called from an ISR at the same or 
 // higher level as the DDA timer ISR (DDA or load)
@@ -371,6 +394,7 @@ static void loadMove()
 // Step pulses are generated by transitioning the step pin from low to high and high to low
 ISR(DDA_TIMER_ISR_vect)
 {
+    PROFILE_BEGIN();
 
     if ((runtimeState.motorRuntime[Z_AXIS].phaseAccumulator += runtimeState.motorRuntime[Z_AXIS].phaseIncrement) > 0)
     {
@@ -399,12 +423,16 @@ ISR(DDA_TIMER_ISR_vect)
         DDA_TIMER_CTRLB &= ~DDA_TIMER_CS_BM;
         loadMove();
     }
+
+    PROFILE_END(MC_PROFILE_DDA_ISR_REG);
 }
 
 // Move execution software interrupt ISR
 // Responds to interrupt
 ISR(EXEC_TIMER_ISR_vect)
 {
+    PROFILE_BEGIN();
+
     // Disable timer
     EXEC_TIMER_CTRLB &= ~EXEC_TIMER_CS_BM;
   
@@ -427,16 +455,24 @@ ISR(EXEC_TIMER_ISR_vect)
             
             // Only fire an interrupt to load the next move if the currently loaded move is complete
             if (runtimeState.ddaTicksDowncount == 0)
-                LOAD_TIMER_CTRLB |= LOAD_TIMER_CS_BM;
+                requestLoad();
         }
     }
+
+    PROFILE_END(MC_PROFILE_EXEC_ISR_REG);
 }
 
 // Load move software interrupt ISR
 // Responds to interrupt
 ISR(LOAD_TIMER_ISR_vect)
 {
+    PROFILE_BEGIN();
+#ifdef PROFILE
+    LOAD_TIMER_IMSK &= ~LOAD_TIMER_OCIE_BM; // Disable load software interrupt
+#else
     LOAD_TIMER_CTRLB &= ~LOAD_TIMER_CS_BM; // Disable load software interrupt timer
+#endif  // PROFILE
     loadMove();
+    PROFILE_END(MC_PROFILE_LOAD_ISR_REG);
 }
 
@@ -0,0 +1,124 @@
+//  File: Profiler.cpp
+//  Accounts for the time spent in interrupt service routines and state machine
+//  events
+//
+//  This file is part of the Ember Motor Controller firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <avr/interrupt.h>
+#include <string.h>
+
+#include "Profiler.h"
+#include "Hardware.h"
+
+#ifdef PROFILE
+struct ProfileCounter
+{
+    uint16_t maxTicks;   // Longest time accounted in one call
+    uint16_t count;      // Number of calls accounted
+    uint32_t totalTicks; // Total time accounted in those calls
+};
+
+static ProfileCounter counters[PROFILE_SLOT_COUNT];
+static volatile uint8_t overflowCount;
+
+// Load timer overflow ISR
+// Extends the 8-bit load timer count to the 16-bit time base
+ISR(LOAD_TIMER_OVF_vect)
+{
+    overflowCount++;
+}
+#endif  // PROFILE
+
+// Clear the counters and start extending the free-running load timer
+// Must be called after Motors::Initialize sets up the load timer
+void Profiler::Initialize()
+{
+#ifdef PROFILE
+    memset(counters, 0, sizeof(counters));
+    overflowCount = 0;
+    LOAD_TIMER_IFR = LOAD_TIMER_TOV_BM;
+    LOAD_TIMER_IMSK |= LOAD_TIMER_TOIE_BM;
+#endif  // PROFILE
+}
+
+// Return the current time in load timer ticks
+// The overflow ISR can't run while another ISR is running, so durations
+// measured within an ISR are only accurate up to two timer periods (512 ticks)
+uint16_t Profiler::Now()
+{
+#ifdef PROFILE
+    uint8_t sreg = SREG;
+    cli();
+    uint8_t count = LOAD_TIMER_CNT;
+    uint8_t overflows = overflowCount;
+    // Account for an overflow whose ISR hasn't run yet
+    if ((LOAD_TIMER_IFR & LOAD_TIMER_TOV_BM) && count != 0xFF)
+        overflows++;
+    SREG = sreg;
+    return (static_cast<uint16_t>(overflows) << 8) | count;
+#else
+    return 0;
+#endif  // PROFILE
+}
+
+// Account the time since the specified start time to the slot read through the
+// specified profiling register
+void Profiler::Record(uint8_t profileRegister, uint16_t start)
+{
+#ifdef PROFILE
+    uint16_t ticks = Now() - start;
+    uint8_t slot = profileRegister - MC_PROFILE_REG_LOW_FENCEPOST - 1;
+    if (slot >= PROFILE_SLOT_COUNT)
+        return;
+
+    // The I2C ISR reads the counters, so update them atomically
+    uint8_t sreg = SREG;
+    cli();
+    ProfileCounter& counter = counters[slot];
+    if (ticks > counter.maxTicks)
+        counter.maxTicks = ticks;
+    // Halve the count and total rather than overflow, preserving the average
+    if (counter.count == 0xFFFF)
+    {
+        counter.count /= 2;
+        counter.totalTicks /= 2;
+    }
+    counter.count++;
+    counter.totalTicks += ticks;
+    SREG = sreg;
+#endif  // PROFILE
+}
+
+// Copy the MC_PROFILE_DATA_SIZE bytes read through the specified profiling
+// register into the specified buffer
+void Profiler::Read(uint8_t profileRegister, uint8_t* data)
+{
+#ifdef PROFILE
+    const ProfileCounter& counter = counters[profileRegister - MC_PROFILE_REG_LOW_FENCEPOST - 1];
+    data[0] = counter.maxTicks;
+    data[1] = counter.maxTicks >> 8;
+    data[2] = counter.count;
+    data[3] = counter.count >> 8;
+    data[4] = counter.totalTicks;
+    data[5] = counter.totalTicks >> 8;
+    data[6] = counter.totalTicks >> 16;
+    data[7] = counter.totalTicks >> 24;
+#else
+    memset(data, 0, MC_PROFILE_DATA_SIZE);
+#endif  // PROFILE
+}
@@ -0,0 +1,50 @@
+//  File: Profiler.h
+//  Accounts for the time spent in interrupt service routines and state machine
+//  events
+//
+//  This file is part of the Ember Motor Controller firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#include "Status.h"
+
+// Number of slots for which time is accounted, one for each profiling register
+#define PROFILE_SLOT_COUNT (MC_PROFILE_REG_HIGH_FENCEPOST - MC_PROFILE_REG_LOW_FENCEPOST - 1)
+
+#ifdef PROFILE
+// Account the time from PROFILE_BEGIN to PROFILE_END in the same block to the
+// slot read through the specified profiling register
+#define PROFILE_BEGIN() uint16_t profileStart = Profiler::Now()
+#define PROFILE_END(profileRegister) Profiler::Record((profileRegister), profileStart)
+#else
+#define PROFILE_BEGIN()
+#define PROFILE_END(profileRegister)
+#endif  // PROFILE
+
+namespace Profiler
+{
+void Initialize();
+uint16_t Now();
+void Record(uint8_t profileRegister, uint16_t start);
+void Read(uint8_t profileRegister, uint8_t* data);
+}
+
+#endif  // PROFILER_H
@@ -104,6 +104,12 @@ void MotorController_State_Machine_Reset_EventQueue()
     eventQueue = EventQueue();
 }
 
+// Return the number of events in the event queue
+uint8_t MotorController_State_Machine_EventQueue_Count()
+{
+    return eventQueue.Count();
+}
+
 // If the event queue is not empty, dequeue an event and store it in the state instance
 static void DequeueEvent(MotorController_t* mcState)
 {
@@ -111,6 +117,7 @@ static void DequeueEvent(MotorController_t* mcState)
     {
         mcState->queuedEvent = true;
         eventQueue.Remove(mcState->queuedEventCode, mcState->queuedEventData);
+        MotorController::UpdateFreeCommandSlots(mcState);
     }
 }
 
@@ -1001,7 +1008,7 @@ MotorController_State_Machine_Event(
 
                               /**> GenerateInterrupt */
 
-               MotorController::GenerateInterrupt();
+               MotorController::GenerateInterrupt(_sm_evt, _sm_obj);
 
                               /**> Group: DequeueEvent */
 
@@ -1130,7 +1137,7 @@ MotorController_State_Machine_Event(
 
                               /**> GenerateInterrupt */
 
-               MotorController::GenerateInterrupt();
+               MotorController::GenerateInterrupt(_sm_evt, _sm_obj);
 
                               /**> Group: DequeueEvent */
 
@@ -35,5 +35,6 @@ typedef struct MotorControllerState MotorController_t;
 #include "MotorControllerState.h"
 
 void MotorController_State_Machine_Reset_EventQueue();
+uint8_t MotorController_State_Machine_EventQueue_Count();
 
 #endif  // STATEMACHINE_H
@@ -29,6 +29,8 @@
 #include "CommandMap.h"
 #include "StateMachine.h"
 #include "Planner.h"
+#include "EventQueue.h"
+#include "Profiler.h"
 
 #ifdef DEBUG
 #include "Debug.h"
@@ -39,6 +41,14 @@ MotorController_t mcState; // Instance of the global state struct, all members i
 CommandBuffer commandBuffer;
 volatile bool limitSwitchHit;
 
+// Handle the specified event in the state machine, accounting for the time it takes
+static void HandleEvent(EventData eventData, SM_EVENT_CODE_TYPE eventCode)
+{
+    PROFILE_BEGIN();
+    MotorController_State_Machine_Event(&mcState, eventData, eventCode);
+    PROFILE_END(MC_PROFILE_EVENT_REG + eventCode - ResetRequested);
+}
+
 // Check limit switch interrupt flag and raise limit reached event if set
 static void QueryLimitSwitchInterrupt()
 {
@@ -46,7 +56,7 @@ static void QueryLimitSwitchInterrupt()
     {
         limitSwitchHit = false;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, AxisLimitReached);
+        HandleEvent(eventData, AxisLimitReached);
     }
 }
 
@@ -78,7 +88,10 @@ static void QueryCommandBuffer()
 
         eventData.command = command.Action();
         eventData.parameter = command.Parameter();
-        MotorController_State_Machine_Event(&mcState, eventData, eventCode);
+        HandleEvent(eventData, eventCode);
+
+        // The command left the buffer and may have been queued as an event
+        MotorController::UpdateFreeCommandSlots(&mcState);
     }
 }
 
@@ -89,7 +102,7 @@ static void QueryMotionComplete()
     {
         mcState.motionComplete = false;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, MotionComplete);
+        HandleEvent(eventData, MotionComplete);
     }
 }
 
@@ -102,7 +115,7 @@ static bool QueryEventQueue()
     if (mcState.queuedEvent)
     {
         mcState.queuedEvent = false;
-        MotorController_State_Machine_Event(&mcState, mcState.queuedEventData, mcState.queuedEventCode);
+        HandleEvent(mcState.queuedEventData, mcState.queuedEventCode);
         return true;
     }
     return false;
@@ -115,7 +128,7 @@ static void QueryError()
     {
         mcState.error = false;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, ErrorEncountered);
+        HandleEvent(eventData, ErrorEncountered);
     }
 }
 
@@ -135,6 +148,7 @@ static void QueryReset()
         commandBuffer = CommandBuffer();
 
         MotorController_State_Machine_Reset_EventQueue();
+        MotorController::UpdateFreeCommandSlots(&mcState);
     }
 }
 
@@ -145,7 +159,7 @@ static void QueryCommandBufferFull()
     {
         mcState.status = MC_STATUS_COMMAND_BUFFER_FULL;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, ErrorEncountered);
+        HandleEvent(eventData, ErrorEncountered);
     }
 }
 
@@ -156,7 +170,7 @@ static void QueryDecelerationStarted()
     {
         mcState.decelerationStarted = false;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, DecelerationStarted);
+        HandleEvent(eventData, DecelerationStarted);
     }
 }
 
@@ -167,7 +181,7 @@ static void QueryAxisAtLimit()
     {
         mcState.axisAtLimit = false;
         EventData eventData;
-        MotorController_State_Machine_Event(&mcState, eventData, AxisAtLimit);
+        HandleEvent(eventData, AxisAtLimit);
     }
 }
 
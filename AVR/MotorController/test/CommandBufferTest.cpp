@@ -33,6 +33,9 @@ class CommandBufferTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testAddAndRemoveNonGeneralCommand);
     CPPUNIT_TEST(testAddAndRemoveGeneralCommand);
     CPPUNIT_TEST(testAddStatusRegister);
+    CPPUNIT_TEST(testAddQueueRegister);
+    CPPUNIT_TEST(testAddProfileRegisters);
+    CPPUNIT_TEST(testCount);
     CPPUNIT_TEST(testAddWhenCapacityExceeded);
     CPPUNIT_TEST(testIsFull);
     CPPUNIT_TEST_SUITE_END();
@@ -154,6 +157,64 @@ public:
         CPPUNIT_ASSERT_EQUAL(0, command.Parameter());
     }
 
+    void testAddQueueRegister()
+    {
+        Command command;
+        
+        CPPUNIT_ASSERT(buffer->IsReadRegister(MC_QUEUE_REG));
+
+        buffer->AddCommandByte(MC_QUEUE_REG);
+        buffer->AddCommandByte(MC_RESET);
+        
+        buffer->GetCommand(command);
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(MC_GENERAL_REG), command.Register());
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(MC_RESET), command.Action());
+        CPPUNIT_ASSERT_EQUAL(0, command.Parameter());
+
+        // A register address within a command is part of the command
+        buffer->AddCommandByte(MC_SEQUENCE_REG);
+        CPPUNIT_ASSERT(!buffer->IsReadRegister(MC_QUEUE_REG));
+    }
+
+    void testAddProfileRegisters()
+    {
+        Command command;
+
+        CPPUNIT_ASSERT(!buffer->IsReadRegister(MC_PROFILE_REG_LOW_FENCEPOST));
+        CPPUNIT_ASSERT(!buffer->IsReadRegister(MC_PROFILE_REG_HIGH_FENCEPOST));
+
+        for (uint8_t profileRegister = MC_PROFILE_DDA_ISR_REG;
+             profileRegister < MC_PROFILE_REG_HIGH_FENCEPOST; profileRegister++)
+        {
+            CPPUNIT_ASSERT(buffer->IsReadRegister(profileRegister));
+            buffer->AddCommandByte(profileRegister);
+        }
+
+        CPPUNIT_ASSERT(buffer->IsEmpty());
+
+        buffer->AddCommandByte(MC_PAUSE);
+
+        buffer->GetCommand(command);
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(MC_GENERAL_REG), command.Register());
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(MC_PAUSE), command.Action());
+    }
+
+    void testCount()
+    {
+        Command command;
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(0), buffer->Count());
+
+        addNonGeneralCommand(0);
+        addNonGeneralCommand(1);
+        buffer->AddCommandByte(MC_INTERRUPT);
+        
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(3), buffer->Count());
+        
+        buffer->GetCommand(command);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(2), buffer->Count());
+    }
+
     void testAddWhenCapacityExceeded()
     {
         Command command;
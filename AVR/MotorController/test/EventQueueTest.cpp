@@ -31,6 +31,7 @@ class EventQueueTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testAdd);
     CPPUNIT_TEST(testQueue);
     CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST(testCount);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -110,6 +111,30 @@ public:
 
     }
 
+    void testCount()
+    {
+        EventQueue eventQueue;
+        EventData eventData;
+        uint8_t eventCode;
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(0), eventQueue.Count());
+
+        // Wrap around the end of the ring buffer
+        for (int i = 0; i < EVENT_QUEUE_LENGTH - 2; i++)
+        {
+            eventQueue.Add(0, eventData);
+            eventQueue.Remove(eventCode, eventData);
+        }
+
+        for (int i = 0; i < 5; i++)
+            eventQueue.Add(0, eventData);
+        
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(5), eventQueue.Count());
+
+        eventQueue.Remove(eventCode, eventData);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(4), eventQueue.Count());
+    }
+
     void testClear()
     {
         EventQueue eventQueue;
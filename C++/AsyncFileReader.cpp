@@ -0,0 +1,408 @@
+//  File:   AsyncFileReader.cpp
+//  Reads whole files with several reads in flight, using io_uring when the
+//  kernel supports it and synchronous reads otherwise
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "AsyncFileReader.h"
+
+// Reads the entire file specified by path into contents.
+static bool ReadSynchronously(const std::string& path, std::string& contents)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file.good())
+        return false;
+    
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return !file.bad();
+}
+
+// Constructor
+// Falls back to synchronous reads if an io_uring instance can't be set up,
+// e.g. on kernels older than 5.1.
+AsyncFileReader::AsyncFileReader(int queueDepth, size_t bufferSize) :
+_ringFd(-1),
+_registeredBuffers(false),
+_slots(queueDepth),
+_sqRing(MAP_FAILED),
+_sqRingSize(0),
+_cqRing(MAP_FAILED),
+_cqRingSize(0),
+_sqes(NULL),
+_sqesSize(0)
+{
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        _slots[i].state = Free;
+        _slots[i].fd = -1;
+    }
+    
+    if (!SetUpRing(queueDepth))
+    {
+        TearDownRing();
+        return;
+    }
+    
+    for (size_t i = 0; i < _slots.size(); i++)
+        _slots[i].buffer.resize(bufferSize);
+
+#ifdef HAVE_IO_URING
+    // register the buffers with the kernel to spare it from mapping them for 
+    // every read, which may not be allowed if locked memory is limited
+    std::vector<struct iovec> iovecs(_slots.size());
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        iovecs[i].iov_base = _slots[i].buffer.data();
+        iovecs[i].iov_len = bufferSize;
+    }
+
+    _registeredBuffers = syscall(__NR_io_uring_register, _ringFd, 
+                                 IORING_REGISTER_BUFFERS, iovecs.data(), 
+                                 iovecs.size()) == 0;
+#endif
+}
+
+// Destructor waits for any reads still in flight, since the kernel may still
+// be writing to their buffers.
+AsyncFileReader::~AsyncFileReader()
+{
+    DiscardOutside(0, -1);
+    
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        while (_slots[i].state == Abandoned)
+        {
+            if (!ReapCompletions(true))
+                break;
+        }
+    }
+    
+    TearDownRing();
+}
+
+// Start reading the file specified by path, identified by tag.  If there's 
+// no free slot, the file is too large, or io_uring isn't available, the file
+// will be read synchronously when waited for instead.  Returns false if the 
+// file can't be opened.
+bool AsyncFileReader::Submit(int tag, const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    
+    struct stat fileStat;
+    int slotIndex = FindSlot(-1);
+    if (!IsAsync() || slotIndex < 0 || fstat(fd, &fileStat) != 0 ||
+        (size_t)fileStat.st_size > _slots[slotIndex].buffer.size())
+    {
+        close(fd);
+        _deferredPaths[tag] = path;
+        return true;
+    }
+    
+    Slot& slot = _slots[slotIndex];
+    slot.tag = tag;
+    slot.fd = fd;
+    slot.size = fileStat.st_size;
+    slot.result = 0;
+    
+    if (!SubmitToRing(slotIndex))
+    {
+        FreeSlot(slot);
+        _deferredPaths[tag] = path;
+    }
+    
+    return true;
+}
+
+// Returns true if the read identified by tag was submitted and not yet 
+// waited for.
+bool AsyncFileReader::IsPending(int tag) const
+{
+    return _deferredPaths.count(tag) > 0 || FindSlot(tag) >= 0;
+}
+
+// Wait for the read identified by tag to complete and get the file's 
+// contents.  Returns false if the read wasn't submitted or failed.
+bool AsyncFileReader::Wait(int tag, std::string& contents)
+{
+    std::map<int, std::string>::iterator it = _deferredPaths.find(tag);
+    if (it != _deferredPaths.end())
+    {
+        std::string path = it->second;
+        _deferredPaths.erase(it);
+        return ReadSynchronously(path, contents);
+    }
+    
+    int slotIndex = FindSlot(tag);
+    if (slotIndex < 0)
+        return false;
+    
+    Slot& slot = _slots[slotIndex];
+    while (slot.state == InFlight)
+    {
+        if (!ReapCompletions(true))
+            break;
+    }
+    
+    bool success = slot.state == Completed && slot.result >= 0;
+    if (success)
+    {
+        contents.assign(slot.buffer.data(), slot.result);
+        
+        // finish a short read synchronously
+        while (success && contents.size() < slot.size)
+        {
+            char buffer[4096];
+            ssize_t n = pread(slot.fd, buffer, sizeof(buffer), contents.size());
+            if (n > 0)
+                contents.append(buffer, n);
+            else
+                success = false;
+        }
+    }
+    
+    if (slot.state == InFlight)
+        slot.state = Abandoned;
+    else
+        FreeSlot(slot);
+    
+    return success;
+}
+
+// Forget about pending reads whose tags are outside of the given range, 
+// e.g. upcoming layers that won't be needed after all.
+void AsyncFileReader::DiscardOutside(int firstTag, int lastTag)
+{
+    std::map<int, std::string>::iterator it = _deferredPaths.begin();
+    while (it != _deferredPaths.end())
+    {
+        if (it->first < firstTag || it->first > lastTag)
+            _deferredPaths.erase(it++);
+        else
+            ++it;
+    }
+    
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        Slot& slot = _slots[i];
+        if (slot.tag >= firstTag && slot.tag <= lastTag)
+            continue;
+        
+        if (slot.state == Completed)
+            FreeSlot(slot);
+        else if (slot.state == InFlight)
+            slot.state = Abandoned;
+    }
+}
+
+// Create an io_uring instance and map its queues.  Returns false if io_uring 
+// isn't available.
+bool AsyncFileReader::SetUpRing(int queueDepth)
+{
+#ifdef HAVE_IO_URING
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    
+    _ringFd = syscall(__NR_io_uring_setup, queueDepth, &params);
+    if (_ringFd < 0)
+        return false;
+    
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _sqRing = mmap(NULL, _sqRingSize, PROT_READ | PROT_WRITE, 
+                   MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+    if (_sqRing == MAP_FAILED)
+        return false;
+    
+    _cqRingSize = params.cq_off.cqes + 
+                  params.cq_entries * sizeof(struct io_uring_cqe);
+    _cqRing = mmap(NULL, _cqRingSize, PROT_READ | PROT_WRITE, 
+                   MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+    if (_cqRing == MAP_FAILED)
+        return false;
+    
+    _sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, 
+                      MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return false;
+    _sqes = (struct io_uring_sqe*)sqes;
+    
+    char* sq = (char*)_sqRing;
+    _sqHead  = (unsigned*)(sq + params.sq_off.head);
+    _sqTail  = (unsigned*)(sq + params.sq_off.tail);
+    _sqMask  = (unsigned*)(sq + params.sq_off.ring_mask);
+    _sqArray = (unsigned*)(sq + params.sq_off.array);
+    
+    char* cq = (char*)_cqRing;
+    _cqHead = (unsigned*)(cq + params.cq_off.head);
+    _cqTail = (unsigned*)(cq + params.cq_off.tail);
+    _cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    _cqes   = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Release the io_uring instance, if any.
+void AsyncFileReader::TearDownRing()
+{
+    if (_sqes != NULL)
+        munmap(_sqes, _sqesSize);
+    if (_cqRing != MAP_FAILED)
+        munmap(_cqRing, _cqRingSize);
+    if (_sqRing != MAP_FAILED)
+        munmap(_sqRing, _sqRingSize);
+    if (_ringFd >= 0)
+        close(_ringFd);
+    
+    _sqes = NULL;
+    _cqRing = MAP_FAILED;
+    _sqRing = MAP_FAILED;
+    _ringFd = -1;
+}
+
+// Queue a read of the whole file for the given slot and tell the kernel 
+// about it.  Returns false, with nothing left queued, if the kernel didn't 
+// take the read.
+bool AsyncFileReader::SubmitToRing(int slotIndex)
+{
+#ifdef HAVE_IO_URING
+    Slot& slot = _slots[slotIndex];
+    
+    unsigned tail = *_sqTail;
+    unsigned index = tail & *_sqMask;
+    struct io_uring_sqe* sqe = &_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    
+    sqe->fd = slot.fd;
+    sqe->off = 0;
+    sqe->user_data = slotIndex;
+    if (_registeredBuffers)
+    {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = (unsigned long)slot.buffer.data();
+        sqe->len = slot.size;
+        sqe->buf_index = slotIndex;
+    }
+    else
+    {
+        // a readv of a single iovec, which must outlive the read on older 
+        // kernels
+        slot.iov.iov_base = slot.buffer.data();
+        slot.iov.iov_len = slot.size;
+        sqe->opcode = IORING_OP_READV;
+        sqe->addr = (unsigned long)&slot.iov;
+        sqe->len = 1;
+    }
+    
+    _sqArray[index] = index;
+    __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    if (syscall(__NR_io_uring_enter, _ringFd, 1, 0, 0, NULL, 0) != 1 &&
+        __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) == tail)
+    {
+        // the kernel didn't take the entry, so withdraw it before the slot is
+        // freed, rather than leave it for the next call to submit
+        __atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    // once taken, the entry's completion reports whether the read failed
+    slot.state = InFlight;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Record the results of completed reads, optionally waiting for at least one
+// to complete.  Returns false if waiting failed.
+bool AsyncFileReader::ReapCompletions(bool wait)
+{
+#ifdef HAVE_IO_URING
+    if (wait && *_cqHead == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE) &&
+        syscall(__NR_io_uring_enter, _ringFd, 0, 1, IORING_ENTER_GETEVENTS, 
+                NULL, 0) < 0 && errno != EINTR)
+        return false;
+    
+    unsigned head = *_cqHead;
+    while (head != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_cqe* cqe = &_cqes[head & *_cqMask];
+        Slot& slot = _slots[cqe->user_data];
+        slot.result = cqe->res;
+        
+        if (slot.state == Abandoned)
+            FreeSlot(slot);
+        else
+            slot.state = Completed;
+        
+        head++;
+    }
+    __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Make the given slot available for another read.
+void AsyncFileReader::FreeSlot(Slot& slot)
+{
+    if (slot.fd >= 0)
+        close(slot.fd);
+    
+    slot.fd = -1;
+    slot.state = Free;
+}
+
+// Get the index of the slot holding the read identified by tag, or of a free
+// slot if tag is negative.  Returns -1 if there is no such slot.
+int AsyncFileReader::FindSlot(int tag) const
+{
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        if (tag < 0 ? _slots[i].state == Free : 
+                      (_slots[i].tag == tag && 
+                       (_slots[i].state == InFlight || 
+                        _slots[i].state == Completed)))
+            return i;
+    }
+    
+    return -1;
+}
@@ -52,10 +52,12 @@ _target(target)
     _textCmdMap[CMD_SHOW_PRINT_DOWNLOAD_FAILED] = ShowPrintDownloadFailed;
     _textCmdMap[CMD_START_PRINT_DATA_LOAD] = StartPrintDataLoad;
     _textCmdMap[CMD_PROCESS_PRINT_DATA] = ProcessPrintData;
+    _textCmdMap[CMD_ADOPT_PRINT_DATA] = AdoptPrintData;
     _textCmdMap[CMD_SHOW_PRINT_DATA_LOADED] = ShowPrintDataLoaded;
     _textCmdMap[CMD_REGISTRATION_CODE] = StartRegistering;
     _textCmdMap[CMD_REGISTERED] = RegistrationSucceeded;
     _textCmdMap[CMD_APPLY_SETTINGS] = ApplySettings;
+    _textCmdMap[CMD_SET_SETTING] = SetSetting;
     _textCmdMap[CMD_SHOW_WIRELESS_CONNECTING] = ShowWiFiConnecting;
     _textCmdMap[CMD_SHOW_WIRELESS_CONNECTION_FAILED] = ShowWiFiConnectionFailed;
     _textCmdMap[CMD_SHOW_WIRELESS_CONNECTED] = ShowWiFiConnected;
@@ -87,18 +89,31 @@ void CommandInterpreter::Callback(EventType eventType, const EventData& data)
 };
 
 // Translates UI text command input into standard commands and pass them on
-// to their handler
+// to their handler, along with any argument following the command, e.g. a 
+// file path, whose case is preserved
 void CommandInterpreter::TextCommandCallback(std::string cmd)
 {      
-    // convert the command string to upper case
-    std::transform (cmd.begin(), cmd.end(), cmd.begin(), toupper);
-    // remove whitespace and anything after it
+    // split off whitespace and anything after it as the argument
+    std::string argument;
     std::string::size_type p = cmd.find_first_of(" \t\n");
     if (p != std::string::npos)
+    {
+        std::string::size_type start = cmd.find_first_not_of(" \t", p);
+        std::string::size_type end = cmd.find_last_not_of(" \t\r\n");
+        if (start != std::string::npos && end != std::string::npos && 
+            end >= start)
+            argument = cmd.substr(start, end - start + 1);
         cmd.erase(p);
+    }
+    
+    // convert the command string to upper case
+    std::transform (cmd.begin(), cmd.end(), cmd.begin(), toupper);
 
-    // map command string to a command code
-    Command command = (Command)_textCmdMap[cmd];
+    // map command string to a command code, without adding unknown ones to
+    // the map
+    std::map<std::string, int>::const_iterator it = _textCmdMap.find(cmd);
+    Command command = it == _textCmdMap.end() ? UndefinedCommand : 
+                                                (Command)it->second;
     
     if (command == UndefinedCommand)
     {
@@ -107,6 +122,6 @@ void CommandInterpreter::TextCommandCallback(std::string cmd)
     else
     {
         // if command successfully translated, handle it
-        _target->Handle(command);
+        _target->Handle(command, argument);
     }
 }
@@ -31,19 +31,21 @@
 
 DRM_FrameBuffer::DRM_FrameBuffer(const DRM_Device& drmDevice,
                                  const DRM_DumbBuffer& drmDumbBuffer,
-                                 int depth) :
+                                 uint32_t pixelFormat) :
 _drmDeviceFileDescriptor(drmDevice.GetFileDescriptor())
 {
-    if (drmModeAddFB(_drmDeviceFileDescriptor,
-                     drmDumbBuffer.GetWidth(), drmDumbBuffer.GetHeight(),
-                     depth, drmDumbBuffer.GetBitsPerPixel(),
-                     drmDumbBuffer.GetPitch(), drmDumbBuffer.GetHandle(),
-                     &_id) < 0)
+    // The dumb buffer holds a single plane of pixel data.
+    uint32_t handles[4] = { drmDumbBuffer.GetHandle(), 0, 0, 0 };
+    uint32_t pitches[4] = { drmDumbBuffer.GetPitch(), 0, 0, 0 };
+    uint32_t offsets[4] = { 0, 0, 0, 0 };
+
+    if (drmModeAddFB2(_drmDeviceFileDescriptor,
+                      drmDumbBuffer.GetWidth(), drmDumbBuffer.GetHeight(),
+                      pixelFormat, handles, pitches, offsets, &_id, 0) < 0)
     {
         throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
                                                   DrmCantCreateFrameBuffer));
     }
-
 }
 
 DRM_FrameBuffer::~DRM_FrameBuffer()
@@ -55,3 +55,15 @@ uint32_t DRM_Resources::GetConnectorId(int connectorIndex) const
     }
     return _pResources->connectors[connectorIndex];
 }
+
+// Get the position of the specified CRTC in the resources list, as used by
+// the possible_crtcs masks of encoders and planes, or -1 if not found.
+int DRM_Resources::GetCrtcIndex(uint32_t crtcId) const
+{
+    for (int i = 0; i < _pResources->count_crtcs; i++)
+    {
+        if (_pResources->crtcs[i] == crtcId)
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,112 @@
+//  File:   DRM_ScanoutBuffer.cpp
+//  Encapsulates a memory mapped DRM dumb buffer and the DRM frame buffer used
+//  to scan it out, for one video resolution.
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include "DRM_ScanoutBuffer.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <drm_fourcc.h>
+
+#include "DRM_Device.h"
+#include "DRM_Connector.h"
+#include "Logger.h"
+
+// Create the dumb buffer and its frame buffer, and map the dumb buffer into
+// memory.
+DRM_ScanoutBuffer::DRM_ScanoutBuffer(const DRM_Device& drmDevice,
+                                     const DRM_Connector& drmConnector,
+                                     int width, int height,
+                                     uint32_t pixelFormat) :
+_drmDumbBuffer(drmDevice, drmConnector, width, height,
+               GetBitsPerPixel(pixelFormat)),
+_drmFrameBuffer(drmDevice, _drmDumbBuffer, pixelFormat),
+_pixelFormat(pixelFormat)
+{
+    // Prepare buffer for memory mapping.
+    drm_mode_map_dumb mapRequest;
+    std::memset(&mapRequest, 0, sizeof(mapRequest));
+    mapRequest.handle = _drmDumbBuffer.GetHandle();
+    if (drmIoctl(drmDevice.GetFileDescriptor(), DRM_IOCTL_MODE_MAP_DUMB,
+                 &mapRequest) < 0)
+    {
+        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
+                                                  DrmCantPrepareDumbBuffer));
+    }
+
+    // Perform actual memory mapping.
+    _pMap = static_cast<uint8_t*>(mmap(0, _drmDumbBuffer.GetSize(),
+                                       PROT_READ | PROT_WRITE, MAP_SHARED,
+                                       drmDevice.GetFileDescriptor(),
+                                       mapRequest.offset));
+
+    if (_pMap == MAP_FAILED)
+    {
+        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
+                                                  DrmCantMapDumbBuffer));
+    }
+
+    // Clear the buffer.
+    std::memset(_pMap, 0, _drmDumbBuffer.GetSize());
+}
+
+DRM_ScanoutBuffer::~DRM_ScanoutBuffer()
+{
+    std::memset(_pMap, 0, _drmDumbBuffer.GetSize());
+    munmap(_pMap, _drmDumbBuffer.GetSize());
+}
+
+uint8_t* DRM_ScanoutBuffer::GetMap() const
+{
+    return _pMap;
+}
+
+uint32_t DRM_ScanoutBuffer::GetFrameBufferId() const
+{
+    return _drmFrameBuffer.GetId();
+}
+
+const DRM_DumbBuffer& DRM_ScanoutBuffer::GetDumbBuffer() const
+{
+    return _drmDumbBuffer;
+}
+
+uint32_t DRM_ScanoutBuffer::GetPixelFormat() const
+{
+    return _pixelFormat;
+}
+
+// Get the storage size of a pixel in one of the formats used for scanout.
+int DRM_ScanoutBuffer::GetBitsPerPixel(uint32_t pixelFormat)
+{
+    switch (pixelFormat)
+    {
+        case DRM_FORMAT_C8:
+            return 8;
+
+        case DRM_FORMAT_RGB565:
+            return 16;
+
+        default:
+            return 32;
+    }
+}
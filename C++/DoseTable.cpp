@@ -0,0 +1,127 @@
+//  File:   DoseTable.cpp
+//  Holds the exposure time for every layer of a print, computed once when the
+//  print starts
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <algorithm>
+#include <stdio.h>
+
+#include <DoseTable.h>
+#include <LayerSettings.h>
+#include <Settings.h>
+#include <Logger.h>
+#include <MessageStrings.h>
+
+// Compute the exposure time of each layer from the print settings and any 
+// per-layer overrides.  If ExposureRampLayers is non-zero, that many model 
+// layers following the burn-in layers blend from the exposure of the last 
+// burn-in (or first) layer to the model exposure, either linearly or 
+// exponentially, except where the per-layer settings override the model 
+// exposure.
+void DoseTable::Build(int numLayers, LayerSettings& perLayer, 
+                      Settings& settings)
+{
+    _exposureSec.clear();
+    _exposureSec.reserve(numLayers);
+    
+    int numBurnInLayers = settings.GetInt(BURN_IN_LAYERS);
+    int firstModelLayer = 2 + (numBurnInLayers > 0 ? numBurnInLayers : 0);
+    int rampLayers = settings.GetInt(EXPOSURE_RAMP_LAYERS);
+    bool exponential = settings.GetString(EXPOSURE_RAMP_SHAPE) == 
+                                                            EXPONENTIAL_RAMP;
+    double rampStartSec = 0.0;
+    
+    for (int n = 1; n <= numLayers; n++)
+    {
+        double exposureSec;
+        if (n == 1)
+            exposureSec = perLayer.GetDouble(n, FIRST_EXPOSURE);
+        else if (n < firstModelLayer)
+            exposureSec = perLayer.GetDouble(n, BURN_IN_EXPOSURE);
+        else
+        {
+            exposureSec = perLayer.GetDouble(n, MODEL_EXPOSURE);
+            
+            int k = n - firstModelLayer + 1;
+            if (k <= rampLayers && !perLayer.Overrides(n, MODEL_EXPOSURE))
+            {
+                // fraction of the way from the ramp's start to the model 
+                // exposure, never reaching either end
+                double t = k / (rampLayers + 1.0);
+                if (exponential && rampStartSec > 0.0 && exposureSec > 0.0)
+                    exposureSec = rampStartSec * 
+                                    std::pow(exposureSec / rampStartSec, t);
+                else
+                    exposureSec = rampStartSec + 
+                                    (exposureSec - rampStartSec) * t;
+            }
+        }
+        
+        if (n == firstModelLayer - 1)
+            rampStartSec = exposureSec;
+        
+        _exposureSec.push_back(exposureSec);
+    }
+    
+    if (rampLayers > 0 && numLayers >= firstModelLayer)
+    {
+        char msg[100];
+        sprintf(msg, LOG_EXPOSURE_RAMP, rampLayers, 
+                exponential ? EXPONENTIAL_RAMP : LINEAR_RAMP, rampStartSec, 
+                perLayer.GetDouble(firstModelLayer, MODEL_EXPOSURE));
+        Logger::LogMessage(LOG_INFO, msg);
+    }
+}
+
+// Get the factor by which exposures should be scaled for resin at the given 
+// temperature.  The exposure settings are for resin at the reference 
+// temperature, and warmer resin cures faster, so it needs exposures shortened
+// by the fraction given by the temperature coefficient for each degree above
+// that temperature, compounded as an exponential (Arrhenius-style) decay.
+// Exposures are never lengthened, or shortened below the minimum scale, and 
+// aren't scaled if the coefficient is zero or the temperature is unknown.
+double DoseTable::GetTemperatureScale(double temperatureC, Settings& settings)
+{
+    double coefficient = settings.GetDouble(EXPOSURE_TEMP_COEFF);
+    if (coefficient <= 0.0 || temperatureC < 0.0)
+        return 1.0;
+    
+    double scale = std::exp(-coefficient * 
+                    (temperatureC - settings.GetDouble(EXPOSURE_REF_TEMP)));
+    
+    return std::max(settings.GetDouble(MIN_EXPOSURE_SCALE), 
+                    std::min(scale, 1.0));
+}
+
+// Returns true if and only if the table holds an exposure for the given layer.
+bool DoseTable::Contains(int layer) const
+{
+    return layer >= 1 && layer <= (int) _exposureSec.size();
+}
+
+// Get the sum of the exposure times of the given layer and all the layers 
+// following it.
+double DoseTable::GetTotalExposureSec(int fromLayer) const
+{
+    double total = 0.0;
+    for (int n = std::max(fromLayer, 1); n <= (int) _exposureSec.size(); n++)
+        total += _exposureSec[n - 1];
+    return total;
+}
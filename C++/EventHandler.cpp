@@ -30,11 +30,19 @@
 #include "EventHandler.h"
 #include "ErrorMessage.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "EventRecorder.h"
+#include "EventPlayer.h"
+#include "utils.h"
 
 // Constructor, initializes epoll instance according to number of events
 EventHandler::EventHandler() :
 _epollFd(epoll_create(MaxEventTypes)),
-_exit(false)
+_exit(false),
+_dispatchDuration(Metrics::Instance().GetHistogram(DISPATCH_METRIC,
+        "Time taken to handle the events from one wait for events",
+        {0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0})),
+_pRecorder(NULL)
 {
     if (_epollFd < 0) 
         throw std::runtime_error(ErrorMessage::Format(EpollCreate, errno));
@@ -58,6 +66,12 @@ void EventHandler::AddEvent(EventType eventType, IResource* pResource)
     epoll_ctl(_epollFd, EPOLL_CTL_ADD, event.data.fd, &event);
 }
 
+// Add work done on other threads, whose completion is awaited when replaying
+void EventHandler::AddBackgroundWork(IBackgroundWork* pWork)
+{
+    _backgroundWork.push_back(pWork);
+}
+
 // Add a subscriber to a given event type
 void EventHandler::Subscribe(EventType eventType, ICallback* pObject)
 {
@@ -85,11 +99,7 @@ void EventHandler::Begin()
     bool doForever = _numIterations == 0;
 #endif    
 
-    // epoll event structure for receiving events
-    struct epoll_event events[MaxEventTypes];
-   
     bool keepGoing = true;
-    int numFDs = 0;
     
     // Start event loop, waiting for events, and calling subscribers when loop
     // receives events
@@ -104,48 +114,9 @@ void EventHandler::Begin()
         if (!doForever)
             timeout = 10;
 #endif              
-        // Do a blocking epoll_wait, there's nothing to do until it returns
-        numFDs = epoll_wait(_epollFd, events, MaxEventTypes, timeout);
+        // Do a blocking wait, there's nothing to do until it returns
+        Poll(timeout, false);
         
-        if (numFDs)
-        {
-            // numFDs file descriptors are ready for the requested IO
-
-            // Handle possible error condition
-            if (numFDs < 0 && errno != EINTR)
-            {
-                // If this keeps repeating, it should probably be a fatal error
-                Logger::LogError(LOG_WARNING, errno, NegativeNumFiles, numFDs);
-            }
-            
-            for(int n = 0; n < numFDs; n++)
-            {
-                epoll_event event = events[n];
-                
-                // Read the data associated with the event
-                IResource* resource = _resources[event.data.fd].second;
-                EventType eventType = _resources[event.data.fd].first;
-
-                // Qualify the event
-                // The event loop only cares about specific types of events - it
-                // might want to ignore some types of events picked up by epoll
-                // (EPOLLERR, etc.)
-                if (!resource->QualifyEvents(event.events))
-                    continue;
-                
-                EventDataVec eventData = resource->Read();
-                for (EventDataVec::iterator eventDataIt = eventData.begin();
-                        eventDataIt != eventData.end(); eventDataIt++)
-                {
-                    // call each subscriber with the event data
-                    SubscriptionVec subscriptions = _subscriptions[eventType];
-
-                    for (SubscriptionVec::iterator it = subscriptions.begin();
-                            it != subscriptions.end(); it++)
-                        (*it)->Callback(eventType, *eventDataIt);
-                }
-            } 
-        }      
 #ifdef DEBUG
         if (!doForever && --_numIterations < 0)
             keepGoing = false;
@@ -153,6 +124,122 @@ void EventHandler::Begin()
     }
 }
 
+// Replay recorded events in order, as fast as they can be handled, with the
+// clock seen by their subscribers set to the time at which each was
+// originally dispatched.  Events of types that aren't recorded, such as 
+// printer status updates, arise again from handling the recorded ones and are
+// dispatched from their resources as usual, while resources for the recorded
+// types are ignored.  Work started on other threads, such as loading print 
+// data, is finished and its events dispatched before the next recorded event, 
+// since the recording doesn't say when it finished.
+void EventHandler::Replay(EventPlayer& player)
+{
+    _exit = false;
+    
+    double startTime = GetSeconds();
+    RecordedEvent event;
+    
+    while (!_exit && player.Next(event))
+    {
+        AwaitBackgroundWork();
+        SetVirtualSeconds(startTime + event.time);
+        Dispatch(event.type, event.data);
+        Poll(0, true);
+    }
+    
+    AwaitBackgroundWork();
+    SetVirtualSeconds(-1.0);
+}
+
+// Wait for all background work to finish and dispatch the events it raises,
+// until handling those starts no more.
+void EventHandler::AwaitBackgroundWork()
+{
+    bool waited = true;
+    while (waited && !_exit)
+    {
+        waited = false;
+        for (std::vector<IBackgroundWork*>::iterator it = 
+                _backgroundWork.begin(); it != _backgroundWork.end(); it++)
+            if ((*it)->AwaitCompletion())
+                waited = true;
+        
+        if (waited)
+            Poll(0, true);
+    }
+}
+
+// Wait up to the given timeout (in ms, or indefinitely if negative) for 
+// activity on the resources, and dispatch the events arising from them. 
+void EventHandler::Poll(int timeout, bool replaying)
+{
+    // epoll event structure for receiving events
+    struct epoll_event events[MaxEventTypes];
+
+    int numFDs = epoll_wait(_epollFd, events, MaxEventTypes, timeout);
+
+    if (numFDs)
+    {
+        // numFDs file descriptors are ready for the requested IO
+        double dispatchStart = GetSeconds();
+
+        // Handle possible error condition
+        if (numFDs < 0 && errno != EINTR)
+        {
+            // If this keeps repeating, it should probably be a fatal error
+            Logger::LogError(LOG_WARNING, errno, NegativeNumFiles, numFDs);
+        }
+
+        for(int n = 0; n < numFDs; n++)
+        {
+            epoll_event event = events[n];
+
+            // Read the data associated with the event
+            IResource* resource = _resources[event.data.fd].second;
+            EventType eventType = _resources[event.data.fd].first;
+
+            // Qualify the event
+            // The event loop only cares about specific types of events - it
+            // might want to ignore some types of events picked up by epoll
+            // (EPOLLERR, etc.)
+            if (!resource->QualifyEvents(event.events))
+                continue;
+            
+            bool recorded = EventRecorder::IsRecorded(eventType);
+            
+            // when replaying, events of the recorded types only come from 
+            // the recording
+            if (replaying && recorded)
+                continue;
+
+            EventDataVec eventData = resource->Read();
+            for (EventDataVec::iterator eventDataIt = eventData.begin();
+                    eventDataIt != eventData.end(); eventDataIt++)
+            {
+                if (_pRecorder && recorded)
+                    _pRecorder->Record(eventType, *eventDataIt);
+                
+                Dispatch(eventType, *eventDataIt);
+            }
+        } 
+
+        // the clock doesn't advance while replaying, so there's no duration
+        // to observe
+        if (!replaying)
+            _dispatchDuration.Observe(GetSeconds() - dispatchStart);
+    }      
+}
+
+// Call each subscriber to the given type of event with its data
+void EventHandler::Dispatch(EventType eventType, const EventData& data)
+{
+    SubscriptionVec subscriptions = _subscriptions[eventType];
+
+    for (SubscriptionVec::iterator it = subscriptions.begin();
+            it != subscriptions.end(); it++)
+        (*it)->Callback(eventType, data);
+}
+
 void EventHandler::Handle(Command command)
 {
     // PrintEngine handles all other commands
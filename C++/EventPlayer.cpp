@@ -0,0 +1,146 @@
+//  File:   EventPlayer.cpp
+//  Reads recorded events back for replay
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include <stdexcept>
+
+#include "EventPlayer.h"
+#include "EventRecorder.h"
+#include "ErrorMessage.h"
+
+namespace
+{
+// Get the value held by the bytes at the given offset into a payload.
+template<typename T>
+T Value(const std::string& payload, size_t offset = 0)
+{
+    T value;
+    std::memcpy(&value, payload.data() + offset, sizeof(T));
+    return value;
+}
+}
+
+// Constructor, opens the recording and checks that it has the expected format
+EventPlayer::EventPlayer(const std::string& path) :
+_file(path.c_str(), std::ios::binary),
+_path(path)
+{
+    if (!_file.is_open())
+        throw std::runtime_error(ErrorMessage::Format(CantOpenEventRecording, 
+                                                      path.c_str()));
+    
+    char magic[EVENT_RECORDING_MAGIC_LEN];
+    if (!_file.read(magic, EVENT_RECORDING_MAGIC_LEN) ||
+        std::memcmp(magic, EVENT_RECORDING_MAGIC, EVENT_RECORDING_MAGIC_LEN))
+        throw std::runtime_error(ErrorMessage::Format(InvalidEventRecording, 
+                                                      path.c_str()));
+}
+
+EventPlayer::~EventPlayer()
+{
+}
+
+// Read the next recorded event.  Returns false at the end of the recording,
+// or throws if the recording ends within an event or holds an unknown type.
+bool EventPlayer::Next(RecordedEvent& event)
+{
+    uint8_t type;
+    if (!_file.read(reinterpret_cast<char*>(&type), sizeof(type)))
+        return false;
+    
+    double time;
+    uint16_t size;
+    _file.read(reinterpret_cast<char*>(&time), sizeof(time));
+    _file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::string payload(_file ? size : 0, '\0');
+    _file.read(&payload[0], payload.size());
+    
+    if (!_file || 
+        !EventRecorder::IsRecorded(static_cast<EventType>(type)))
+        throw std::runtime_error(ErrorMessage::Format(InvalidEventRecording, 
+                                                      _path.c_str()));
+   
+    event.type = static_cast<EventType>(type);
+    event.time = time;
+    event.data = Decode(event.type, payload);
+    return true;
+}
+
+// Reconstruct the payload of a recorded event, with the type its subscribers
+// expect for that type of event, as written by EventRecorder::Encode.
+EventData EventPlayer::Decode(EventType eventType, 
+                              const std::string& payload) const
+{
+    size_t expectedSize = payload.size();
+    
+    switch (eventType)
+    {
+        case MotorInterrupt:
+        case ButtonInterrupt:
+        case MotorTimeout:
+            expectedSize = sizeof(unsigned char);
+            break;
+            
+        case DoorInterrupt:
+        case RotationInterrupt:
+            expectedSize = sizeof(char);
+            break;
+            
+        case DelayEnd:
+        case ExposureEnd:
+        case TemperatureTimer:
+            expectedSize = sizeof(uint64_t);
+            break;
+            
+        case Signal:
+            expectedSize = sizeof(uint32_t);
+            break;
+            
+        default:
+            break;
+    }
+    
+    if (payload.size() != expectedSize)
+        throw std::runtime_error(ErrorMessage::Format(InvalidEventRecording, 
+                                                      _path.c_str()));
+
+    switch (eventType)
+    {
+        case MotorInterrupt:
+        case ButtonInterrupt:
+        case MotorTimeout:
+            return EventData(Value<unsigned char>(payload));
+            
+        case DoorInterrupt:
+        case RotationInterrupt:
+            return EventData(Value<char>(payload));
+            
+        case DelayEnd:
+        case ExposureEnd:
+        case TemperatureTimer:
+            return EventData(Value<uint64_t>(payload));
+            
+        case Signal:
+            return EventData(Value<uint32_t>(payload));
+            
+        default:
+            return EventData(payload);
+    }
+}
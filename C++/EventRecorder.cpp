@@ -0,0 +1,117 @@
+//  File:   EventRecorder.cpp
+//  Records dispatched events for deterministic replay
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdexcept>
+
+#include "EventRecorder.h"
+#include "ErrorMessage.h"
+#include "utils.h"
+
+namespace
+{
+// Get the bytes holding the given value.
+template<typename T>
+std::string Bytes(T value)
+{
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}
+
+// Constructor, creates the recording file, replacing any existing one
+EventRecorder::EventRecorder(const std::string& path) :
+_file(path.c_str(), std::ios::binary | std::ios::trunc),
+_startTime(GetSeconds())
+{
+    if (!_file.is_open())
+        throw std::runtime_error(ErrorMessage::Format(CantOpenEventRecording, 
+                                                      path.c_str()));
+    
+    _file.write(EVENT_RECORDING_MAGIC, EVENT_RECORDING_MAGIC_LEN);
+}
+
+EventRecorder::~EventRecorder()
+{
+}
+
+// Append a record of the given event to the file.  Each record is flushed 
+// immediately, so that a recording of a printer that was power cycled or
+// stopped by SIGKILL still holds the events leading up to that point.
+void EventRecorder::Record(EventType eventType, const EventData& data)
+{
+    std::string payload = Encode(eventType, data);
+    
+    _file << Bytes(static_cast<uint8_t>(eventType)) 
+          << Bytes(GetSeconds() - _startTime)
+          << Bytes(static_cast<uint16_t>(payload.size())) << payload;
+    _file.flush();
+}
+
+// Events that arise from the handling of other events, rather than from 
+// outside the print engine, aren't recorded, since handling the recorded 
+// events will cause them to arise again when they're replayed.  Print data
+// load progress comes from the loader thread started by a recorded command, 
+// and that thread is only joined once it reports that it has finished.
+bool EventRecorder::IsRecorded(EventType eventType)
+{
+    switch (eventType)
+    {
+        case Undefined:
+        case PrinterStatusUpdate:
+        case MetricsRequest:
+        case PrintDataLoad:
+        case MaxEventTypes:
+            return false;
+            
+        default:
+            return true;
+    }
+}
+
+// Get the bytes representing the payload of a recorded event, which depends
+// on the type of the resource from which it was read.
+std::string EventRecorder::Encode(EventType eventType, const EventData& data)
+{
+    switch (eventType)
+    {
+        // read from I2C registers
+        case MotorInterrupt:
+        case ButtonInterrupt:
+        case MotorTimeout:
+            return Bytes(data.Get<unsigned char>());
+            
+        // read from GPIO value files
+        case DoorInterrupt:
+        case RotationInterrupt:
+            return Bytes(data.Get<char>());
+            
+        // expiration counts read from timers
+        case DelayEnd:
+        case ExposureEnd:
+        case TemperatureTimer:
+            return Bytes(data.Get<uint64_t>());
+            
+        case Signal:
+            return Bytes(data.Get<uint32_t>());
+            
+        // commands, keyboard input, and device nodes
+        default:
+            return data.Get<std::string>();
+    }
+}
@@ -26,25 +26,24 @@
 #include "FrameBuffer.h"
 
 #include <Magick++.h>
+#include <drm_fourcc.h>
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <stdexcept>
-#include <sys/mman.h>
 
 #include "Logger.h"
 #include "Filenames.h"
+#include "PixelConversion.h"
 
-FrameBuffer::FrameBuffer(int width, int height) :
+FrameBuffer::FrameBuffer(int width, int height, bool allowRGB565) :
 _drmDevice(DRM_DEVICE_NODE),
 _drmResources(_drmDevice),
 _drmConnector(_drmDevice, _drmResources.GetConnectorId(0)),
 _drmEncoder(_drmDevice, _drmConnector),
-_drmDumbBuffer(_drmDevice, _drmConnector, width, height, 32),
-_drmFrameBuffer(_drmDevice, _drmDumbBuffer, 24),
-_image(width * height)
+_pixelFormat(DRM_FORMAT_XRGB8888),
+_pScanoutBuffer(NULL)
 {
-    std::cout << "Selecting " << _drmDumbBuffer.GetWidth() << " x " <<
-            _drmDumbBuffer.GetHeight() << " as video resolution" << std::endl;
-    
     // Check for a connected display.
     if (!_drmConnector.IsConnected())
     {
@@ -52,56 +51,169 @@ _image(width * height)
                                                   DrmConnectorNotConnected));
     }
  
-    // Perform mode setting.
-    uint32_t connectorId = _drmConnector.GetId();
-    drmModeModeInfo modeInfo = _drmDumbBuffer.GetModeInfo();
-    if (drmModeSetCrtc(_drmDevice.GetFileDescriptor(), _drmEncoder.GetCrtcId(),
-                       _drmFrameBuffer.GetId(), 0, 0, &connectorId, 1,
-                       &modeInfo) < 0)
+    _pixelFormat = SelectPixelFormat(allowRGB565);
+    SetResolution(width, height);
+}
+
+FrameBuffer::~FrameBuffer()
+{
+    // the scanout buffers clear and unmap themselves when destroyed
+}
+
+// Choose the most compact pixel format that the CRTC's primary plane can scan
+// out without losing any of the 8 bits per pixel that slice images carry.  The
+// 8-bit indexed format is only used if its palette can be loaded, otherwise 
+// fall back to XRGB8888, which all drivers support.  RGB565 keeps only 5 or 6
+// bits of each grey level, coarsening exposure levels and anti-aliased edges,
+// so it's only used if allowRGB565 is true.
+uint32_t FrameBuffer::SelectPixelFormat(bool allowRGB565)
+{
+    int fd = _drmDevice.GetFileDescriptor();
+    int crtcIndex = _drmResources.GetCrtcIndex(_drmEncoder.GetCrtcId());
+    std::set<uint32_t> formats;
+
+    // primary planes are only listed for clients that ask for them
+    if (crtcIndex >= 0 &&
+        drmSetClientCap(fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) == 0)
     {
-        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
-                                                  DrmCantSetCrtc));
+        drmModePlaneResPtr pPlaneResources = drmModeGetPlaneResources(fd);
+        if (pPlaneResources)
+        {
+            for (uint32_t i = 0; i < pPlaneResources->count_planes; i++)
+            {
+                drmModePlanePtr pPlane = drmModeGetPlane(fd, 
+                                                pPlaneResources->planes[i]);
+                if (!pPlane)
+                    continue;
+                
+                if ((pPlane->possible_crtcs & (1 << crtcIndex)) &&
+                    IsPrimaryPlane(pPlane->plane_id))
+                {
+                    formats.insert(pPlane->formats,
+                                   pPlane->formats + pPlane->count_formats);
+                }
+                drmModeFreePlane(pPlane);
+            }
+            drmModeFreePlaneResources(pPlaneResources);
+        }
+    }
+
+    if (formats.count(DRM_FORMAT_C8) && LoadGreyPalette())
+    {
+        std::cout << "Using 8-bit indexed scanout" << std::endl;
+        return DRM_FORMAT_C8;
     }
     
-    // Prepare buffer for memory mapping.
-    drm_mode_map_dumb mapRequest;
-    std::memset(&mapRequest, 0, sizeof(mapRequest));
-    mapRequest.handle = _drmDumbBuffer.GetHandle();
-    if (drmIoctl(_drmDevice.GetFileDescriptor(), DRM_IOCTL_MODE_MAP_DUMB,
-                 &mapRequest) < 0)
+    if (allowRGB565 && formats.count(DRM_FORMAT_RGB565))
     {
-        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
-                                                  DrmCantPrepareDumbBuffer));
+        std::cout << "Using RGB565 scanout, with reduced grey level precision" 
+                  << std::endl;
+        return DRM_FORMAT_RGB565;
     }
+    
+    return DRM_FORMAT_XRGB8888;
+}
 
-    // Perform actual memory mapping.
-    _pFrameBufferMap = static_cast<uint8_t*>(mmap(0, _drmDumbBuffer.GetSize(),
-                                             PROT_READ | PROT_WRITE, MAP_SHARED,
-                                             _drmDevice.GetFileDescriptor(),
-                                             mapRequest.offset));
-
-    if (_pFrameBufferMap == MAP_FAILED)
+// Returns true if the specified plane's type property says it's a primary 
+// plane.
+bool FrameBuffer::IsPrimaryPlane(uint32_t planeId)
+{
+    int fd = _drmDevice.GetFileDescriptor();
+    bool isPrimary = false;
+    
+    drmModeObjectPropertiesPtr pProperties = 
+            drmModeObjectGetProperties(fd, planeId, DRM_MODE_OBJECT_PLANE);
+    if (!pProperties)
+        return false;
+    
+    for (uint32_t i = 0; i < pProperties->count_props; i++)
     {
-        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
-                                                  DrmCantMapDumbBuffer));
+        drmModePropertyPtr pProperty = drmModeGetProperty(fd, 
+                                                    pProperties->props[i]);
+        if (!pProperty)
+            continue;
+        
+        if (strcmp(pProperty->name, "type") == 0)
+            isPrimary = pProperties->prop_values[i] == DRM_PLANE_TYPE_PRIMARY;
+        
+        drmModeFreeProperty(pProperty);
     }
+    drmModeFreeObjectProperties(pProperties);
+    
+    return isPrimary;
+}
 
-    // Clear the frame buffer.
-    std::memset(_pFrameBufferMap, 0, _drmDumbBuffer.GetSize());
+// Load a grey ramp as the palette for 8-bit indexed scanout, so each index 
+// displays the same level as its value did in XRGB8888.  The palette is held 
+// in the CRTC's gamma table, which must have one entry per index.
+bool FrameBuffer::LoadGreyPalette()
+{
+    int fd = _drmDevice.GetFileDescriptor();
+    uint32_t crtcId = _drmEncoder.GetCrtcId();
+    
+    drmModeCrtcPtr pCrtc = drmModeGetCrtc(fd, crtcId);
+    if (!pCrtc)
+        return false;
+    
+    int gammaSize = pCrtc->gamma_size;
+    drmModeFreeCrtc(pCrtc);
+    if (gammaSize != 256)
+        return false;
+
+    std::vector<uint16_t> grey(gammaSize);
+    for (int i = 0; i < gammaSize; i++)
+        grey[i] = i * 0x101;  // scale 8-bit level to 16 bits
     
+    return drmModeCrtcSetGamma(fd, crtcId, gammaSize, grey.data(), 
+                               grey.data(), grey.data()) == 0;
 }
 
-FrameBuffer::~FrameBuffer()
+// Select the video resolution, creating a scanout buffer for it the first time
+// it's used and keeping it for reuse, so that switching back and forth between
+// resolutions only requires setting the CRTC mode.
+void FrameBuffer::SetResolution(int width, int height)
 {
-    std::memset(_pFrameBufferMap, 0, _drmDumbBuffer.GetSize());
-    munmap(_pFrameBufferMap, _drmDumbBuffer.GetSize());
+    Resolution resolution(width, height);
+    ScanoutBufferMap::iterator it = _scanoutBuffers.find(resolution);
+    
+    if (it == _scanoutBuffers.end())
+    {
+        it = _scanoutBuffers.insert(std::make_pair(resolution,
+                std::unique_ptr<DRM_ScanoutBuffer>(new DRM_ScanoutBuffer(
+                    _drmDevice, _drmConnector, width, height, 
+                    _pixelFormat)))).first;
+    }
+    
+    DRM_ScanoutBuffer* pScanoutBuffer = it->second.get();
+    const DRM_DumbBuffer& dumbBuffer = pScanoutBuffer->GetDumbBuffer();
+
+    std::cout << "Selecting " << dumbBuffer.GetWidth() << " x " <<
+            dumbBuffer.GetHeight() << " as video resolution" << std::endl;
+    
+    // Don't show whatever was last displayed at this resolution.
+    std::memset(pScanoutBuffer->GetMap(), 0, dumbBuffer.GetSize());
+ 
+    // Perform mode setting.
+    uint32_t connectorId = _drmConnector.GetId();
+    drmModeModeInfo modeInfo = dumbBuffer.GetModeInfo();
+    if (drmModeSetCrtc(_drmDevice.GetFileDescriptor(), _drmEncoder.GetCrtcId(),
+                       pScanoutBuffer->GetFrameBufferId(), 0, 0, &connectorId,
+                       1, &modeInfo) < 0)
+    {
+        throw std::runtime_error(Logger::LogError(LOG_ERR, errno,
+                                                  DrmCantSetCrtc));
+    }
+    
+    _pScanoutBuffer = pScanoutBuffer;
+    _image.resize(width * height);
 }
 
 // Copies the green channel from the specified image into an auxiliary buffer
 // but does not display the result.
 void FrameBuffer::Blit(Magick::Image& image)
 {
-    image.write(0, 0, _drmDumbBuffer.GetWidth(), _drmDumbBuffer.GetHeight(),
+    const DRM_DumbBuffer& dumbBuffer = _pScanoutBuffer->GetDumbBuffer();
+    image.write(0, 0, dumbBuffer.GetWidth(), dumbBuffer.GetHeight(),
                 "G", Magick::CharPixel, _image.data());
 }
 
@@ -109,25 +221,52 @@ void FrameBuffer::Blit(Magick::Image& image)
 // result immediately.
 void FrameBuffer::Fill(uint8_t value)
 {
-    std::memset(_pFrameBufferMap, value, _drmDumbBuffer.GetSize());
+    uint8_t* pFrameBufferMap = _pScanoutBuffer->GetMap();
+    uint64_t size = _pScanoutBuffer->GetDumbBuffer().GetSize();
+    
+    if (_pixelFormat == DRM_FORMAT_RGB565)
+    {
+        uint16_t* pPixels = reinterpret_cast<uint16_t*>(pFrameBufferMap);
+        std::fill(pPixels, pPixels + size / 2, GreyToRGB565(value));
+    }
+    else
+    {
+        // every byte of a grey XRGB8888 pixel has the same value
+        std::memset(pFrameBufferMap, value, size);
+    }
 }
 
 // Displays the contents of the auxiliary buffer immediately.
 void FrameBuffer::Swap()
 {
-    int pitch = _drmDumbBuffer.GetPitch();
-    int width = _drmDumbBuffer.GetWidth();
-    int height = _drmDumbBuffer.GetHeight();
+    const DRM_DumbBuffer& dumbBuffer = _pScanoutBuffer->GetDumbBuffer();
+    uint8_t* pFrameBufferMap = _pScanoutBuffer->GetMap();
+    int pitch = dumbBuffer.GetPitch();
+    int width = dumbBuffer.GetWidth();
+    int height = dumbBuffer.GetHeight();
     
-    for (int y = 0; y < height; y++)
+    switch (_pixelFormat)
     {
-        for (int x = 0; x < width; x++)
-        {
-            uint8_t value = _image[width * y + x];
-            *(uint32_t*)&_pFrameBufferMap[pitch * y + x * 4] =
-                    (value << 16) | // red
-                    (value << 8)  | // green
-                     value;         // blue
-        }
+        case DRM_FORMAT_C8:
+            // the palette maps each value to its grey level, so rows can be
+            // copied as is
+            for (int y = 0; y < height; y++)
+                std::memcpy(&pFrameBufferMap[pitch * y], &_image[width * y],
+                            width);
+            break;
+
+        case DRM_FORMAT_RGB565:
+            for (int y = 0; y < height; y++)
+                GreyRowToRGB565(&_image[width * y], 
+                        reinterpret_cast<uint16_t*>(&pFrameBufferMap[pitch * y]),
+                        width);
+            break;
+            
+        default:
+            for (int y = 0; y < height; y++)
+                GreyRowToXRGB8888(&_image[width * y], 
+                        reinterpret_cast<uint32_t*>(&pFrameBufferMap[pitch * y]),
+                        width);
+            break;
     }
-}
\ No newline at end of file
+}
@@ -59,5 +59,6 @@ ResourcePtr HardwareFactory::CreateFrontPanelInterruptResource()
 
 FrameBufferPtr HardwareFactory::CreateFrameBuffer(int width, int height)
 {
-    return FrameBufferPtr(new FrameBuffer(width, height));
+    return FrameBufferPtr(new FrameBuffer(width, height,
+            PrinterSettings::Instance().GetInt(ALLOW_RGB565_SCANOUT) != 0));
 }
\ No newline at end of file
@@ -33,9 +33,12 @@
 #include "ErrorMessage.h"
 #include "Logger.h"
 #include "Hardware.h"
+#include "Metrics.h"
 
 // Public constructor, opens I2C connection and sets slave address
-I2C_Device::I2C_Device(unsigned char slaveAddress, int port)
+I2C_Device::I2C_Device(unsigned char slaveAddress, int port) :
+_notReadyRetries(Metrics::Instance().GetCounter(I2C_RETRIES_METRIC,
+        "Number of reads retried because an I2C device was not ready"))
 {
     // open the I2C port
     std::ostringstream i2cFileNameStream;
@@ -172,7 +175,10 @@ unsigned char I2C_Device::ReadWhenReady(unsigned char registerAddress,
         else if(buffer[0] == readyStatus)
             return buffer[1];
         else // wait a bit before next try
+        {
+            _notReadyRetries.Increment();
             usleep(DELAY_5_Ms);
+        }
             
     }
     // all attempts failed to find the device ready
@@ -206,6 +212,8 @@ bool I2C_Device::ReadWhenReady(unsigned char registerAddress,
             memcpy(data, &buffer[1], length);
             return true;
         }
+        else
+            _notReadyRetries.Increment();
     }
     // all attempts failed to find the device ready
     Logger::LogError(LOG_ERR, errno, I2cDeviceNotReady);
@@ -112,4 +112,25 @@ Magick::Image* ImageProcessor::MapForPatternMode(Image& imageIn)
     }
     _pPatternModeView->sync();
     return &_patternModeImage;
-}
\ No newline at end of file
+}
+
+// Returns the fraction of the given image's pixels that will be lit when it's 
+// projected, i.e. those with a non-zero green value.
+double ImageProcessor::GetLitFraction(Image& image)
+{
+    long numPixels = image.columns() * image.rows();
+    if (numPixels == 0)
+        return 0.0;
+    
+    Pixels view(image);
+    const PixelPacket* pixels = view.getConst(0, 0, image.columns(), 
+                                                    image.rows());
+    long numLit = 0;
+    for (long i = 0; i < numPixels; i++)
+    {
+        if (pixels[i].green != 0)
+            numLit++;
+    }
+    
+    return numLit / (double) numPixels;
+}
@@ -0,0 +1,92 @@
+//  File:   LayerArena.cpp
+//  Resettable monotonic arena for short-lived allocations made while printing
+//  each layer
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <new>
+
+#include <LayerArena.h>
+
+// Constructor, claiming the arena for the calling thread
+LayerArena::LayerArena() :
+_offset(0),
+_outstanding(0),
+_peak(0),
+_owner(pthread_self()),
+_peakGauge(Metrics::Instance().GetGauge(LAYER_ARENA_PEAK_METRIC,
+        "Most memory used from the layer arena during the last layer")),
+_overflows(Metrics::Instance().GetCounter(LAYER_ARENA_OVERFLOWS_METRIC,
+        "Allocations that didn't fit in the layer arena"))
+{
+}
+
+// Gets the singleton instance, created by the first caller
+LayerArena& LayerArena::Instance()
+{
+    static LayerArena arena;
+    return arena;
+}
+
+// Hand out the specified number of bytes from the buffer, or from the heap if
+// they don't fit or the caller isn't the arena's owner.
+void* LayerArena::Allocate(size_t bytes, size_t alignment)
+{
+    if (pthread_equal(pthread_self(), _owner))
+    {
+        size_t start = (_offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= LAYER_ARENA_SIZE)
+        {
+            _offset = start + bytes;
+            if (_offset > _peak)
+                _peak = _offset;
+            _outstanding++;
+            return _buffer + start;
+        }
+        
+        _overflows.Increment();
+    }
+    
+    return ::operator new(bytes);
+}
+
+// Release memory handed out by Allocate.  Memory from the buffer isn't reused
+// until everything handed out from it has been released.
+void LayerArena::Deallocate(void* p)
+{
+    char* pChar = static_cast<char*>(p);
+    if (pChar >= _buffer && pChar < _buffer + LAYER_ARENA_SIZE)
+    {
+        if (--_outstanding == 0)
+            _offset = 0;
+    }
+    else
+        ::operator delete(p);
+}
+
+// Mark the start of a new layer, reporting the most memory used from the 
+// buffer during the previous one.  Anything still outstanding keeps its 
+// memory, so the buffer is only rewound if nothing is.
+void LayerArena::Reset()
+{
+    _peakGauge.Set(_peak);
+    _peak = _offset;
+    
+    if (_outstanding == 0)
+        _offset = 0;
+}
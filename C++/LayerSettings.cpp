@@ -192,4 +192,11 @@ double LayerSettings::GetDouble(int layer, std::string name)
         return value;
     else
         return PrinterSettings::Instance().GetDouble(name);  
-}
\ No newline at end of file
+}
+
+// Returns true if and only if the given setting is overridden for the given 
+// layer.
+bool LayerSettings::Overrides(int layer, std::string name)
+{
+    return !std::isnan(GetRawValue(layer, name));
+}
@@ -0,0 +1,354 @@
+//  File:   MeshSlicer.cpp
+//  Slices a triangle mesh into filled cross sections
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <MeshSlicer.h>
+#include <Logger.h>
+
+// size of a binary STL header and of each triangle record within the file
+#define STL_HEADER_SIZE     (80)
+#define STL_TRIANGLE_SIZE   (50)
+
+// order triangles by their lowest vertex
+static bool LowerTriangle(const MeshTriangle& a, const MeshTriangle& b)
+{
+    return a.minZ < b.minZ;
+}
+
+// Constructor
+MeshSlicer::MeshSlicer() :
+_nextTriangle(0),
+_lastZ(-std::numeric_limits<double>::max()),
+_minZ(0.0),
+_maxZ(0.0),
+_centerX(0.0),
+_centerY(0.0),
+_width(0.0),
+_depth(0.0)
+{
+}
+
+// Load the triangles from the specified binary STL file, replacing any 
+// previously loaded mesh.  Coordinates are in millimeters.
+bool MeshSlicer::LoadBinarySTL(const std::string& filePath)
+{
+    _triangles.clear();
+    _activeTriangles.clear();
+    _nextTriangle = 0;
+    _lastZ = -std::numeric_limits<double>::max();
+    
+    std::ifstream file(filePath.c_str(), std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    
+    uint32_t count = 0;
+    if (data.size() >= STL_HEADER_SIZE + sizeof(count))
+        std::memcpy(&count, &data[STL_HEADER_SIZE], sizeof(count));
+
+    // the file must hold exactly the number of triangles given in its header
+    // (which also rejects ASCII STL files), checked by division since a 
+    // crafted count could overflow the size of the records on a 32-bit target
+    size_t recordsSize = data.size() >= STL_HEADER_SIZE + sizeof(count) ?
+                         data.size() - STL_HEADER_SIZE - sizeof(count) : 0;
+    if (count == 0 || recordsSize % STL_TRIANGLE_SIZE != 0 ||
+        recordsSize / STL_TRIANGLE_SIZE != count)
+    {
+        Logger::LogError(LOG_ERR, errno, CantLoadMesh, filePath.c_str());
+        return false;
+    }
+    
+    _triangles.resize(count);
+    float minX = std::numeric_limits<float>::max();
+    float minY = minX;
+    float minZ = minX;
+    float maxX = -minX;
+    float maxY = -minX;
+    float maxZ = -minX;
+    
+    const char* pRecord = &data[STL_HEADER_SIZE + sizeof(count)];
+    for (uint32_t i = 0; i < count; i++, pRecord += STL_TRIANGLE_SIZE)
+    {
+        MeshTriangle& triangle = _triangles[i];
+        
+        // skip the facet normal, it's recalculated from the vertex order 
+        // since not all exporters fill it in
+        std::memcpy(triangle.v, pRecord + 3 * sizeof(float), 
+                    sizeof(triangle.v));
+        
+        triangle.minZ = std::min(triangle.v[0].z, 
+                                 std::min(triangle.v[1].z, triangle.v[2].z));
+        triangle.maxZ = std::max(triangle.v[0].z, 
+                                 std::max(triangle.v[1].z, triangle.v[2].z));
+        
+        for (int j = 0; j < 3; j++)
+        {
+            minX = std::min(minX, triangle.v[j].x);
+            maxX = std::max(maxX, triangle.v[j].x);
+            minY = std::min(minY, triangle.v[j].y);
+            maxY = std::max(maxY, triangle.v[j].y);
+        }
+        minZ = std::min(minZ, triangle.minZ);
+        maxZ = std::max(maxZ, triangle.maxZ);
+    }
+    
+    std::sort(_triangles.begin(), _triangles.end(), LowerTriangle);
+    
+    // the mesh is centered on the build area and sits on the build plate
+    _minZ = minZ;
+    _maxZ = maxZ;
+    _centerX = (minX + maxX) / 2.0;
+    _centerY = (minY + maxY) / 2.0;
+    _width = maxX - minX;
+    _depth = maxY - minY;
+
+    return true;
+}
+
+// Returns true if no mesh has been loaded.
+bool MeshSlicer::IsEmpty() const
+{
+    return _triangles.empty();
+}
+
+// Get the height of the mesh, in millimeters.
+double MeshSlicer::GetHeight() const
+{
+    return _maxZ - _minZ;
+}
+
+// Get the extent of the mesh along the x axis, in millimeters.
+double MeshSlicer::GetWidth() const
+{
+    return _width;
+}
+
+// Get the extent of the mesh along the y axis, in millimeters.
+double MeshSlicer::GetDepth() const
+{
+    return _depth;
+}
+
+// Fill pixels with the cross section of the mesh at z millimeters above its 
+// lowest point, rendered as white on black into an image of the given size 
+// with square pixels of pixelSize millimeters.
+void MeshSlicer::Slice(double z, int width, int height, double pixelSize,
+                       std::vector<uint8_t>& pixels)
+{
+    z += _minZ;
+    UpdateActiveTriangles(z);
+    
+    std::vector<Segment> segments;
+    Intersect(z, segments);
+    
+    pixels.assign(width * height, 0x00);
+    Fill(segments, width, height, pixelSize, pixels);
+}
+
+// Bring the set of triangles that may cross the plane at height z up to date,
+// adding those whose lowest vertex is now below the plane and dropping those
+// that lie entirely below it.
+void MeshSlicer::UpdateActiveTriangles(double z)
+{
+    // start the sweep over if slicing lower than last time
+    if (z < _lastZ)
+    {
+        _activeTriangles.clear();
+        _nextTriangle = 0;
+    }
+    _lastZ = z;
+    
+    while (_nextTriangle < _triangles.size() && 
+           _triangles[_nextTriangle].minZ <= z)
+    {
+        _activeTriangles.push_back(_nextTriangle++);
+    }
+    
+    size_t kept = 0;
+    for (size_t i = 0; i < _activeTriangles.size(); i++)
+    {
+        if (_triangles[_activeTriangles[i]].maxZ >= z)
+            _activeTriangles[kept++] = _activeTriangles[i];
+    }
+    _activeTriangles.resize(kept);
+}
+
+// Find the segments where the active triangles cross the plane at height z.
+void MeshSlicer::Intersect(double z, std::vector<Segment>& segments) const
+{
+    for (size_t i = 0; i < _activeTriangles.size(); i++)
+    {
+        const MeshVertex* v = _triangles[_activeTriangles[i]].v;
+        
+        // vertices on the plane count as above it, so that a plane through a 
+        // vertex or edge still yields each crossing exactly once
+        bool above[3] = { v[0].z >= z, v[1].z >= z, v[2].z >= z };
+        if (above[0] == above[1] && above[1] == above[2])
+            continue;
+        
+        // interpolate along the two edges whose ends are on opposite sides
+        double points[2][2];
+        int found = 0;
+        for (int j = 0; j < 3; j++)
+        {
+            const MeshVertex& a = v[j];
+            const MeshVertex& b = v[(j + 1) % 3];
+            if (above[j] != above[(j + 1) % 3])
+            {
+                double t = (z - a.z) / (b.z - a.z);
+                points[found][0] = a.x + t * (b.x - a.x);
+                points[found][1] = a.y + t * (b.y - a.y);
+                found++;
+            }
+        }
+        
+        Segment segment = { points[0][0], points[0][1], 
+                            points[1][0], points[1][1] };
+        
+        // the outward normal, from the vertex order, must point to the right
+        // of the segment for the solid to lie on its left
+        double ux = v[1].x - v[0].x, uy = v[1].y - v[0].y, uz = v[1].z - v[0].z;
+        double wx = v[2].x - v[0].x, wy = v[2].y - v[0].y, wz = v[2].z - v[0].z;
+        double nx = uy * wz - uz * wy;
+        double ny = uz * wx - ux * wz;
+        double dx = segment.x1 - segment.x0;
+        double dy = segment.y1 - segment.y0;
+        if (dy * nx - dx * ny < 0.0)
+        {
+            std::swap(segment.x0, segment.x1);
+            std::swap(segment.y0, segment.y1);
+        }
+        
+        segments.push_back(segment);
+    }
+}
+
+// order edges by the first row they cross
+static bool EdgeStartsFirst(const std::pair<int, size_t>& a, 
+                            const std::pair<int, size_t>& b)
+{
+    return a.first < b.first;
+}
+
+// Fill the pixels whose centers lie inside the cross section bounded by the 
+// given segments, using the non-zero winding rule so that overlapping bodies
+// are filled rather than cancelling each other out.  Edges are sorted by the
+// first row they cross and swept down the image, so each row only considers 
+// the edges that cross it.
+void MeshSlicer::Fill(const std::vector<Segment>& segments, int width, 
+                      int height, double pixelSize, 
+                      std::vector<uint8_t>& pixels) const
+{
+    std::vector<Edge> edges;
+    edges.reserve(segments.size());
+    
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        // convert to pixel coordinates, with rows counting down from the top
+        const Segment& s = segments[i];
+        double x0 = (s.x0 - _centerX) / pixelSize + width / 2.0;
+        double x1 = (s.x1 - _centerX) / pixelSize + width / 2.0;
+        double y0 = height / 2.0 - (s.y0 - _centerY) / pixelSize;
+        double y1 = height / 2.0 - (s.y1 - _centerY) / pixelSize;
+        
+        // horizontal segments don't cross any rows
+        if (y0 == y1)
+            continue;
+        
+        Edge edge;
+        edge.winding = y1 > y0 ? 1 : -1;
+        if (y0 > y1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        
+        // rows whose centers lie in [y0, y1)
+        edge.firstRow = std::max(0, (int)std::ceil(y0 - 0.5));
+        edge.lastRow = std::min(height - 1, (int)std::ceil(y1 - 0.5) - 1);
+        if (edge.firstRow > edge.lastRow)
+            continue;
+        
+        edge.dxdy = (x1 - x0) / (y1 - y0);
+        edge.x = x0 + (edge.firstRow + 0.5 - y0) * edge.dxdy;
+        edges.push_back(edge);
+    }
+    
+    std::vector<std::pair<int, size_t> > edgeTable;
+    edgeTable.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); i++)
+        edgeTable.push_back(std::make_pair(edges[i].firstRow, i));
+    std::sort(edgeTable.begin(), edgeTable.end(), EdgeStartsFirst);
+    
+    std::vector<size_t> activeEdges;
+    std::vector<std::pair<double, int> > crossings;
+    size_t nextEdge = 0;
+    
+    for (int row = 0; row < height; row++)
+    {
+        while (nextEdge < edgeTable.size() && 
+               edgeTable[nextEdge].first == row)
+        {
+            activeEdges.push_back(edgeTable[nextEdge++].second);
+        }
+        
+        if (activeEdges.empty())
+        {
+            if (nextEdge == edgeTable.size())
+                break;
+            continue;
+        }
+        
+        crossings.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < activeEdges.size(); i++)
+        {
+            Edge& edge = edges[activeEdges[i]];
+            crossings.push_back(std::make_pair(edge.x, edge.winding));
+            edge.x += edge.dxdy;
+            if (edge.lastRow > row)
+                activeEdges[kept++] = activeEdges[i];
+        }
+        activeEdges.resize(kept);
+        
+        std::sort(crossings.begin(), crossings.end());
+        
+        uint8_t* pRow = &pixels[row * width];
+        int winding = 0;
+        for (size_t i = 0; i + 1 < crossings.size(); i++)
+        {
+            winding += crossings[i].second;
+            if (winding == 0)
+                continue;
+            
+            // columns whose centers lie in [start, end)
+            int first = std::max(0, 
+                                 (int)std::ceil(crossings[i].first - 0.5));
+            int last = std::min(width - 1, 
+                            (int)std::ceil(crossings[i + 1].first - 0.5) - 1);
+            if (first <= last)
+                std::memset(pRow + first, 0xFF, last - first + 1);
+        }
+    }
+}
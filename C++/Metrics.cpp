@@ -0,0 +1,144 @@
+//  File:   Metrics.cpp
+//  Registry of performance metrics, exported in Prometheus text format
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <sstream>
+#include <stdexcept>
+
+#include <Metrics.h>
+
+// Write the metric's description and current samples.
+void Metric::Write(std::ostream& out) const
+{
+    out << "# HELP " << _name << " " << _help << "\n";
+    out << "# TYPE " << _name << " " << GetType() << "\n";
+    WriteSamples(out);
+}
+
+void Counter::WriteSamples(std::ostream& out) const
+{
+    out << _name << " " << GetValue() << "\n";
+}
+
+void Gauge::WriteSamples(std::ostream& out) const
+{
+    out << _name << " " << GetValue() << "\n";
+}
+
+// Constructor, upperBounds must be in increasing order.
+Histogram::Histogram(const std::string& name, const std::string& help,
+                     const std::vector<double>& upperBounds) :
+Metric(name, help),
+_upperBounds(upperBounds),
+_bucketCounts(upperBounds.size(), 0),
+_count(0),
+_sum(0.0)
+{
+}
+
+void Histogram::Observe(double value)
+{
+    // only count the first bucket it fits in, buckets are accumulated when
+    // written
+    for (size_t i = 0; i < _upperBounds.size(); i++)
+    {
+        if (value <= _upperBounds[i])
+        {
+            _bucketCounts[i]++;
+            break;
+        }
+    }
+    _count++;
+    _sum += value;
+}
+
+void Histogram::WriteSamples(std::ostream& out) const
+{
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < _upperBounds.size(); i++)
+    {
+        cumulative += _bucketCounts[i];
+        out << _name << "_bucket{le=\"" << _upperBounds[i] << "\"} " 
+            << cumulative << "\n";
+    }
+    out << _name << "_bucket{le=\"+Inf\"} " << _count << "\n";
+    out << _name << "_sum " << _sum << "\n";
+    out << _name << "_count " << _count << "\n";
+}
+
+// Get the one and only instance of the registry.
+Metrics& Metrics::Instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+// Get the named counter, creating it if it doesn't exist yet.
+Counter& Metrics::GetCounter(const std::string& name, const std::string& help)
+{
+    std::unique_ptr<Metric>& pMetric = _metrics[name];
+    if (!pMetric)
+        pMetric.reset(new Counter(name, help));
+    
+    Counter* pCounter = dynamic_cast<Counter*>(pMetric.get());
+    if (!pCounter)
+        throw std::logic_error("metric " + name + " is not a counter");
+    return *pCounter;
+}
+
+// Get the named gauge, creating it if it doesn't exist yet.
+Gauge& Metrics::GetGauge(const std::string& name, const std::string& help)
+{
+    std::unique_ptr<Metric>& pMetric = _metrics[name];
+    if (!pMetric)
+        pMetric.reset(new Gauge(name, help));
+    
+    Gauge* pGauge = dynamic_cast<Gauge*>(pMetric.get());
+    if (!pGauge)
+        throw std::logic_error("metric " + name + " is not a gauge");
+    return *pGauge;
+}
+
+// Get the named histogram, creating it with the given bucket bounds if it 
+// doesn't exist yet.
+Histogram& Metrics::GetHistogram(const std::string& name, 
+                                 const std::string& help,
+                                 const std::vector<double>& upperBounds)
+{
+    std::unique_ptr<Metric>& pMetric = _metrics[name];
+    if (!pMetric)
+        pMetric.reset(new Histogram(name, help, upperBounds));
+    
+    Histogram* pHistogram = dynamic_cast<Histogram*>(pMetric.get());
+    if (!pHistogram)
+        throw std::logic_error("metric " + name + " is not a histogram");
+    return *pHistogram;
+}
+
+// Get all the metrics in the Prometheus text exposition format.
+std::string Metrics::ToPrometheusText() const
+{
+    std::ostringstream out;
+    for (std::map<std::string, std::unique_ptr<Metric>>::const_iterator it = 
+            _metrics.begin(); it != _metrics.end(); it++)
+    {
+        it->second->Write(out);
+    }
+    return out.str();
+}
@@ -0,0 +1,114 @@
+//  File:   MetricsServer.cpp
+//  Serves the metrics registry to scrapers on a loopback HTTP port
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include "MetricsServer.h"
+#include "Metrics.h"
+#include "ErrorMessage.h"
+
+// don't let a slow scraper hold up the event loop for long
+constexpr int METRICS_SEND_TIMEOUT_MS = 100;
+
+// Listen for scrape requests on the given port, on the loopback interface 
+// only, so metrics are only reachable from the printer itself or through a 
+// collector running there.
+MetricsServer::MetricsServer(int port)
+{
+    _listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0)
+        throw std::runtime_error(ErrorMessage::Format(MetricsSocketCreation,
+                                 errno));
+    
+    int reuse = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    if (bind(_listenFd, (sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(_listenFd, 4) < 0)
+    {
+        close(_listenFd);
+        throw std::runtime_error(ErrorMessage::Format(MetricsSocketCreation,
+                                 errno));
+    }
+}
+
+MetricsServer::~MetricsServer()
+{
+    close(_listenFd);
+}
+
+uint32_t MetricsServer::GetEventTypes() const
+{
+    return EPOLLIN;
+}
+
+int MetricsServer::GetFileDescriptor() const
+{
+    return _listenFd;
+}
+
+// Accept a connection and answer it with the current metrics, whatever was 
+// requested.  Nothing is passed on to subscribers.
+EventDataVec MetricsServer::Read()
+{
+    EventDataVec eventData;
+    
+    int fd = accept4(_listenFd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0)
+        return eventData;
+    
+    timeval timeout = { 0, METRICS_SEND_TIMEOUT_MS * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    // discard whatever part of the request has arrived
+    char request[512];
+    recv(fd, request, sizeof(request), MSG_DONTWAIT);
+    
+    std::string body = Metrics::Instance().ToPrometheusText();
+    std::ostringstream response;
+    response << "HTTP/1.0 200 OK\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "\r\n" << body;
+    std::string text = response.str();
+    send(fd, text.data(), text.size(), MSG_NOSIGNAL);
+    
+    close(fd);
+    return eventData;
+}
+
+bool MetricsServer::QualifyEvents(uint32_t events) const
+{
+    return EPOLLIN & events;
+}
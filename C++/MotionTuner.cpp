@@ -0,0 +1,143 @@
+//  File:   MotionTuner.cpp
+//  Finds the fastest separation and approach profiles that run reliably on a
+//  given printer, and records them in its settings
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <algorithm>
+
+#include "MotionTuner.h"
+#include "Settings.h"
+
+// increase in speeds and jerks between successive tuning steps, as a fraction 
+// of the current profile
+constexpr double TUNING_STEP          = 0.1;
+// the fastest profile tried, as a multiple of the current profile
+constexpr double MAX_TUNING_FACTOR    = 2.0;
+// number of trials that must all succeed for a profile to count as reliable
+constexpr int    TRIALS_PER_STEP      = 3;
+// fraction of the fastest reliable profile that's actually recorded
+constexpr double TUNING_SAFETY_MARGIN = 0.85;
+
+constexpr int PROFILE_SIZE = 8;
+
+// the members of CurrentLayerSettings that make up the separation and 
+// approach motion profiles
+static int CurrentLayerSettings::* const PROFILE_MEMBERS[PROFILE_SIZE] = 
+{
+    &CurrentLayerSettings::SeparationRotJerk,
+    &CurrentLayerSettings::SeparationRPM,
+    &CurrentLayerSettings::SeparationZJerk,
+    &CurrentLayerSettings::SeparationMicronsPerSec,
+    &CurrentLayerSettings::ApproachRotJerk,
+    &CurrentLayerSettings::ApproachRPM,
+    &CurrentLayerSettings::ApproachZJerk,
+    &CurrentLayerSettings::ApproachMicronsPerSec
+};
+
+// the names of the settings holding those members, for each LayerType
+static const char* const PROFILE_SETTINGS[][PROFILE_SIZE] = 
+{
+    {FL_SEPARATION_R_JERK, FL_SEPARATION_R_SPEED, 
+     FL_SEPARATION_Z_JERK, FL_SEPARATION_Z_SPEED,
+     FL_APPROACH_R_JERK,   FL_APPROACH_R_SPEED, 
+     FL_APPROACH_Z_JERK,   FL_APPROACH_Z_SPEED},
+    {BI_SEPARATION_R_JERK, BI_SEPARATION_R_SPEED, 
+     BI_SEPARATION_Z_JERK, BI_SEPARATION_Z_SPEED,
+     BI_APPROACH_R_JERK,   BI_APPROACH_R_SPEED, 
+     BI_APPROACH_Z_JERK,   BI_APPROACH_Z_SPEED},
+    {ML_SEPARATION_R_JERK, ML_SEPARATION_R_SPEED, 
+     ML_SEPARATION_Z_JERK, ML_SEPARATION_Z_SPEED,
+     ML_APPROACH_R_JERK,   ML_APPROACH_R_SPEED, 
+     ML_APPROACH_Z_JERK,   ML_APPROACH_Z_SPEED}
+};
+
+MotionTuner::MotionTuner(Settings& settings, IMotionTrial& trial) :
+_settings(settings),
+_trial(trial)
+{
+}
+
+// Find the fastest separation and approach profile for the layer type of the
+// given settings that completes every trial, by scaling all of its speeds and 
+// jerks up together in small steps, stopping at the first step that fails.  
+// A safety margin is taken off the fastest reliable profile before it's 
+// recorded in the settings, but the recorded profile is never slower than the
+// given one.  Returns the factor by which the recorded profile is faster than
+// the given one, or 0 if the given profile itself wasn't reliable, in which 
+// case nothing is recorded.
+double MotionTuner::Tune(const CurrentLayerSettings& cls)
+{
+    if (!RunTrials(cls, 1.0))
+        return 0.0;
+    
+    double fastest = 1.0;
+    // count steps rather than accumulating the factor, to avoid rounding errors
+    int maxSteps = (int)round((MAX_TUNING_FACTOR - 1.0) / TUNING_STEP);
+    for (int step = 1; step <= maxSteps; step++)
+    {
+        double factor = 1.0 + step * TUNING_STEP;
+        if (!RunTrials(cls, factor))
+            break;
+        
+        fastest = factor;
+    }
+    
+    double recorded = std::max(1.0, fastest * TUNING_SAFETY_MARGIN);
+    if (recorded > 1.0)
+    {
+        CurrentLayerSettings tuned = cls;
+        Scale(tuned, recorded);
+        Record(tuned);
+    }
+    return recorded;
+}
+
+// Scale all the speeds and jerks of the separation and approach profiles in 
+// the given settings by the given factor.
+void MotionTuner::Scale(CurrentLayerSettings& cls, double factor)
+{
+    for (int i = 0; i < PROFILE_SIZE; i++)
+        cls.*PROFILE_MEMBERS[i] = (int)round(cls.*PROFILE_MEMBERS[i] * factor);
+}
+
+// Run the given profile, scaled by the given factor, the required number of
+// times, returning false as soon as any of those trials fails.
+bool MotionTuner::RunTrials(const CurrentLayerSettings& cls, double factor)
+{
+    CurrentLayerSettings scaled = cls;
+    Scale(scaled, factor);
+    
+    for (int i = 0; i < TRIALS_PER_STEP; i++)
+    {
+        if (!_trial.Run(scaled))
+            return false;
+    }
+    return true;
+}
+
+// Write the separation and approach profiles from the given settings to the 
+// settings for their layer type, and persist them.
+void MotionTuner::Record(const CurrentLayerSettings& cls)
+{
+    for (int i = 0; i < PROFILE_SIZE; i++)
+        _settings.Set(PROFILE_SETTINGS[cls.Type][i], cls.*PROFILE_MEMBERS[i]);
+    
+    _settings.Save();
+}
@@ -33,7 +33,8 @@ constexpr int DELAY_AFTER_RESET_MSEC  = 500;
 // Public constructor, base class opens I2C connection and sets slave address
 Motor::Motor(const I_I2C_Device& i2cDevice) :
 _i2cDevice(i2cDevice),
-_settings(PrinterSettings::Instance())
+_settings(PrinterSettings::Instance()),
+_lastTag(0)
 {
 }
 
@@ -45,7 +46,7 @@ Motor::~Motor()
 
 // Send a set of commands to the motor controller.  Returns false immediately 
 // if any of the commands cannot be sent.
-bool Motor::SendCommands(std::vector<MotorCommand> commands)
+bool Motor::SendCommands(MotorCommandVec& commands)
 {
     for(int i = 0; i < commands.size(); i++)
         if (!commands[i].Send(_i2cDevice))
@@ -53,6 +54,29 @@ bool Motor::SendCommands(std::vector<MotorCommand> commands)
     return true;
 }
 
+// Add a request for an interrupt when all the preceding commands have been 
+// completed, tagged so the completion of this sequence can be identified.
+void Motor::RequestInterrupt(MotorCommandVec& commands)
+{
+    // tags run from 1 to MC_MAX_TAG, since 0 means no sequence was completed
+    _lastTag = _lastTag % MC_MAX_TAG + 1;
+    commands.push_back(MotorCommand(MC_SEQUENCE_REG, MC_TAG, _lastTag));
+}
+
+// Read the tag of the last sequence the motor controller completed, and the 
+// number of commands it can accept without overflowing its queues.  Returns 
+// false if they can't be read.
+bool Motor::ReadQueueStatus(int& lastCompletedTag, int& freeSlots)
+{
+    unsigned char status[2];
+    if (!_i2cDevice.Read(MC_QUEUE_REG, status, 2))
+        return false;
+    
+    lastCompletedTag = status[0];
+    freeSlots = status[1];
+    return true;
+}
+
 // Enable (engage) both motors.  Return false if they can't be enabled.
 bool Motor::EnableMotors()
 {
@@ -82,7 +106,7 @@ bool Motor::Resume()
 // preceding pause yet.
 bool Motor::ClearPendingCommands(bool withInterrupt)
 {
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     commands.push_back(MotorCommand(MC_GENERAL_REG, MC_CLEAR));
     
@@ -90,7 +114,7 @@ bool Motor::ClearPendingCommands(bool withInterrupt)
     {
         // request an interrupt, to avoid sending new motor commands before the 
         // clear has been completed
-        commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+        RequestInterrupt(commands);
     }
     
     return SendCommands(commands);  
@@ -99,7 +123,7 @@ bool Motor::ClearPendingCommands(bool withInterrupt)
 // Reset and initialize the motor controller.
 bool Motor::Initialize()
 {    
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // perform a software reset
     if (!MotorCommand(MC_GENERAL_REG, MC_RESET).Send(_i2cDevice))
@@ -140,7 +164,7 @@ bool Motor::Initialize()
 // keep the tray's window in the open position, in support of demo mode.
 bool Motor::GoHome(bool withInterrupt, bool rotateHome, bool stayOpen)
 {
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // set rotation parameters
     commands.push_back(MotorCommand(MC_ROT_SETTINGS_REG, MC_JERK, 
@@ -175,20 +199,22 @@ bool Motor::GoHome(bool withInterrupt, bool rotateHome, bool stayOpen)
     if (withInterrupt)
     {           
         // request an interrupt when these commands are completed
-        commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+        RequestInterrupt(commands);
     }
     return SendCommands(commands);
 }
 
 // Goes to home position (without interrupt), then lowers the build platform to
-// the PDMS in order to calibrate and/or start a print
-bool Motor::GoToStartPosition()
+// the PDMS in order to calibrate and/or start a print.  The homing may be 
+// omitted when the caller knows both axes are already at home.
+bool Motor::GoToStartPosition(bool homeFirst)
 {
     EnableMotors();
     
-    GoHome(false);
+    if (homeFirst)
+        GoHome(false);
     
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // set rotation parameters
     commands.push_back(MotorCommand(MC_ROT_SETTINGS_REG, MC_JERK, 
@@ -215,7 +241,7 @@ bool Motor::GoToStartPosition()
                                     _settings.GetInt(Z_START_PRINT_POSITION)));
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
@@ -223,7 +249,7 @@ bool Motor::GoToStartPosition()
 // Separate the current layer 
 bool Motor::Separate(const CurrentLayerSettings& cls)
 {
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
 
     // rotate the previous layer from the PDMS
     commands.push_back(MotorCommand(MC_ROT_SETTINGS_REG, MC_JERK, 
@@ -246,7 +272,7 @@ bool Motor::Separate(const CurrentLayerSettings& cls)
                                                             cls.ZLiftMicrons));
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
@@ -259,8 +285,36 @@ bool Motor::Approach(const CurrentLayerSettings& cls, bool unJamFirst)
         if (!UnJam(cls, false))
             return false;
 
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
+    AddApproachCommands(cls, commands);
     
+    return SendCommands(commands);
+}
+
+// Queue the approach for the next layer behind the separation still in 
+// progress, so that the motor controller can start it as soon as the 
+// separation completes.  Sets the tag the motor controller will report when 
+// the approach completes.  Returns false without sending anything if the 
+// motor controller doesn't have room for all of the approach commands, in 
+// which case the approach needs to be sent after the separation completes.
+bool Motor::QueueApproach(const CurrentLayerSettings& cls, int& tag)
+{
+    MotorCommandVec commands;
+    AddApproachCommands(cls, commands);
+    
+    int lastCompletedTag, freeSlots;
+    if (!ReadQueueStatus(lastCompletedTag, freeSlots) || 
+        freeSlots < static_cast<int>(commands.size()))
+        return false;   // the unused tag is simply skipped
+    
+    tag = _lastTag;
+    return SendCommands(commands);
+}
+
+// Add the commands for the approach to the given vector. 
+void Motor::AddApproachCommands(const CurrentLayerSettings& cls, 
+                                MotorCommandVec& commands)
+{
     // rotate back to the PDMS
     commands.push_back(MotorCommand(MC_ROT_SETTINGS_REG, MC_JERK, 
                                     cls.ApproachRotJerk));
@@ -291,16 +345,14 @@ bool Motor::Approach(const CurrentLayerSettings& cls, bool unJamFirst)
         commands.push_back(MotorCommand(MC_Z_ACTION_REG, MC_MOVE, deltaZ));
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
-    
-    return SendCommands(commands);
+    RequestInterrupt(commands);
 }
 
 // Rotate the tray and (if CanInspect is true) lift the build head to inspect 
 // the print in progress.
 bool Motor::PauseAndInspect(const CurrentLayerSettings& cls)
 {    
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // use same speeds & jerks as used for homing, since we're already separated     
     commands.push_back(MotorCommand(MC_ROT_SETTINGS_REG, MC_JERK, 
@@ -326,7 +378,7 @@ bool Motor::PauseAndInspect(const CurrentLayerSettings& cls)
     }
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
@@ -335,7 +387,7 @@ bool Motor::PauseAndInspect(const CurrentLayerSettings& cls)
 // inspection position, to resume printing. 
 bool Motor::ResumeFromInspect(const CurrentLayerSettings& cls)
 {
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
 
     // use same speeds & jerks as used for moving to start position, 
     // since we're already calibrated     
@@ -364,7 +416,7 @@ bool Motor::ResumeFromInspect(const CurrentLayerSettings& cls)
     }
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
@@ -379,7 +431,7 @@ bool Motor::UnJam(const CurrentLayerSettings& cls, bool withInterrupt)
     // assumes speed & jerk have already 
     // been set as needed for separation from the current layer type 
 
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
                
     // rotate to the home position (but no more than a full rotation)
     commands.push_back(MotorCommand(MC_ROT_ACTION_REG, MC_HOME,
@@ -392,7 +444,7 @@ bool Motor::UnJam(const CurrentLayerSettings& cls, bool withInterrupt)
     if (withInterrupt)
     {
         // request an interrupt when these commands are completed
-        commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+        RequestInterrupt(commands);
     }
 
     return SendCommands(commands);    
@@ -404,7 +456,7 @@ bool Motor::Press(const CurrentLayerSettings& cls)
 {
     // reuse existing jerk settings from approach
 
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // press down on the tray
     commands.push_back(MotorCommand(MC_Z_SETTINGS_REG, MC_SPEED, 
@@ -414,7 +466,7 @@ bool Motor::Press(const CurrentLayerSettings& cls)
                                                         -cls.PressMicrons));
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
@@ -425,7 +477,7 @@ bool Motor::Unpress(const CurrentLayerSettings& cls)
 {
     // reuse existing jerk settings from approach
 
-    std::vector<MotorCommand> commands;
+    MotorCommandVec commands;
     
     // lift up on the tray
     commands.push_back(MotorCommand(MC_Z_SETTINGS_REG, MC_SPEED, 
@@ -435,7 +487,7 @@ bool Motor::Unpress(const CurrentLayerSettings& cls)
                                                             cls.PressMicrons));
     
     // request an interrupt when these commands are completed
-    commands.push_back(MotorCommand(MC_GENERAL_REG, MC_INTERRUPT));
+    RequestInterrupt(commands);
     
     return SendCommands(commands);
 }
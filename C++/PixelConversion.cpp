@@ -0,0 +1,42 @@
+//  File:   PixelConversion.cpp
+//  Converts rows of 8-bit grey slice pixels into the formats scanned out by
+//  the display controller
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include "PixelConversion.h"
+
+// Expand a row of grey pixels into 5-6-5 RGB pixels.
+void GreyRowToRGB565(const uint8_t* pSource, uint16_t* pDest, int width)
+{
+    for (int x = 0; x < width; x++)
+        pDest[x] = GreyToRGB565(pSource[x]);
+}
+
+// Expand a row of grey pixels into XRGB8888 pixels having the same value in
+// each of the red, green, and blue channels.
+void GreyRowToXRGB8888(const uint8_t* pSource, uint32_t* pDest, int width)
+{
+    for (int x = 0; x < width; x++)
+    {
+        uint32_t value = pSource[x];
+        pDest[x] = (value << 16) | // red
+                   (value << 8)  | // green
+                    value;         // blue
+    }
+}
@@ -25,10 +25,15 @@
 #include <sys/stat.h>
 #include <string.h>
 #include <unistd.h>
+#include <stdexcept>
 
 #include <PrintData.h>
 #include <PrintDataDirectory.h>
 #include <PrintDataZip.h>
+#include <PrintDataMesh.h>
+#include <PrintDataTarGz.h>
+#include <TarGzIndex.h>
+#include <Filenames.h>
 #include <utils.h>
 #include <TarGzFile.h>
 #include "PrintFileStorage.h"
@@ -36,26 +41,67 @@
 // Use the specified storage object to find a print file and return an
 // appropriate PrintData instance, placing the print data in the specified
 // dataParentDirectory. The print data is renamed to or placed in a directory
-// named according to specified newName.
+// named according to specified newName.  Indexing of a tar.gz reports its
+// progress to, and may be abandoned by, the optional progress callback.
 PrintData* PrintData::CreateFromNewData(const PrintFileStorage& storage,
-        const std::string& dataParentDirectory, const std::string& newName)
+        const std::string& dataParentDirectory, const std::string& newName,
+        const ExtractProgressCallback& progress)
 {
     // avoid naming collisions by clearing the specified data parent directory
     PurgeDirectory(dataParentDirectory);
 
     // create a destination path for the print data
-    // for a tar.gz, the archive is extracted into a directory at this path
+    // for a tar.gz holding slice images, the archive is renamed to this path
+    // and its index is kept alongside it
+    // for a tar.gz holding a mesh, the archive is extracted into a directory 
+    // at this path
     // for a zip, the archive is renamed to this path
     std::string printDataDestination = dataParentDirectory + "/" + newName;
 
     if (storage.HasTarGz())
     {
-        // make a directory to extract to
+        // index the archive so slice images can be read from it in place
+        std::string indexPath = 
+                        PrintDataTarGz::GetIndexPath(printDataDestination);
+        TarGzIndex index(storage.GetFilePath(), indexPath);
+        bool indexSuccessful = index.Build(progress);
+        
+        if (indexSuccessful && !index.Contains(MESH_FILE))
+        {
+            rename(storage.GetFilePath().c_str(), 
+                   printDataDestination.c_str());
+            try
+            {
+                return new PrintDataTarGz(printDataDestination);
+            }
+            catch (const std::runtime_error& e)
+            {
+                // remove unusable file
+                remove(printDataDestination.c_str());
+                remove(indexPath.c_str());
+                return NULL;
+            }
+        }
+        
+        remove(indexPath.c_str());
+        
+        if (!indexSuccessful)
+        {
+            // not a valid tar.gz file, or loading was abandoned
+            remove(storage.GetFilePath().c_str());
+            return NULL;
+        }
+        
+        // the mesh is sliced from a directory, so extract the archive
+        // its contents were already indexed, leaving only cancellation to
+        // report
         mkdir(printDataDestination.c_str(), 0755);
         
-        // extract the archive
         bool extractSuccessful = TarGzFile::Extract(storage.GetFilePath(),
-                printDataDestination);
+                printDataDestination, [&progress](double)
+                {
+                    return !progress || progress(1.0);
+                });
 
         // remove the print file regardless of extraction success
         remove(storage.GetFilePath().c_str());
@@ -68,7 +114,7 @@ PrintData* PrintData::CreateFromNewData(const PrintFileStorage& storage,
             return NULL;
         }
         
-        return new PrintDataDirectory(printDataDestination);
+        return new PrintDataMesh(printDataDestination);
     }
     else if (storage.HasZip())
     {
@@ -92,6 +138,25 @@ PrintData* PrintData::CreateFromNewData(const PrintFileStorage& storage,
         return NULL;
 }
 
+// Return a PrintData instance that reads the zip file specified by filePath in
+// place, e.g. on a USB drive, without moving or ever removing it.  Up to 
+// readAheadLayers upcoming layers are kept in memory to ride out the latency 
+// of the storage device.
+PrintData* PrintData::CreateFromRemovableStorage(const std::string& filePath,
+        int readAheadLayers, const std::string& copyPath)
+{
+    PrintDataZip::Initialize();
+    try
+    {
+        return new PrintDataZip(filePath, false, readAheadLayers, copyPath);
+    }
+    catch (const zppError& e)
+    {
+        // not a valid zip file
+        return NULL;
+    }
+}
+
 // Look for a file or directory named specified by printDataPath.
 // Return a pointer to an appropriate PrintData instance depending on if the
 // function found a zip file or directory.
@@ -102,12 +167,31 @@ PrintData* PrintData::CreateFromExistingData(const std::string& printDataPath)
     stat(printDataPath.c_str(), &statBuffer);
 
     // check if printDataPath is a directory
-    // if not, check if it is a file, if it is assume zip file
+    // if not, check if it is a file, if it is assume zip file unless it has
+    // the index of a tar.gz file alongside it
     if (S_ISDIR(statBuffer.st_mode))
     {
-        // directory
+        // directory, holding either a mesh or slice images
+        if (PrintDataMesh::ContainsMesh(printDataPath))
+            return new PrintDataMesh(printDataPath);
+        
         return new PrintDataDirectory(printDataPath);
     }
+    else if (S_ISREG(statBuffer.st_mode) && 
+             access(PrintDataTarGz::GetIndexPath(printDataPath).c_str(), 
+                    F_OK) == 0)
+    {
+        // indexed tar.gz file
+        try
+        {
+            return new PrintDataTarGz(printDataPath);
+        }
+        catch (const std::runtime_error& e)
+        {
+            // index doesn't describe the file
+            return NULL;
+        }
+    }
     else if (S_ISREG(statBuffer.st_mode))
     {
         // zip file
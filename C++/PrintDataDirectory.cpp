@@ -26,6 +26,7 @@
 #include <sstream>
 #include <dirent.h>
 #include <glob.h>
+#include <stdexcept>
 
 #include <PrintDataDirectory.h>
 #include <Logger.h>
@@ -43,13 +44,24 @@ PrintDataDirectory::~PrintDataDirectory()
 {
 }
 
-// Gets the image for the given layer
+// Gets the image for the given layer, using the contents of its slice image
+// file if already read ahead
 bool PrintDataDirectory::GetImageForLayer(int layer, Magick::Image* pImage)
 {
     std::string fileName = GetLayerFileName(layer);
     try
     {
-        pImage->read(fileName.c_str());
+        if (!_pReader)
+            _pReader.reset(new AsyncFileReader());
+        
+        std::string contents;
+        if ((!_pReader->IsPending(layer) && 
+             !_pReader->Submit(layer, fileName)) ||
+            !_pReader->Wait(layer, contents))
+            throw std::runtime_error(fileName);
+        
+        Magick::Blob blob(contents.data(), contents.size()); 
+        pImage->read(blob);
         return true;
     }
     catch(std::exception)
@@ -59,6 +71,26 @@ bool PrintDataDirectory::GetImageForLayer(int layer, Magick::Image* pImage)
     }
 }
 
+// Start reading the slice images for the layers following the given one, so
+// that storage latency is hidden behind decoding and exposure of the current
+// layer.  Reads for any other layers are abandoned.
+void PrintDataDirectory::ReadAhead(int layer)
+{
+    if (!_pReader)
+        return;
+    
+    int lastLayer = layer + ASYNC_READ_QUEUE_DEPTH;
+    _pReader->DiscardOutside(layer + 1, lastLayer);
+    
+    for (int i = layer + 1; i <= lastLayer; i++)
+    {
+        // stop past the last layer
+        if (!_pReader->IsPending(i) && 
+            !_pReader->Submit(i, GetLayerFileName(i)))
+            break;
+    }
+}
+
 // If the print data contains the specified file, read contents into specified 
 // string and return true.  Otherwise, return false.
 bool PrintDataDirectory::GetFileContents(const std::string& fileName, 
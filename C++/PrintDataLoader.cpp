@@ -0,0 +1,406 @@
+//  File:   PrintDataLoader.cpp
+//  Stages, extracts, and validates incoming print data on a worker thread,
+//  reporting progress to the event loop
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdio>
+
+#define RAPIDJSON_ASSERT(x)                         \
+  if (x);                                            \
+  else throw std::exception();  
+
+#include <rapidjson/document.h>
+
+using namespace rapidjson;
+
+#include "PrintDataLoader.h"
+#include "PrintData.h"
+#include "PrintFileStorage.h"
+#include "Filenames.h"
+#include "utils.h"
+#include "Shared.h"
+#include "Settings.h"
+
+// share of the progress attributed to indexing or extracting the print file,
+// the remainder covers validation
+constexpr int EXTRACTION_PERCENT = 95;
+
+// Constructor
+// Create an eventfd instance for use as the signaling mechanism to the event
+// loop
+PrintDataLoader::PrintDataLoader() :
+_fd(eventfd(0, 0)),
+_thread(0),
+_loading(false),
+_percent(0),
+_finished(false),
+_cancelRequested(false),
+_direct(false),
+_layerThickness(0),
+_readAheadLayers(0),
+_canceled(false),
+_result(Success),
+_haveEmbeddedSettings(false),
+_pPrintData(NULL)
+{
+    if (_fd < 0)
+        throw std::runtime_error(ErrorMessage::Format(EventfdCreate, errno));
+}
+
+// Destructor abandons any load in progress before releasing the eventfd
+PrintDataLoader::~PrintDataLoader()
+{
+    if (_loading)
+    {
+        Cancel();
+        if (_thread != 0)
+            pthread_join(_thread, NULL);
+    }
+
+    delete _pPrintData;
+    close(_fd);
+}
+
+uint32_t PrintDataLoader::GetEventTypes() const
+{
+    return EPOLLIN | EPOLLET;
+}
+
+int PrintDataLoader::GetFileDescriptor() const
+{
+    return _fd;
+}
+
+bool PrintDataLoader::QualifyEvents(uint32_t events) const
+{
+    return EPOLLIN & events;
+}
+
+// Wait for the worker thread to exit.  Its results are still collected by 
+// the event loop, from the event it raised on finishing.
+bool PrintDataLoader::AwaitCompletion()
+{
+    if (_thread == 0)
+        return false;
+    
+    pthread_join(_thread, NULL);
+    _thread = 0;
+    return true;
+}
+
+// Report the most recent progress of the worker thread, discarding the count 
+// of intermediate updates.  Once the worker has finished, join it so that its
+// results can be collected.
+EventDataVec PrintDataLoader::Read()
+{
+    EventDataVec eventData;
+
+    uint64_t buffer;
+    read(_fd, &buffer, sizeof(uint64_t));
+    
+    if (!_loading)
+        return eventData;
+    
+    PrintDataLoadStatus status;
+    status.percent = _percent;
+    status.finished = _finished;
+    
+    if (status.finished)
+    {
+        if (_thread != 0)
+            pthread_join(_thread, NULL);
+        _thread = 0;
+        _loading = false;
+    }
+    
+    eventData.push_back(EventData(status));
+    return eventData;
+}
+
+// Start loading the print file found in downloadDir on a worker thread, 
+// staging it in stagingDir under newName.  If sourcePath is not empty, the 
+// file it specifies is first copied into downloadDir, unless adoptedName is 
+// also given, in which case the file is instead moved there under that name.
+// layerThickness is that of the current settings, for print data sliced as 
+// it's printed, unless the print file comes with its own settings.
+// Returns false if a load is already in progress or the thread can't be 
+// started.
+bool PrintDataLoader::Start(const std::string& sourcePath, 
+                            const std::string& downloadDir,
+                            const std::string& stagingDir, 
+                            const std::string& newName,
+                            int layerThickness,
+                            const std::string& adoptedName)
+{
+    if (_loading)
+        return false;
+    
+    _sourcePath = sourcePath;
+    _downloadDir = downloadDir;
+    _stagingDir = stagingDir;
+    _newName = newName;
+    _adoptedName = adoptedName;
+    _layerThickness = layerThickness;
+    _direct = false;
+
+    return StartThread();
+}
+
+// Start loading the zip file specified by sourcePath on a worker thread for 
+// printing in place, e.g. directly from a USB drive, without copying or 
+// staging it.  Up to readAheadLayers upcoming layers are cached in memory 
+// while printing, and if copyPath is given, the file is copied there while
+// printing, to carry on from if the original goes away.
+// Returns false if a load is already in progress or the thread can't be 
+// started.
+bool PrintDataLoader::StartDirect(const std::string& sourcePath, 
+                                  int readAheadLayers, 
+                                  const std::string& copyPath)
+{
+    if (_loading)
+        return false;
+    
+    _sourcePath = sourcePath;
+    _readAheadLayers = readAheadLayers;
+    _copyPath = copyPath;
+    _direct = true;
+    
+    return StartThread();
+}
+
+// Clear the results of any previous load and start the worker thread.
+bool PrintDataLoader::StartThread()
+{
+    _percent = 0;
+    _finished = false;
+    _cancelRequested = false;
+    _canceled = false;
+    _result = Success;
+    _fileName = "";
+    _haveEmbeddedSettings = false;
+    _embeddedSettings = "";
+    delete _pPrintData;
+    _pPrintData = NULL;
+
+    if (pthread_create(&_thread, NULL, &InBackground, this) != 0)
+        return false;
+    
+    _loading = true;
+    return true;
+}
+
+// Ask the worker thread to abandon the load at its next opportunity.  The 
+// final PrintDataLoad event is still delivered.
+void PrintDataLoader::Cancel()
+{
+    _cancelRequested = true;
+}
+
+// Get the contents of the settings file embedded in the loaded print data, 
+// returning false if it had none.
+bool PrintDataLoader::GetEmbeddedSettings(std::string& settings) const
+{
+    settings = _embeddedSettings;
+    return _haveEmbeddedSettings;
+}
+
+// Transfer ownership of the successfully loaded print data to the caller.
+PrintData* PrintDataLoader::ReleasePrintData()
+{
+    PrintData* pPrintData = _pPrintData;
+    _pPrintData = NULL;
+    return pPrintData;
+}
+
+// Record the progress of the worker thread, signaling the event loop when it
+// changes.  Returns false if the load should be abandoned.
+bool PrintDataLoader::SetProgress(int percent)
+{
+    if (_percent.exchange(percent) != percent)
+        Signal();
+    
+    return !_cancelRequested;
+}
+
+// Wake the event loop.
+void PrintDataLoader::Signal()
+{
+    uint64_t buffer = 1;
+    write(_fd, &buffer, sizeof(uint64_t));
+}
+
+// Returns the layer thickness given by the settings JSON, or defaultThickness
+// if it doesn't give one.  The settings themselves belong to the event loop.
+static int GetLayerThickness(const std::string& json, int defaultThickness)
+{
+    try
+    {
+        Document doc;
+        doc.Parse(json.c_str());
+        if (doc.IsObject() && doc.HasMember(SETTINGS_ROOT_KEY))
+        {
+            const Value& settings = doc[SETTINGS_ROOT_KEY];
+            if (settings.IsObject() && settings.HasMember(LAYER_THICKNESS) &&
+                settings[LAYER_THICKNESS].IsInt())
+                return settings[LAYER_THICKNESS].GetInt();
+        }
+    }
+    catch (std::exception)
+    {
+    }
+    
+    return defaultThickness;
+}
+
+// Does the work of the load on the worker thread.  Anything that touches the
+// settings or the print data currently in use is left to the event loop.
+void PrintDataLoader::Load()
+{
+    if (_direct)
+    {
+        LoadDirect();
+        return;
+    }
+    
+    // copy the print file into the download directory if needed, so that the 
+    // original (e.g. on a USB drive) is neither moved nor deleted, unless
+    // it's been handed over to us, in which case it need only be renamed
+    if (!_sourcePath.empty())
+    {
+        if (_adoptedName.empty())
+            Copy(_sourcePath, _downloadDir);
+        else if (!Adopt(_sourcePath, _downloadDir + "/" + _adoptedName))
+        {
+            // the file is ours to dispose of, even though it can't be loaded
+            remove(_sourcePath.c_str());
+            _fileName = _adoptedName;
+            _result = CantAdoptPrintData;
+            return;
+        }
+    }
+
+    PrintFileStorage storage(_downloadDir);
+    _fileName = storage.GetFileName();
+
+    if (_cancelRequested)
+    {
+        remove(storage.GetFilePath().c_str());
+        _canceled = true;
+        return;
+    }
+    
+    // index, extract, or rename the print file into the staging directory
+    _pPrintData = PrintData::CreateFromNewData(storage, _stagingDir, _newName,
+            [this](double fractionDone)
+            {
+                return SetProgress(fractionDone * EXTRACTION_PERCENT);
+            });
+    
+    if (_cancelRequested)
+    {
+        // indexing and extraction clean up after themselves when abandoned
+        if (_pPrintData)
+            _pPrintData->Remove();
+        delete _pPrintData;
+        _pPrintData = NULL;
+        _canceled = true;
+        return;
+    }
+
+    if (!_pPrintData)
+    {
+        // no incoming print file found, or it could not be staged
+        _result = CantStageIncomingPrintData;
+        return;
+    }
+    
+    SetProgress(EXTRACTION_PERCENT);
+    
+    _haveEmbeddedSettings = _pPrintData->GetFileContents(
+                                EMBEDDED_PRINT_SETTINGS_FILE, _embeddedSettings);
+    
+    // validate with the layer thickness the print will have once its own 
+    // settings are applied
+    if (_haveEmbeddedSettings)
+        _layerThickness = GetLayerThickness(_embeddedSettings, _layerThickness);
+    _pPrintData->SetLayerThickness(_layerThickness);
+    
+    if (!_pPrintData->Validate())
+    {
+        _result = InvalidPrintData;
+        return;
+    }
+
+    SetProgress(100);
+}
+
+// Does the work of loading print data that stays where it is.  There's 
+// nothing to extract, so progress jumps straight to validation.
+void PrintDataLoader::LoadDirect()
+{
+    // the file name without its directory
+    _fileName = _sourcePath.substr(_sourcePath.find_last_of("/") + 1);
+    
+    _pPrintData = PrintData::CreateFromRemovableStorage(_sourcePath, 
+                                                        _readAheadLayers,
+                                                        _copyPath);
+    if (!_pPrintData)
+    {
+        _result = CantStageIncomingPrintData;
+        return;
+    }
+    
+    if (!SetProgress(EXTRACTION_PERCENT))
+    {
+        // nothing to clean up, since the data was left in place
+        delete _pPrintData;
+        _pPrintData = NULL;
+        _canceled = true;
+        return;
+    }
+
+    if (!_pPrintData->Validate())
+    {
+        _result = InvalidPrintData;
+        return;
+    }
+
+    _haveEmbeddedSettings = _pPrintData->GetFileContents(
+                                EMBEDDED_PRINT_SETTINGS_FILE, _embeddedSettings);
+
+    SetProgress(100);
+}
+
+// Entry point of the worker thread.
+void* PrintDataLoader::InBackground(void* context)
+{
+    PrintDataLoader* pLoader = (PrintDataLoader*)context;
+    
+    pLoader->Load();
+    
+    // let the event loop know the results are ready
+    pLoader->_finished = true;
+    pLoader->Signal();
+    
+    return NULL;
+}
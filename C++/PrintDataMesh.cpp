@@ -0,0 +1,104 @@
+//  File:   PrintDataMesh.cpp
+//  Handles print data holding a mesh that's sliced as each layer is needed
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <cmath>
+
+#include <PrintDataMesh.h>
+#include <Hardware.h>
+#include <Filenames.h>
+#include <Logger.h>
+
+// Constructor
+// directoryPath is the directory containing the mesh file and any other print 
+// data, which is loaded up front so that it doesn't need to be read again 
+// after the directory is moved
+PrintDataMesh::PrintDataMesh(const std::string& directoryPath) :
+PrintDataDirectory(directoryPath),
+_layerThickness(0)
+{
+    _slicer.LoadBinarySTL(directoryPath + "/" + MESH_FILE);
+}
+
+// Destructor
+PrintDataMesh::~PrintDataMesh()
+{
+}
+
+// Returns true if the specified directory contains a mesh file
+bool PrintDataMesh::ContainsMesh(const std::string& directoryPath)
+{
+    std::string path = directoryPath + "/" + MESH_FILE;
+    return std::ifstream(path.c_str()).good();
+}
+
+// Validate the print data, rejecting a mesh that doesn't fit within the 
+// projected image rather than printing it clipped
+bool PrintDataMesh::Validate()
+{
+    if (_slicer.IsEmpty() || GetLayerCount() <= 0)
+        return false;
+    
+    double pixelSize = VIDEO_MODE_PIXEL_SIZE_MICRONS / 1000.0;
+    if (_slicer.GetWidth() > VIDEO_MODE_WIDTH * pixelSize ||
+        _slicer.GetDepth() > VIDEO_MODE_HEIGHT * pixelSize)
+    {
+        Logger::LogError(LOG_ERR, errno, MeshTooLarge, MESH_FILE);
+        return false;
+    }
+    
+    return true;
+}
+
+// Set the thickness of the layers the mesh is sliced into.  The mesh has no
+// layers until this is given.
+void PrintDataMesh::SetLayerThickness(int microns)
+{
+    _layerThickness = microns;
+}
+
+// Gets the number of layers needed to print the mesh at the given layer 
+// thickness
+int PrintDataMesh::GetLayerCount()
+{
+    int thickness = _layerThickness;
+    if (_slicer.IsEmpty() || thickness <= 0)
+        return 0;
+    
+    // allow for rounding in heights that are a multiple of the thickness
+    return (int)std::ceil(_slicer.GetHeight() * 1000.0 / thickness - 1e-6);
+}
+
+// Slice the mesh through the middle of the given layer to get its image
+bool PrintDataMesh::GetImageForLayer(int layer, Magick::Image* pImage)
+{
+    if (layer < 1 || layer > GetLayerCount())
+        return false;
+    
+    double thickness = _layerThickness / 1000.0;
+    
+    _slicer.Slice((layer - 0.5) * thickness, VIDEO_MODE_WIDTH, 
+                  VIDEO_MODE_HEIGHT, VIDEO_MODE_PIXEL_SIZE_MICRONS / 1000.0, 
+                  _pixels);
+    
+    pImage->read(VIDEO_MODE_WIDTH, VIDEO_MODE_HEIGHT, "I", Magick::CharPixel, 
+                 _pixels.data());
+    return true;
+}
@@ -0,0 +1,161 @@
+//  File:   PrintDataTarGz.cpp
+//  Handles data stored in a tar.gz file for the 3D model to be printed,
+//  reading its members in place through an index rather than extracting it
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdexcept>
+
+#include <Logger.h>
+#include <PrintDataTarGz.h>
+#include <Filenames.h>
+
+// Constructor
+// filePath is the path to the tar.gz file that backs this instance, whose 
+// index must already have been built.  Throws std::runtime_error if there is 
+// no usable index.
+PrintDataTarGz::PrintDataTarGz(const std::string& filePath) :
+_filePath(filePath),
+_index(filePath, GetIndexPath(filePath))
+{
+    if (!_index.Load())
+        throw std::runtime_error(filePath);
+}
+
+PrintDataTarGz::~PrintDataTarGz()
+{
+}
+
+// Get the path of the index file kept alongside the specified tar.gz file
+std::string PrintDataTarGz::GetIndexPath(const std::string& filePath)
+{
+    return filePath + PRINT_DATA_INDEX_EXTENSION;
+}
+
+// Gets the image for the given layer, inflating only its slice image
+bool PrintDataTarGz::GetImageForLayer(int layer, Magick::Image* pImage)
+{
+    std::string fileName = GetLayerFileName(layer);
+    try
+    {
+        std::string buffer;
+        if (!_index.ReadMember(fileName, buffer))
+            throw std::runtime_error(fileName);
+
+        Magick::Blob blob(buffer.data(), buffer.size()); 
+        pImage->read(blob);
+    }
+    catch(std::exception)
+    {
+        Logger::LogError(LOG_ERR, errno, LoadImageError, fileName.c_str());
+        return false;
+    }
+    
+    return true;
+}
+
+// Get the number of layers contained in the print data
+int PrintDataTarGz::GetLayerCount()
+{
+    int sliceCount = 0;
+    const TarMemberMap& members = _index.GetMembers();
+
+    for (TarMemberMap::const_iterator it = members.begin(); 
+                                      it != members.end(); it++)
+    {
+        size_t idx = it->first.rfind('.');
+        if  (idx != std::string::npos &&
+                it->first.substr(idx + 1) == SLICE_IMAGE_EXTENSION &&
+                it->first.substr(0, 6) == SLICE_IMAGE_PREFIX)
+        {
+            sliceCount++;
+        }
+    }
+
+    return sliceCount;
+}
+
+// If the print data contains the specified file, read contents into specified 
+// string and return true.  Otherwise, return false.
+bool PrintDataTarGz::GetFileContents(const std::string& fileName, 
+                                     std::string& contents)
+{
+    return _index.ReadMember(fileName, contents);
+}
+
+// Move the print data tar.gz file and its index into destination
+bool PrintDataTarGz::Move(const std::string& destination)
+{
+    // figure out the file name without directory
+    // this operation keeps the slash preceeding the file name
+    std::string fileName(_filePath);
+    fileName.erase(0, fileName.find_last_of("/"));
+    
+    std::string newFilePath = destination + fileName;
+    std::string indexPath = GetIndexPath(_filePath);
+    std::string newIndexPath = GetIndexPath(newFilePath);
+
+    if (rename(indexPath.c_str(), newIndexPath.c_str()) != 0)
+        return false;
+    
+    if (rename(_filePath.c_str(), newFilePath.c_str()) != 0)
+    {
+        // keep the index with the archive
+        rename(newIndexPath.c_str(), indexPath.c_str());
+        return false;
+    }
+
+    _filePath = newFilePath;
+    _index.SetPaths(newFilePath, newIndexPath);
+    return true;
+}
+
+// Remove the print data tar.gz file and its index
+bool PrintDataTarGz::Remove()
+{
+    bool indexRemoved = remove(GetIndexPath(_filePath).c_str()) == 0;
+    return (remove(_filePath.c_str()) == 0) && indexRemoved;
+}
+
+// Validate the print data
+bool PrintDataTarGz::Validate()
+{
+    int layerCount = GetLayerCount();
+
+    if (layerCount < 1)
+        return false;  // a valid print must contain at least one slice image
+
+    // check that the slice images are named/numbered as expected
+    for(int i = 1; i <= layerCount; i++)
+        if (!_index.Contains(GetLayerFileName(i)))
+            return false;
+
+    return true;
+}
+
+// Get the name of the image file for the given layer
+std::string PrintDataTarGz::GetLayerFileName(int layer)
+{
+    // formatted on the stack, the name is short enough not to need the heap
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%s%d.%s", SLICE_IMAGE_PREFIX, layer,
+             SLICE_IMAGE_EXTENSION);
+
+    return fileName;
+}
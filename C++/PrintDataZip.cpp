@@ -21,22 +21,65 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program; if not, see <http://www.gnu.org/licenses/>.
 
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sstream>
+#include <stdexcept>
 
 #include <Logger.h>
 #include <PrintDataZip.h>
 #include <Filenames.h>
+#include <MessageStrings.h>
+
+// size of the pieces in which a file is copied to local storage, small enough
+// that reading ahead never waits long behind copying
+constexpr size_t COPY_CHUNK_SIZE = 64 * 1024;
 
 // Constructor
 // filePath is the path to the zip file that backs this instance
-PrintDataZip::PrintDataZip(const std::string& filePath) :
+// ownsFile is false when printing directly from a file that must be left in 
+// place, such as one on a USB drive
+// readAheadLayers is the number of upcoming layers to cache in memory
+// copyPath, if given for a file that isn't owned, is where to copy the file 
+// while printing, so that printing can continue if its storage is removed
+PrintDataZip::PrintDataZip(const std::string& filePath, bool ownsFile,
+                           int readAheadLayers, const std::string& copyPath) :
 _filePath(filePath),
-_zipArchive(zppZipArchive(filePath, std::ios_base::in, false))
+_pZipArchive(new zppZipArchive(filePath, std::ios_base::in, false)),
+_ownsFile(ownsFile),
+_readAheadLayers(readAheadLayers),
+_copyPath(ownsFile ? "" : copyPath),
+_workerStarted(false),
+_nextReadAheadLayer(1),
+_lastReadAheadLayer(0),
+_copying(!_copyPath.empty()),
+_usingCopy(false),
+_stopWorker(false),
+_copySourceFd(-1),
+_copyDestinationFd(-1)
 {
 }
 
 PrintDataZip::~PrintDataZip()
 {
+    if (_workerStarted)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopWorker = true;
+        }
+        _workChanged.notify_all();
+        pthread_join(_worker, NULL);
+    }
+    
+    // the copy, finished or not, is of no use to anyone else
+    if (_copySourceFd >= 0)
+        close(_copySourceFd);
+    if (_copyDestinationFd >= 0)
+        close(_copyDestinationFd);
+    if (_copyDestinationFd >= 0 || _usingCopy)
+        remove(_copyPath.c_str());
 }
 
 // Gets the image for the given layer
@@ -45,17 +88,20 @@ bool PrintDataZip::GetImageForLayer(int layer, Magick::Image* pImage)
     std::string fileName = GetLayerFileName(layer);
     try
     {
-        // create a stream to access zip file contents
-        izppstream layerFile;
-
-        // assume the client previously validated the data and the specified layer 
-        // file opens successfully
-        layerFile.open(fileName, &_zipArchive);
-
-        // read file into buffer
-        std::stringstream ss;
-        ss << layerFile.rdbuf();
-        std::string buffer = ss.str();
+        std::string buffer;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            
+            // use the layer file if it was already read ahead
+            std::map<int, std::string>::iterator it = _layerCache.find(layer);
+            if (it != _layerCache.end())
+            {
+                buffer.swap(it->second);
+                _layerCache.erase(it);
+            }
+            else if (!ReadLayerFile(layer, buffer))
+                throw std::runtime_error(fileName);
+        }
 
         Magick::Blob blob(buffer.data(), buffer.size()); 
         pImage->read(blob);
@@ -69,11 +115,199 @@ bool PrintDataZip::GetImageForLayer(int layer, Magick::Image* pImage)
     return true;
 }
 
+// Have the worker thread read the files for up to the configured number of 
+// layers following the given one into memory, so that printing can ride out 
+// slow or briefly unresponsive storage, and copy the file to local storage if
+// requested.  Layers already printed are dropped from the cache.  Returns 
+// without waiting for any of the reads.
+void PrintDataZip::ReadAhead(int layer)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        _layerCache.erase(_layerCache.begin(), _layerCache.upper_bound(layer));
+        _nextReadAheadLayer = layer + 1;
+        _lastReadAheadLayer = layer + _readAheadLayers;
+        
+        if (!_workerStarted && (_readAheadLayers > 0 || _copying))
+            _workerStarted = pthread_create(&_worker, NULL, &InBackground, 
+                                            this) == 0;
+    }
+    _workChanged.notify_all();
+}
+
+// Wait until the worker thread has read ahead as far as it can and has 
+// finished or abandoned copying the file.
+void PrintDataZip::AwaitReadAhead()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workChanged.wait(lock, [this]
+    {
+        return !_workerStarted || (!HasReadAheadWork() && !_copying);
+    });
+}
+
+// Returns true unless the file is ours or has been copied to local storage.
+bool PrintDataZip::IsOnRemovableStorage()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_ownsFile && !_usingCopy;
+}
+
+// Returns true if there are upcoming layers still to be read ahead.  Must be
+// called with the mutex held.
+bool PrintDataZip::HasReadAheadWork()
+{
+    while (_nextReadAheadLayer <= _lastReadAheadLayer && 
+           _layerCache.count(_nextReadAheadLayer) > 0)
+        _nextReadAheadLayer++;
+    
+    return _nextReadAheadLayer <= _lastReadAheadLayer;
+}
+
+// Entry point of the worker thread, which reads ahead whenever there are 
+// layers to read, and otherwise copies the file a piece at a time.
+void* PrintDataZip::InBackground(void* context)
+{
+    PrintDataZip* pData = (PrintDataZip*)context;
+    std::unique_lock<std::mutex> lock(pData->_mutex);
+    
+    while (true)
+    {
+        pData->_workChanged.wait(lock, [pData]
+        {
+            return pData->_stopWorker || pData->HasReadAheadWork() || 
+                   pData->_copying;
+        });
+        
+        if (pData->_stopWorker)
+            break;
+        
+        if (pData->HasReadAheadWork())
+        {
+            int layer = pData->_nextReadAheadLayer++;
+            
+            // stop at the last layer, or if the storage has become unreadable
+            std::string contents;
+            if (pData->ReadLayerFile(layer, contents))
+                pData->_layerCache[layer].swap(contents);
+            else
+                pData->_nextReadAheadLayer = pData->_lastReadAheadLayer + 1;
+        }
+        else
+        {
+            // copying doesn't touch the archive, so don't hold up reading 
+            // while it's going on
+            lock.unlock();
+            pData->CopyNextChunk();
+            lock.lock();
+        }
+        
+        // let anyone waiting for the work to be done check on it
+        pData->_workChanged.notify_all();
+    }
+    
+    return NULL;
+}
+
+// Copy the next piece of the file to local storage.  Once the whole file has
+// been copied, read from the copy instead, so that printing no longer depends
+// on the removable storage.  Called only from the worker thread.
+void PrintDataZip::CopyNextChunk()
+{
+    if (_copyDestinationFd < 0)
+    {
+        _copySourceFd = open(_filePath.c_str(), O_RDONLY);
+        if (_copySourceFd >= 0)
+            _copyDestinationFd = open(_copyPath.c_str(), 
+                                      O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_copyDestinationFd < 0)
+        {
+            AbandonCopy();
+            return;
+        }
+    }
+    
+    char buffer[COPY_CHUNK_SIZE];
+    ssize_t bytesRead = read(_copySourceFd, buffer, sizeof(buffer));
+    if (bytesRead > 0)
+    {
+        for (ssize_t written = 0; written < bytesRead; )
+        {
+            ssize_t n = write(_copyDestinationFd, buffer + written, 
+                              bytesRead - written);
+            if (n < 0)
+            {
+                AbandonCopy();
+                return;
+            }
+            written += n;
+        }
+        return;
+    }
+    
+    // make sure the copy is complete and on disk before relying on it
+    zppZipArchive* pCopy = NULL;
+    if (bytesRead == 0 && fsync(_copyDestinationFd) == 0)
+    {
+        try
+        {
+            pCopy = new zppZipArchive(_copyPath, std::ios_base::in, false);
+        }
+        catch (const zppError& e)
+        {
+        }
+    }
+    
+    if (!pCopy)
+    {
+        AbandonCopy();
+        return;
+    }
+    
+    close(_copySourceFd);
+    _copySourceFd = -1;
+    close(_copyDestinationFd);
+    _copyDestinationFd = -1;
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pZipArchive.reset(pCopy);
+    _usingCopy = true;
+    _copying = false;
+    
+    char msg[255];
+    snprintf(msg, sizeof(msg), LOG_USING_PRINT_DATA_COPY, _copyPath.c_str());
+    Logger::LogMessage(LOG_INFO, msg);
+}
+
+// Give up on copying the file, removing any partial copy.  Printing carries 
+// on from the original file.  Called only from the worker thread.
+void PrintDataZip::AbandonCopy()
+{
+    Logger::LogError(LOG_WARNING, errno, CantCopyPrintData, 
+                     _copyPath.c_str());
+    
+    if (_copySourceFd >= 0)
+        close(_copySourceFd);
+    _copySourceFd = -1;
+    if (_copyDestinationFd >= 0)
+    {
+        close(_copyDestinationFd);
+        remove(_copyPath.c_str());
+    }
+    _copyDestinationFd = -1;
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    _copying = false;
+}
+
 // Get the number of layers contained in the print data
 int PrintDataZip::GetLayerCount()
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+    
     int sliceCount = 0;
-    const zppFileMap& fileMap = _zipArchive.getFileMap();
+    const zppFileMap& fileMap = _pZipArchive->getFileMap();
 
     for (zppFileMap::const_iterator it = fileMap.begin(); 
                                     it != fileMap.end(); it++)
@@ -95,11 +329,13 @@ int PrintDataZip::GetLayerCount()
 bool PrintDataZip::GetFileContents(const std::string& fileName, 
                                    std::string& contents)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+    
     // create a stream to access zip file contents
     izppstream settingsFile;
 
     // open the file
-    settingsFile.open(fileName.c_str(), &_zipArchive);
+    settingsFile.open(fileName.c_str(), _pZipArchive.get());
     if (settingsFile.good())
     {
         // update specified string with contents
@@ -131,9 +367,12 @@ bool PrintDataZip::Move(const std::string& destination)
     return false;
 }
 
-// Remove the print data zip file
+// Remove the print data zip file, unless it belongs to someone else
 bool PrintDataZip::Remove()
 {
+    if (!_ownsFile)
+        return true;
+    
     return remove(_filePath.c_str()) == 0;
 }
 
@@ -145,13 +384,15 @@ bool PrintDataZip::Validate()
     if (layerCount < 1)
         return false;  // a valid print must contain at least one slice image
 
+    std::lock_guard<std::mutex> lock(_mutex);
+    
     // create a stream to access zip file contents
     izppstream layerFile;
     
     // check that the slice images are named/numbered as expected
     for(int i = 1; i <= layerCount; i++)
     {
-        layerFile.open(GetLayerFileName(i), &_zipArchive);
+        layerFile.open(GetLayerFileName(i), _pZipArchive.get());
         if (!layerFile.good())
             return false;
         layerFile.close();
@@ -163,11 +404,42 @@ bool PrintDataZip::Validate()
 // Get the name of the image file for the given layer
 std::string PrintDataZip::GetLayerFileName(int layer)
 {
-    std::ostringstream fileName;
+    // formatted on the stack, the name is short enough not to need the heap
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%s%d.%s", SLICE_IMAGE_PREFIX, layer,
+             SLICE_IMAGE_EXTENSION);
+
+    return fileName;
+}
 
-    fileName << SLICE_IMAGE_PREFIX << layer << "." << SLICE_IMAGE_EXTENSION;
+// Read the contents of the image file for the given layer from the zip file.
+// Returns false if the file can't be read.  Must be called with the mutex 
+// held.
+bool PrintDataZip::ReadLayerFile(int layer, std::string& contents)
+{
+    try
+    {
+        // create a stream to access zip file contents
+        izppstream layerFile;
+        
+        layerFile.open(GetLayerFileName(layer), _pZipArchive.get());
+        if (!layerFile.good())
+            return false;
 
-    return fileName.str();
+        // read file into buffer
+        std::stringstream ss;
+        ss << layerFile.rdbuf();
+        if (layerFile.bad())
+            return false;
+        
+        contents = ss.str();
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    
+    return true;
 }
 
 // Initialize zpp library settings
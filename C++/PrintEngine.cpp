@@ -28,10 +28,13 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/syscall.h>
+#include <limits.h>
+#include <string.h>
 
 #include <Hardware.h>
 #include <PrintEngine.h>
@@ -44,19 +47,26 @@
 #include <MessageStrings.h>
 #include <MotorController.h>
 #include <Projector.h>
+#include <Metrics.h>
+#include <LayerArena.h>
 
 #include "PrinterStatusQueue.h"
 #include "Timer.h"
 #include "PrintFileStorage.h"
+#include "PrintDataLoader.h"
 
 constexpr double VIDEOFRAME__SEC        = 1.0 / 60.0;
+// time allowed beyond an exposure timed by the projector for it to wait for 
+// the first video frame and round to a whole number of them 
+constexpr double TIMED_EXPOSURE_MARGIN_SEC = 2 * VIDEOFRAME__SEC;
 constexpr double MILLIDEGREES_PER_REV   = 360000.0;
 
 
 // The only public constructor.  'haveHardware' can only be false in debug
 // builds, for test purposes only.
 PrintEngine::PrintEngine(bool haveHardware, Motor& motor, Projector& projector,
-        PrinterStatusQueue& printerStatusQueue, const Timer& exposureTimer,
+        PrinterStatusQueue& printerStatusQueue, 
+        PrintDataLoader& printDataLoader, const Timer& exposureTimer,
         const Timer& temperatureTimer, const Timer& delayTimer,
         const Timer& motorTimeoutTimer) :
 _haveHardware(haveHardware),
@@ -68,8 +78,18 @@ _alreadyOverheated(false),
 _inspectionRequested(false),
 _skipCalibration(false),
 _remainingMotorTimeoutSec(0.0),
+_zAtHome(false),
+_rotationAtHome(false),
+_zHomePending(false),
+_rotationHomePending(false),
+_rotationTracked(false),
+_approachQueued(false),
+_queuedApproachTag(0),
+_exposureTimerMarginSec(0.0),
+_printDataOnUSBDrive(false),
 _demoModeRequested(false),
 _printerStatusQueue(printerStatusQueue),
+_printDataLoader(printDataLoader),
 _exposureTimer(exposureTimer),
 _temperatureTimer(temperatureTimer),
 _delayTimer(delayTimer),
@@ -77,7 +97,19 @@ _motorTimeoutTimer(motorTimeoutTimer),
 _projector(projector),
 _motor(motor),
 _bgndThread(0),
-_settings(PrinterSettings::Instance())
+_settings(PrinterSettings::Instance()),
+_layerCycleTime(Metrics::Instance().GetHistogram(LAYER_CYCLE_METRIC,
+        "Time from the start of one layer to the start of the next",
+        {5.0, 10.0, 15.0, 20.0, 30.0, 45.0, 60.0, 90.0, 120.0, 300.0})),
+_imagePrepTime(Metrics::Instance().GetHistogram(IMAGE_PREP_METRIC,
+        "Time taken to load and process a layer image in the background",
+        {0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 5.0})),
+_temperatureGauge(Metrics::Instance().GetGauge(TEMPERATURE_METRIC,
+        "Most recent temperature reading")),
+_jams(Metrics::Instance().GetCounter(JAMS_METRIC,
+        "Number of jams detected during separation")),
+_layerStartTime(0.0),
+_deferringWork(false)
 {
 #ifndef DEBUG
     if (!haveHardware)
@@ -92,11 +124,16 @@ _settings(PrinterSettings::Instance())
 
     _invertDoorSwitch = (_settings.GetInt(HARDWARE_REV) == 0);
     
+    // no layer's lit area has been measured yet
+    _threadData.litFraction = -1.0;
+    
     _pThermometer = new Thermometer(haveHardware);
     
     // create a PrintData instance if previously loaded print data exists
     _pPrintData.reset(PrintData::CreateFromExistingData(
         _settings.GetString(PRINT_DATA_DIR) + "/" + PRINT_DATA_NAME));
+    if (_pPrintData)
+        _pPrintData->SetLayerThickness(_settings.GetInt(LAYER_THICKNESS));
 }
 
 // Destructor
@@ -149,7 +186,18 @@ void PrintEngine::SendStatus(PrintEngineState state, StateChange change,
     _printerStatus._change = change;
     _printerStatus._temperature = _temperature;
 
-    _printerStatusQueue.Push(_printerStatus);
+    if (_deferringWork)
+    {
+        // status updates are only for the UIs and logging, so while we're 
+        // about to expose a layer, hold them till the exposure has started
+        PrinterStatus printerStatus = _printerStatus;
+        _deferredWork.push_back([this, printerStatus]()
+        {
+            _printerStatusQueue.Push(printerStatus);
+        });
+    }
+    else
+        _printerStatusQueue.Push(_printerStatus);
 }
 
 // Return the most recently set UI sub-state
@@ -205,6 +253,7 @@ void PrintEngine::Callback(EventType eventType, const EventData& data)
             {
                 // read and record temperature
                 _temperature = _pThermometer->GetTemperature();
+                _temperatureGauge.Set(_temperature);
    
                 if (!_alreadyOverheated)
                     IsPrinterTooHot();
@@ -218,6 +267,10 @@ void PrintEngine::Callback(EventType eventType, const EventData& data)
             USBDriveConnectedCallback(data.Get<std::string>());
             break;
 
+        case PrintDataLoad:
+            PrintDataLoadCallback(data.Get<PrintDataLoadStatus>());
+            break;
+
         case USBDriveDisconnected:
             USBDriveDisconnectedCallback();
             break;
@@ -226,6 +279,9 @@ void PrintEngine::Callback(EventType eventType, const EventData& data)
             Logger::LogError(LOG_WARNING, errno, UnexpectedEvent, eventType);
             break;
     }
+    
+    // never hold deferred work past the handling of the event that caused it
+    RunDeferredWork();
 }
 
 // Handle commands that have already been interpreted
@@ -240,8 +296,11 @@ void PrintEngine::Handle(Command command)
             break;
             
         case Cancel:
-            // cancel any print in progress
-            _pPrinterStateMachine->process_event(EvCancel());
+            // cancel any print data load or print in progress
+            if (_printDataLoader.IsLoading())
+                _printDataLoader.Cancel();
+            else
+                _pPrinterStateMachine->process_event(EvCancel());
             break;
             
         case Pause:
@@ -292,6 +351,7 @@ void PrintEngine::Handle(Command command)
         case RefreshSettings:
             // reload the settings file
             _settings.Refresh();
+            BuildDoseTable();
             LogStatusAndSettings(); //for the record
             break;
             
@@ -301,6 +361,7 @@ void PrintEngine::Handle(Command command)
             remove(TEMP_SETTINGS_FILE);
             if (!result)
                 HandleError(CantLoadSettingsFile, true, TEMP_SETTINGS_FILE);
+            BuildDoseTable();
             break;
             
         case ShowPrintDataDownloading:
@@ -319,6 +380,12 @@ void PrintEngine::Handle(Command command)
             ProcessData();
             break;
             
+        case AdoptPrintData:
+        case SetSetting:
+            // these require an argument
+            HandleError(MissingCommandArgument, false, NULL, command);
+            break;
+            
         case ShowPrintDataLoaded:
             ShowScreenFor(LoadedPrintData);
             break;
@@ -390,6 +457,53 @@ void PrintEngine::Handle(Command command)
             HandleError(UnknownCommandInput, false, NULL, command); 
             break;
     }
+    
+    // never hold deferred work past the handling of the command that caused it
+    RunDeferredWork();
+}
+
+// Handle commands that may carry an argument
+void PrintEngine::Handle(Command command, const std::string& argument)
+{
+    switch(command)
+    {
+        case AdoptPrintData:
+            if (argument.empty())
+                HandleError(MissingCommandArgument, false, NULL, command);
+            else
+                AdoptData(argument);
+            break;
+            
+        case ApplySettings:
+            // settings given inline rather than in a file
+            if (argument.empty())
+            {
+                Handle(command);
+                return;
+            }
+            if (!_settings.SetFromJSONString(argument))
+                HandleError(CantLoadSettingsFile, true, "(inline)");
+            BuildDoseTable();
+            break;
+            
+        case SetSetting:
+            if (argument.empty())
+                HandleError(MissingCommandArgument, false, NULL, command);
+            else
+            {
+                SetSettingFromText(argument);
+                BuildDoseTable();
+            }
+            break;
+            
+        default:
+            // commands that don't use an argument ignore it
+            Handle(command);
+            return;
+    }
+    
+    // never hold deferred work past the handling of the command that caused it
+    RunDeferredWork();
 }
 
 // Converts button events from UI board into state machine events
@@ -470,8 +584,12 @@ void PrintEngine::ClearDelayTimer()
 // Get the pre exposure delay time for the current layer
 double PrintEngine::GetPreExposureDelayTimeSec()
 {    
+    int delayMS = _cls.ApproachWaitMS;
+    if (_settings.GetInt(ADAPTIVE_DELAYS))
+        delayMS = GetAdaptiveDelayMS(delayMS, MIN_APPROACH_WAIT, "approach");
+    
     // settings are in milliseconds
-    return _cls.ApproachWaitMS / 1000.0;
+    return delayMS / 1000.0;
 }
 
 // Determines if any delay is needed before exposure.
@@ -511,14 +629,69 @@ double PrintEngine::GetExposureTimeSec()
 {
     double expTime = _cls.ExposureSec;
 
-    // actual exposure time includes an extra video frame, 
-    // so reduce the requested time accordingly
-    if (expTime > VIDEOFRAME__SEC)
+    // actual exposure time includes an extra video frame when it's timed by
+    // the exposure timer, so reduce the requested time accordingly
+    if (!ProjectorTimesExposure(expTime) && expTime > VIDEOFRAME__SEC)
         expTime -= VIDEOFRAME__SEC;
     
     return expTime;
 }
 
+// Returns true if the projector should time an exposure of the given length
+// itself, rather than having it timed by the exposure timer.
+bool PrintEngine::ProjectorTimesExposure(double seconds)
+{
+    return _settings.GetInt(PROJ_TIMED_EXPOSURE) != 0 && 
+           _projector.CanTimeExposure(seconds);
+}
+
+// Show the current layer for the given exposure time, and start the timer 
+// whose expiration signals the end of exposure.  When the projector times the
+// exposure, the timer only needs to expire after it's done.
+void PrintEngine::StartExposure(double seconds)
+{
+    if (!ProjectorTimesExposure(seconds))
+    {
+        ShowImage();
+        _exposureTimerMarginSec = 0.0;
+        StartExposureTimer(seconds);
+        return;
+    }
+    
+    try
+    {
+        if (!_projector.StartTimedExposure(seconds))
+        {
+            HandleError(CantShowImage, true, NULL, 
+                        _printerStatus._currentLayer);
+            return;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        HandleError(CantShowImage, true, NULL, _printerStatus._currentLayer);
+        return;
+    }
+    
+    _exposureTimerMarginSec = TIMED_EXPOSURE_MARGIN_SEC;
+    StartExposureTimer(seconds + TIMED_EXPOSURE_MARGIN_SEC);
+}
+
+// Program the projector's pattern sequencer for the next layer's exposure, if
+// it will time it, while the tray is moving rather than when the exposure is
+// about to start.  If the exposure time then turns out to be different (e.g. 
+// from a change in temperature), the sequence is reprogrammed at that point. 
+void PrintEngine::PrepareNextExposure()
+{
+    if (!MoreLayers())
+        return;
+    
+    int next = _printerStatus._currentLayer + 1;
+    double seconds = GetLayerExposureSec(next, GetLayerType(next));
+    if (ProjectorTimesExposure(seconds))
+        _projector.PrepareTimedExposure(seconds);
+}
+
 // Returns true if and only if the current layer is the first one
 bool PrintEngine::IsFirstLayer()
 {
@@ -584,6 +757,8 @@ void PrintEngine::SetNumLayers(int numLayers)
     // the number of layers should only be set before starting a print,
     // or when clearing it at the end or canceling of a print
     _printerStatus._currentLayer = 0;
+    _layerStartTime = 0.0;
+    _settlingEstimator.Reset();
 }
 
 // Increment the current layer number, get any layer-specific settings, 
@@ -592,6 +767,19 @@ void PrintEngine::NextLayer()
 {
     bool retVal = false;
     
+    // record the time taken by the previous layer, if any
+    double now = GetSeconds();
+    if (_layerStartTime > 0.0)
+        _layerCycleTime.Observe(now - _layerStartTime);
+    _layerStartTime = now;
+    
+    // report and rewind the arena holding the previous layer's transient
+    // allocations
+    LayerArena::Instance().Reset();
+    
+    if (_printerStatus._currentLayer > 0)
+        _settlingEstimator.LayerCompleted();
+    
     ++_printerStatus._currentLayer;  
     SetEstimatedPrintTime();
     
@@ -608,7 +796,11 @@ void PrintEngine::NextLayer()
     {
         char msg[100];
         sprintf(msg, LOG_TEMPERATURE_PRINTING, layer, total, _temperature);
-        Logger::LogMessage(LOG_INFO, msg); 
+        std::string message(msg);
+        DeferWork([message]() 
+        { 
+            Logger::LogMessage(LOG_INFO, message.c_str()); 
+        });
     }
 }
 
@@ -650,6 +842,9 @@ bool PrintEngine::LoadNextLayerImage()
         _threadData.usePatternMode = true;
     }     
     _threadData.imageProcessor = &_imageProcessor;
+    _threadData.prepTimeSec = 0.0;
+    _threadData.measureLitArea = _settings.GetInt(ADAPTIVE_DELAYS) != 0;
+    _threadData.litFraction = _threadData.measureLitArea ? -1.0 : 1.0;
 
     _threadError = Success;
     _threadErrorMsg = NULL;
@@ -661,13 +856,29 @@ bool PrintEngine::LoadNextLayerImage()
     return true;
 }
 
+// Wait for the background thread to finish processing the next layer's image
+// without yet handling any error from it, which is left to the next call of
+// AwaitEndOfBackgroundThread.  Returns true if the thread was running.
+bool PrintEngine::AwaitCompletion()
+{
+    if (_bgndThread == 0)
+        return false;
+    
+    AwaitEndOfBackgroundThread(true);
+    return _bgndThread == 0;
+}
+
 // Wait for completion of any processing in background thread.
 bool PrintEngine::AwaitEndOfBackgroundThread(bool ignoreErrors)
 {
     if (_bgndThread != 0)
     {
         if (pthread_join(_bgndThread, NULL) == 0)
+        {
             _bgndThread = 0;
+            if (_threadError == Success)
+                _imagePrepTime.Observe(_threadData.prepTimeSec);
+        }
         else if (_threadError == Success)
             _threadError = CantJoinIPThread;
     }
@@ -692,15 +903,19 @@ void PrintEngine::SetEstimatedPrintTime()
     int layersLeft = _printerStatus._numLayers - 
                     (_printerStatus._currentLayer - 1);
 
+    // the exposures of the remaining layers, including any ramp between 
+    // types of layer, come from the dose table when it holds them
+    bool useDoseTable = _doseTable.Contains(_printerStatus._currentLayer);
+
     double burnInLayers = _settings.GetInt(BURN_IN_LAYERS);
-    double burnInTime = GetLayerTimeSec(BurnIn);
-    double modelTime = GetLayerTimeSec(Model);
+    double burnInTime = GetLayerTimeSec(BurnIn, !useDoseTable);
+    double modelTime = GetLayerTimeSec(Model, !useDoseTable);
     double layerTimes = 0.0;
 
     // remaining time depends first on what kind of layer we're in
     if (IsFirstLayer())
     {
-        layerTimes = GetLayerTimeSec(First) +
+        layerTimes = GetLayerTimeSec(First, !useDoseTable) +
                      burnInLayers * burnInTime + 
                      (_printerStatus._numLayers - (burnInLayers + 1)) * 
                                                                     modelTime;
@@ -720,6 +935,11 @@ void PrintEngine::SetEstimatedPrintTime()
         // all the remaining layers are model layers
         layerTimes = layersLeft * modelTime;
     }
+    
+    if (useDoseTable)
+        layerTimes += _doseTable.GetTotalExposureSec(
+                                            _printerStatus._currentLayer) *
+                      DoseTable::GetTemperatureScale(_temperature, _settings);
 
     _printerStatus._estimatedSecondsRemaining = (int)(layerTimes + 0.5);
 }
@@ -734,6 +954,33 @@ void PrintEngine::MotorCallback(unsigned char status)
     switch(status)
     {        
         case MC_STATUS_SUCCESS:
+            // once the separation it was queued behind has completed, the 
+            // next completion must be that of the queued approach
+            if (_queuedApproachTag != 0 && !_approachQueued)
+            {
+                int expectedTag = _queuedApproachTag;
+                _queuedApproachTag = 0;
+                
+                int lastCompletedTag, freeSlots;
+                if (!_motor.ReadQueueStatus(lastCompletedTag, freeSlots))
+                {
+                    HandleError(MotorError, true);
+                    _pPrinterStateMachine->MotionCompleted(false);
+                    break;
+                }
+                if (lastCompletedTag != expectedTag)
+                {
+                    HandleError(UnexpectedSequenceCompleted, true, NULL, 
+                                                            lastCompletedTag);
+                    _pPrinterStateMachine->MotionCompleted(false);
+                    break;
+                }
+            }
+            // any homing in the motion is now confirmed
+            _zAtHome = _zHomePending;
+            _rotationAtHome = _rotationHomePending;
+            _zHomePending = false;
+            _rotationHomePending = false;
             _pPrinterStateMachine->MotionCompleted(true);
             break;
             
@@ -752,7 +999,12 @@ void PrintEngine::DoorCallback(char data)
     if (data == (_invertDoorSwitch ? '1' : '0'))
         _pPrinterStateMachine->process_event(EvDoorClosed());
     else
+    {
+        // the tray may be turned by hand while the door is open
+        _rotationAtHome = false;
+        _rotationTracked = false;
         _pPrinterStateMachine->process_event(EvDoorOpened());
+    }
 }
      
 // Handles errors with message and optional parameters.
@@ -778,6 +1030,10 @@ bool PrintEngine::HandleError(ErrorCode code, bool fatal,
     // Report fatal errors and put the state machine in the Error state 
     if (fatal) 
     {
+        // the motors may not have finished moving
+        ForgetMotorPositions();
+        _approachQueued = false;
+        _queuedApproachTag = 0;
          // set the error into printer status
         _printerStatus._errorCode = code;
         _printerStatus._errno = origErrno;
@@ -793,6 +1049,27 @@ bool PrintEngine::HandleError(ErrorCode code, bool fatal,
     return false;
 }
 
+// Returns true if the printer is set to skip redundant homing and both axes
+// are known to be at their home positions.  The lead screw holds the Z axis
+// in place even when the motors are disabled or the motor controller reset,
+// so only motion that doesn't complete, or opening the door, loses track.
+bool PrintEngine::MotorsAtHome()
+{
+    return _settings.GetInt(SKIP_REDUNDANT_HOMING) != 0 && 
+           _zAtHome && _rotationAtHome;
+}
+
+// Stop trusting the tracked positions of the motors, so that they will be 
+// homed before they're next used.
+void PrintEngine::ForgetMotorPositions()
+{
+    _zAtHome = false;
+    _rotationAtHome = false;
+    _zHomePending = false;
+    _rotationHomePending = false;
+    _rotationTracked = false;
+}
+
 // log firmware version, current print status, & current settings
 void PrintEngine::LogStatusAndSettings()
 {
@@ -821,21 +1098,37 @@ void PrintEngine::ClearError()
 void PrintEngine::SendMotorCommand(HighLevelMotorCommand command)
 {
     bool success = true;
+    bool homeFirst = !MotorsAtHome();
+    
+    // any motion leaves home, until a homing motion is seen to complete
+    _zAtHome = false;
+    _rotationAtHome = false;
+    _zHomePending = false;
+    _rotationHomePending = false;
         
     switch(command)
     {
         case GoHome:
             success = _motor.GoHome();
+            _zHomePending = true;
+            _rotationHomePending = true;
+            _rotationTracked = true;
             StartMotorTimeoutTimer(GetHomingTimeoutSec());
             break;
             
         case GoHomeWithoutRotateHome:
             success = _motor.GoHome(true, false);
+            _zHomePending = true;
+            _rotationHomePending = _rotationTracked;
             StartMotorTimeoutTimer(GetHomingTimeoutSec());
             break;
             
         case MoveToStartPosition: 
-            success = _motor.GoToStartPosition();
+            if (!homeFirst)
+                Logger::LogMessage(LOG_INFO, LOG_SKIPPING_HOMING);
+            else
+                _rotationTracked = true;
+            success = _motor.GoToStartPosition(homeFirst);
             // for tracking where we are, to enable lifting for inspection
             _currentZPosition = 0;
             StartMotorTimeoutTimer(GetStartPositionTimeoutSec());
@@ -843,16 +1136,27 @@ void PrintEngine::SendMotorCommand(HighLevelMotorCommand command)
             
         case Separate:
             success = _motor.Separate(_cls);
+            // avoid waiting for the separation to complete before sending the
+            // approach, when possible
+            if (success && CanQueueApproach())
+                _approachQueued = _motor.QueueApproach(_cls, 
+                                                       _queuedApproachTag);
             StartMotorTimeoutTimer(GetSeparationTimeoutSec());
+            if (success)
+                PrepareNextExposure();
             break;
                         
         case Approach:
-            success = _motor.Approach(_cls);
+            if (_approachQueued)
+                _approachQueued = false;   // already on its way
+            else
+                success = _motor.Approach(_cls);
             _currentZPosition += _cls.LayerThicknessMicrons;
             StartMotorTimeoutTimer(GetApproachTimeoutSec());
             break;
             
         case ApproachAfterJam:
+            _rotationTracked = false;
             success = _motor.Approach(_cls, true);
             _currentZPosition += _cls.LayerThicknessMicrons;
             StartMotorTimeoutTimer(GetApproachTimeoutSec() +
@@ -880,6 +1184,7 @@ void PrintEngine::SendMotorCommand(HighLevelMotorCommand command)
             break;
             
         case RecoverFromJam:
+            _rotationTracked = false;
             success = _motor.UnJam(_cls);
             StartMotorTimeoutTimer(GetUnjammingTimeoutSec());
             break;
@@ -911,6 +1216,7 @@ void PrintEngine::ClearCurrentPrint(bool withInterrupt)
     ClearDelayTimer();
     ClearExposureTimer();
     Exposing::ClearPendingExposureInfo();
+    _doseTable.Clear();
     _printerStatus._estimatedSecondsRemaining = 0;
     // clear pause & inspect flags
     _inspectionRequested = false;
@@ -926,12 +1232,14 @@ void PrintEngine::ClearJobID()
     GetUUID(_printerStatus._localJobUniqueID); 
 }
 
-// Find the remaining exposure time 
+// Find the remaining exposure time, excluding any time the exposure timer 
+// runs beyond an exposure timed by the projector
 double PrintEngine::GetRemainingExposureTimeSec()
 {
     try
     {
-        return _exposureTimer.GetRemainingTimeSeconds();
+        return std::max(0.0, _exposureTimer.GetRemainingTimeSeconds() - 
+                             _exposureTimerMarginSec);
     }
     catch (const std::runtime_error& e)
     {
@@ -1004,6 +1312,18 @@ bool PrintEngine::TryStartPrint()
     ClearError();            
     _skipCalibration = false;
             
+    // don't print data that's about to be replaced
+    if (_printDataLoader.IsLoading())
+    {
+        HandleError(PrintDataLoadInProgress);
+        return false;
+    }
+    
+    // slice with the layer thickness as it is now, which may have changed
+    // since the data was loaded
+    if (_pPrintData)
+        _pPrintData->SetLayerThickness(_settings.GetInt(LAYER_THICKNESS));
+    
     // make sure we have valid data
     if (!_pPrintData || !_pPrintData->Validate())
     {
@@ -1029,6 +1349,10 @@ bool PrintEngine::TryStartPrint()
     if (_pPrintData->GetFileContents(PER_LAYER_SETTINGS_FILE, perLayerSettings))
         _perLayer.Load(perLayerSettings);
     
+    // look up or ramp the exposure time of every layer now, rather than 
+    // between layers
+    BuildDoseTable();
+    
     // make sure the temperature isn't too high to print
     if (IsPrinterTooHot())
         return false;
@@ -1105,7 +1429,29 @@ void PrintEngine::USBDriveConnectedCallback(const std::string& deviceNode)
 // drive event.
 void PrintEngine::USBDriveDisconnectedCallback()
 {
-    umount(USB_DRIVE_MOUNT_POINT);
+    // print data that's already been copied off the drive is now read from 
+    // the copy, so only the rest is affected
+    if (_printDataOnUSBDrive && 
+        (!_pPrintData || _pPrintData->IsOnRemovableStorage()))
+    {
+        if (PrintIsInProgress())
+        {
+            // keep going with the layers already read ahead, for as long as 
+            // they last
+            HandleError(USBDriveRemovedWhilePrinting);
+        }
+        else
+        {
+            // the print data left with the drive
+            ClearPrintData();
+            if (_printerStatus._state == HomeState && 
+                _printerStatus._UISubState == HavePrintData)
+                ShowScreenFor(NoPrintData);
+        }
+    }
+    
+    // detach lazily, in case the print data is still open
+    umount2(USB_DRIVE_MOUNT_POINT, MNT_DETACH);
 
     if (_printerStatus._state == HomeState && (
             _printerStatus._UISubState == USBDriveFileFound ||
@@ -1130,40 +1476,182 @@ void PrintEngine::LoadPrintFileFromUSBDrive()
 
     PrintFileStorage storage(path.str());
 
-    Copy(storage.GetFilePath(), _settings.GetString(DOWNLOAD_DIR));
+    // a zip file can be printed where it is, sparing a copy of the whole file
+    ProcessData(storage.GetFilePath(), 
+                _settings.GetInt(DIRECT_USB_PRINT) && storage.HasZip());
+}
 
-    ProcessData();
+// Returns true if print data is being loaded in the background.
+bool PrintEngine::IsLoadingPrintData()
+{
+    return _printDataLoader.IsLoading();
 }
 
-// Prepare downloaded print data for printing.
-// Looks for print file in specified directory.
-void PrintEngine::ProcessData()
+// Start preparing downloaded print data for printing.
+// Looks for print file in specified directory, after first copying it there 
+// from sourcePath if one is specified (or moving it there under adoptedName 
+// if that's specified), or if direct is true, uses the zip file specified by 
+// sourcePath in place.  Staging, extraction, and validation happen on a 
+// worker thread so that the event loop stays responsive, with 
+// FinishProcessingData completing the job when the worker is done.
+void PrintEngine::ProcessData(const std::string& sourcePath, bool direct,
+                              const std::string& adoptedName)
 {
-    PrintFileStorage storage(_settings.GetString(DOWNLOAD_DIR));
+    if (_printDataLoader.IsLoading())
+    {
+        // an adopted file is ours to dispose of, even though it's not loaded
+        if (!adoptedName.empty())
+            remove(sourcePath.c_str());
+        HandleError(PrintDataLoadInProgress);
+        return;
+    }
     
-    // If any processing step fails, clear downloading screen, report an error,
-    // and return to prevent any further processing
+    _printerStatus._loadProgress = 0;
+    
+    bool started = direct ? 
+        _printDataLoader.StartDirect(sourcePath, 
+                                     _settings.GetInt(USB_READ_AHEAD_LAYERS),
+                                     _settings.GetString(STAGING_DIR) + "/" + 
+                                     USB_PRINT_DATA_COPY_NAME) :
+        _printDataLoader.Start(sourcePath, _settings.GetString(DOWNLOAD_DIR),
+                               _settings.GetString(STAGING_DIR), 
+                               PRINT_DATA_NAME, 
+                               _settings.GetInt(LAYER_THICKNESS), adoptedName);
+    if (!started)
+    {
+        if (!adoptedName.empty())
+            remove(sourcePath.c_str());
+        HandleProcessDataFailed(CantStartLoadThread, "");
+    }
+}
+
+// Set the single setting named at the start of the argument to the value 
+// given by the rest of it.  A value may contain whitespace, but an empty one 
+// is only accepted for string settings.  The change isn't saved here, but it
+// will be by the next Save() of any other setting, e.g. on loading print data.
+void PrintEngine::SetSettingFromText(const std::string& argument)
+{
+    std::string key = argument;
+    std::string value;
+    
+    std::string::size_type p = argument.find_first_of(" \t");
+    if (p != std::string::npos)
+    {
+        key = argument.substr(0, p);
+        std::string::size_type start = argument.find_first_not_of(" \t", p);
+        if (start != std::string::npos)
+            value = argument.substr(start);
+    }
+    
+    _settings.SetFromText(key, value);
+}
 
-    // construct an instance of a PrintData object using a file from the 
-    // download directory
-    boost::scoped_ptr<PrintData> pNewPrintData(PrintData::CreateFromNewData(
-            storage, _settings.GetString(STAGING_DIR),
-            PRINT_DATA_NAME));
+// Returns true if the given path names a regular file directly in the 
+// directory through which the web server hands over print files.
+static bool IsHandedOver(const std::string& path)
+{
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    std::string::size_type p = path.find_last_of("/");
+    std::string dir = (p == std::string::npos) ? "." : 
+                      (p == 0 ? "/" : path.substr(0, p));
+    
+    char resolvedDir[PATH_MAX];
+    char resolvedHandoffDir[PATH_MAX];
+    if (realpath(dir.c_str(), resolvedDir) == NULL ||
+        realpath(GetFilePath(PRINT_FILE_HANDOFF_DIR).c_str(), 
+                 resolvedHandoffDir) == NULL)
+        return false;
+    
+    return strcmp(resolvedDir, resolvedHandoffDir) == 0;
+}
 
-    if (!pNewPrintData)
+// Start preparing print data handed over by the web server, e.g. an uploaded
+// file, without first copying it.  The argument gives the path to the file 
+// (which must not contain whitespace) optionally followed by the name under 
+// which it should be loaded, by default its current name.  The file then 
+// belongs to us and will be moved or removed.
+void PrintEngine::AdoptData(const std::string& argument)
+{
+    std::string sourcePath = argument;
+    std::string name;
+    
+    std::string::size_type p = argument.find_first_of(" \t");
+    if (p != std::string::npos)
     {
-        // no incoming print file found
-        HandleProcessDataFailed(CantStageIncomingPrintData, "");
+        sourcePath = argument.substr(0, p);
+        std::string::size_type start = argument.find_first_not_of(" \t", p);
+        if (start != std::string::npos)
+            name = argument.substr(start);
+    }
+    
+    // anyone can write to the command pipe, so only take over files that the
+    // web server has put in the hand-off directory
+    if (!IsHandedOver(sourcePath))
+    {
+        HandleError(PrintDataNotHandedOver, false, sourcePath.c_str());
         return;
     }
     
-    if (!pNewPrintData->Validate())
+    // don't let the name take the file out of the download directory
+    if (name.empty() || name.find('/') != std::string::npos)
+        name = sourcePath.substr(sourcePath.find_last_of("/") + 1);
+    
+    ProcessData(sourcePath, false, name);
+}
+
+// Report the progress of print data loading, or finish processing the print 
+// data once the worker thread is done.
+void PrintEngine::PrintDataLoadCallback(const PrintDataLoadStatus& status)
+{
+    if (status.finished)
     {
-        // invalid print data
-        HandleProcessDataFailed(InvalidPrintData, storage.GetFileName());
+        FinishProcessingData();
         return;
     }
     
+    if (status.percent < _printerStatus._loadProgress + 
+                                                    LOAD_PROGRESS_STATUS_STEP)
+        return;
+    
+    _printerStatus._loadProgress = status.percent;
+    
+    // only update the loading screen if it's still showing
+    if (_printerStatus._state == HomeState && 
+        _printerStatus._UISubState == LoadingPrintData)
+        SendStatus(HomeState, NoChange, LoadingPrintData);
+}
+
+// Apply the settings for, and switch over to, print data that the worker 
+// thread has staged and validated.
+void PrintEngine::FinishProcessingData()
+{
+    std::string fileName = _printDataLoader.GetFileName();
+    
+    if (_printDataLoader.WasCanceled())
+    {
+        Logger::LogMessage(LOG_INFO, LOG_PRINT_DATA_LOAD_CANCELED);
+        remove(TEMP_SETTINGS_FILE);
+        _printerStatus._loadProgress = 0;
+        ShowScreenFor(HasAtLeastOneLayer() ? HavePrintData : NoPrintData);
+        return;
+    }
+    
+    // If any processing step fails, clear downloading screen, report an error,
+    // and return to prevent any further processing
+    
+    if (_printDataLoader.GetResult() != Success)
+    {
+        // no incoming print file found, or invalid print data
+        HandleProcessDataFailed(_printDataLoader.GetResult(), fileName);
+        return;
+    }
+
+    boost::scoped_ptr<PrintData> pNewPrintData(
+                                        _printDataLoader.ReleasePrintData());
+    
     // first restore all print settings to their defaults, in case the new
     // settings don't include all possible settings (e.g. because the print data
     // file was created before some newer settings were defined)
@@ -1180,10 +1668,10 @@ void PrintEngine::ProcessData()
         settingsLoaded = _settings.SetFromFile(TEMP_SETTINGS_FILE);
     else
     {
-        // use settings from file contained in print data
+        // use settings from file contained in print data, as already read
+        // by the worker thread
         std::string settings;
-        if (pNewPrintData->GetFileContents(EMBEDDED_PRINT_SETTINGS_FILE, 
-                                                                    settings))
+        if (_printDataLoader.GetEmbeddedSettings(settings))
             settingsLoaded = _settings.SetFromJSONString(settings);
     }
 
@@ -1193,8 +1681,7 @@ void PrintEngine::ProcessData()
     
     if (!settingsLoaded)
     {
-        HandleProcessDataFailed(CantLoadSettingsForPrintData, 
-                                                        storage.GetFileName());
+        HandleProcessDataFailed(CantLoadSettingsForPrintData, fileName);
         return;
     }
 
@@ -1213,15 +1700,16 @@ void PrintEngine::ProcessData()
     {
         HandleProcessDataFailed(_settings.GetInt(USE_PATTERN_MODE) ? 
                                 PatternModeError : VideoModeError, 
-                                storage.GetFileName());
+                                fileName);
         return;
     }
     
     // move the new print data from the staging directory to the print data 
-    // directory
-    if (!pNewPrintData->Move(_settings.GetString(PRINT_DATA_DIR)))
+    // directory, unless it's being printed from where it is
+    if (!_printDataLoader.IsDirect() && 
+        !pNewPrintData->Move(_settings.GetString(PRINT_DATA_DIR)))
     {
-        HandleProcessDataFailed(CantMovePrintData, storage.GetFileName());
+        HandleProcessDataFailed(CantMovePrintData, fileName);
         return;
     }
 
@@ -1230,9 +1718,11 @@ void PrintEngine::ProcessData()
     // "old" print data instance when it goes out of scope and the _pPrintData 
     // member variable will point to the "new" print data instance.
     _pPrintData.swap(pNewPrintData);
+    _pPrintData->SetLayerThickness(_settings.GetInt(LAYER_THICKNESS));
+    _printDataOnUSBDrive = _printDataLoader.IsDirect();
     
     // record the name of the last file downloaded
-    _settings.Set(PRINT_FILE_SETTING, storage.GetFileName());
+    _settings.Set(PRINT_FILE_SETTING, fileName);
     _settings.Save();
    
     // update the printer status with the job id
@@ -1276,24 +1766,33 @@ void PrintEngine::ClearPrintData()
         ClearJobID();   
         // dispose of PrintData instance
         _pPrintData.reset(NULL);
+        _printDataOnUSBDrive = false;
     }
     else
         HandleError(CantRemovePrintData);        
 }
 
 // Gets the time (in seconds) required to print a layer based on the 
-// current settings for the type of layer.  Note: does not take into account
-// per-layer setting overrides that may change the actual print time.
-double PrintEngine::GetLayerTimeSec(LayerType type)
+// current settings for the type of layer, with its exposure scaled for the 
+// current temperature, or leaving out the exposure if withExposure is false 
+// (e.g. because it's taken from the dose table instead).  Note: does not take
+// into account per-layer setting overrides that may change the actual print 
+// time.
+double PrintEngine::GetLayerTimeSec(LayerType type, bool withExposure)
 {
     double time, press, revs, zLift;
     double height = _settings.GetInt(LAYER_THICKNESS);
+    // exposures are shortened by the same factor as the current layer's
+    double exposureScale = withExposure ? 
+                    DoseTable::GetTemperatureScale(_temperature, _settings) :
+                    0.0;
        
     switch(type)
     {
         case First:
             // start with the exposure time, in seconds
-            time = (double) _settings.GetDouble(FIRST_EXPOSURE);
+            time = (double) _settings.GetDouble(FIRST_EXPOSURE) * 
+                                                            exposureScale;
             // plus additional delay (converted from ms)
             time += _settings.GetInt(FL_APPROACH_WAIT) / 1000.0;
             // add separation time
@@ -1317,7 +1816,8 @@ double PrintEngine::GetLayerTimeSec(LayerType type)
             break;
             
         case BurnIn:
-            time = (double) _settings.GetDouble(BURN_IN_EXPOSURE);
+            time = (double) _settings.GetDouble(BURN_IN_EXPOSURE) * 
+                                                            exposureScale;
             time += _settings.GetInt(BI_APPROACH_WAIT) / 1000.0;   
             revs = _settings.GetInt(BI_ROTATION) / MILLIDEGREES_PER_REV;
             time += (revs / _settings.GetInt(BI_SEPARATION_R_SPEED)) * 60.0;
@@ -1335,7 +1835,8 @@ double PrintEngine::GetLayerTimeSec(LayerType type)
             break;
             
         case Model:
-            time = (double) _settings.GetDouble(MODEL_EXPOSURE);
+            time = (double) _settings.GetDouble(MODEL_EXPOSURE) * 
+                                                            exposureScale;
             time += _settings.GetInt(ML_APPROACH_WAIT) / 1000.0;    
             revs = _settings.GetInt(ML_ROTATION) / MILLIDEGREES_PER_REV;
             time += (revs / _settings.GetInt(ML_SEPARATION_R_SPEED)) * 60.0;
@@ -1385,6 +1886,16 @@ bool PrintEngine::GotRotationInterrupt()
     return _gotRotationInterrupt;
 }
 
+// Returns true if the approach for the next layer can be sent along with the
+// separation from the current layer, i.e. when queuing it is enabled and jam
+// detection won't need to replace the approach with jam recovery.
+bool PrintEngine::CanQueueApproach()
+{
+    return _settings.GetInt(QUEUE_APPROACH) != 0 && 
+           (_settings.GetInt(DETECT_JAMS) == 0 || 
+            _settings.GetInt(HARDWARE_REV) == 0);
+}
+
 // Record whether or not a pause & inspect has been requested, 
 // and set UI sub-state if it has been requested.
 void PrintEngine::SetInspectionRequested(bool requested) 
@@ -1425,6 +1936,11 @@ void PrintEngine::ResumeMovement()
 // Abandon any movements still pending after a pause.
 void PrintEngine::ClearPendingMovement(bool withInterrupt)
 {
+    // the abandoned motion may have stopped anywhere
+    ForgetMotorPositions();
+    _approachQueued = false;
+    _queuedApproachTag = 0;
+    
     if (!_motor.ClearPendingCommands(withInterrupt))  
         HandleError(MotorError, true);
     
@@ -1444,8 +1960,50 @@ int PrintEngine::GetTrayDeflection()
 // Get the length of time to pause after tray deflection.
 double PrintEngine::GetTrayDeflectionPauseTimeSec()
 {
+    int delayMS = _cls.PressWaitMS;
+    if (_settings.GetInt(ADAPTIVE_DELAYS))
+        delayMS = GetAdaptiveDelayMS(delayMS, MIN_PRESS_WAIT, "press");
+    
     // convert from milliseconds
-    return _cls.PressWaitMS / 1000.0;
+    return delayMS / 1000.0;
+}
+
+// Returns the given configured settling delay, shortened if the lit area of 
+// the current layer and the history of the print so far allow it.  Any 
+// adjustment is logged.
+int PrintEngine::GetAdaptiveDelayMS(int configuredMS, 
+                                    const char* minimumSetting,
+                                    const char* delayName)
+{
+    // the lit area is measured early on in preparing the image, so use it 
+    // without waiting for the rest of the preparation to finish.  If it 
+    // hasn't been measured yet, or couldn't be, keep the configured delay.
+    double litFraction = _threadData.litFraction.load();
+    if (litFraction < 0.0)
+        return configuredMS;
+    
+    int delayMS = _settlingEstimator.GetDelayMS(configuredMS, 
+                        _settings.GetInt(minimumSetting), _cls.Type, 
+                        litFraction);
+    if (delayMS != configuredMS)
+    {
+        char msg[150];
+        sprintf(msg, LOG_ADAPTIVE_DELAY, _printerStatus._currentLayer, 
+                delayName, configuredMS, delayMS, litFraction * 100.0,
+                _settlingEstimator.GetSuccessfulLayers());
+        Logger::LogMessage(LOG_INFO, msg);
+    }
+    return delayMS;
+}
+
+// Look up or ramp the exposure time of every layer of the current print, if 
+// any, so that it reflects the settings currently in effect.
+void PrintEngine::BuildDoseTable()
+{
+    if (_printerStatus._numLayers > 0)
+        _doseTable.Build(_printerStatus._numLayers, _perLayer, _settings);
+    else
+        _doseTable.Clear();
 }
 
 // Determines if any delay after tray deflection is needed.
@@ -1583,16 +2141,7 @@ void PrintEngine::GetCurrentLayerSettings()
     int n = GetCurrentLayerNum();
     int p = n + 1;
     
-    // find the type of layer n
-    LayerType type = Model;
-    if (n == 1)
-        type = First;
-    else
-    {
-        int numBurnInLayers = _settings.GetInt(BURN_IN_LAYERS);
-        if (numBurnInLayers > 0 && n <= 1 + numBurnInLayers)
-            type = BurnIn;
-    }
+    LayerType type = GetLayerType(n);
 
     switch(type)
     {
@@ -1602,7 +2151,6 @@ void PrintEngine::GetCurrentLayerSettings()
             _cls.PressWaitMS = _perLayer.GetInt(n, FL_PRESS_WAIT);
             _cls.UnpressMicronsPerSec = _perLayer.GetInt(n, FL_UNPRESS_SPEED);
             _cls.ApproachWaitMS = _perLayer.GetInt(n, FL_APPROACH_WAIT);
-            _cls.ExposureSec = _perLayer.GetDouble(n, FIRST_EXPOSURE);
             
             _cls.SeparationRotJerk = _perLayer.GetInt(p, FL_SEPARATION_R_JERK);
             _cls.SeparationRPM = _perLayer.GetInt(p, FL_SEPARATION_R_SPEED);
@@ -1624,7 +2172,6 @@ void PrintEngine::GetCurrentLayerSettings()
             _cls.PressWaitMS = _perLayer.GetInt(n, BI_PRESS_WAIT);
             _cls.UnpressMicronsPerSec = _perLayer.GetInt(n, BI_UNPRESS_SPEED);
             _cls.ApproachWaitMS = _perLayer.GetInt(n, BI_APPROACH_WAIT);
-            _cls.ExposureSec = _perLayer.GetDouble(n, BURN_IN_EXPOSURE);
             
             _cls.SeparationRotJerk = _perLayer.GetInt(p, BI_SEPARATION_R_JERK);
             _cls.SeparationRPM = _perLayer.GetInt(p, BI_SEPARATION_R_SPEED);
@@ -1646,7 +2193,6 @@ void PrintEngine::GetCurrentLayerSettings()
             _cls.PressWaitMS = _perLayer.GetInt(n, ML_PRESS_WAIT);
             _cls.UnpressMicronsPerSec = _perLayer.GetInt(n, ML_UNPRESS_SPEED);
             _cls.ApproachWaitMS = _perLayer.GetInt(n, ML_APPROACH_WAIT);
-            _cls.ExposureSec = _perLayer.GetDouble(n, MODEL_EXPOSURE); 
             
             _cls.SeparationRotJerk = _perLayer.GetInt(p, ML_SEPARATION_R_JERK);
             _cls.SeparationRPM = _perLayer.GetInt(p, ML_SEPARATION_R_SPEED);
@@ -1663,8 +2209,12 @@ void PrintEngine::GetCurrentLayerSettings()
             break;
     }
     
+    _cls.Type = type;
+    
     // likewise any layer thickness overrides come from the next layer
     _cls.LayerThicknessMicrons = _perLayer.GetInt(p, LAYER_THICKNESS);
+
+    _cls.ExposureSec = GetLayerExposureSec(n, type);
     
     // to avoid changes while pause & inspect is already in progress:
     _cls.InspectionHeightMicrons = _settings.GetInt(INSPECTION_HEIGHT);
@@ -1675,6 +2225,39 @@ void PrintEngine::GetCurrentLayerSettings()
                                                 _cls.InspectionHeightMicrons));
 }
 
+// Find the type of the given layer.
+LayerType PrintEngine::GetLayerType(int layer)
+{
+    if (layer == 1)
+        return First;
+    
+    int numBurnInLayers = _settings.GetInt(BURN_IN_LAYERS);
+    if (numBurnInLayers > 0 && layer <= 1 + numBurnInLayers)
+        return BurnIn;
+    
+    return Model;
+}
+
+// Get the exposure time for the given layer, of the given type, at the 
+// current temperature.
+double PrintEngine::GetLayerExposureSec(int layer, LayerType type)
+{
+    double seconds;
+    
+    // exposure times are computed for every layer when the print starts
+    if (_doseTable.Contains(layer))
+        seconds = _doseTable.GetExposureSec(layer);
+    else if (type == First)
+        seconds = _perLayer.GetDouble(layer, FIRST_EXPOSURE);
+    else if (type == BurnIn)
+        seconds = _perLayer.GetDouble(layer, BURN_IN_EXPOSURE);
+    else
+        seconds = _perLayer.GetDouble(layer, MODEL_EXPOSURE);
+    
+    // shorten exposures for warm resin
+    return seconds * DoseTable::GetTemperatureScale(_temperature, _settings);
+}
+
 // Indicate whether the last print is regarded as successful or failed.
 void PrintEngine::SetPrintFeedback(PrintRating rating)
 {
@@ -1759,6 +2342,7 @@ bool PrintEngine::SetDemoMode()
     Initialize();
         
     // go to home position without rotating the tray to cover the projector
+    ForgetMotorPositions();
     _motor.GoHome(true, true, true);  
     // (and leave the motors enabled to hold their positions)
    
@@ -1786,6 +2370,7 @@ void* PrintEngine::InBackground(void* context)
         setpriority(PRIO_PROCESS, tid, -10); 
 
         ThreadData* pData = (ThreadData*)context;
+        double startTime = GetSeconds();
 
         if (!pData->pPrintData->GetImageForLayer(pData->layer, pData->pImage))
         {
@@ -1797,6 +2382,11 @@ void* PrintEngine::InBackground(void* context)
         if (pData->scaleFactor != 1.0)
             pData->imageProcessor->Scale(pData->pImage, pData->scaleFactor);
         
+        // measure the lit area if needed for estimating settling time
+        if (pData->measureLitArea)
+            pData->litFraction = 
+                        pData->imageProcessor->GetLitFraction(*pData->pImage);
+        
         Magick::Image* pOutput = pData->pImage;
         // remap the image for pattern mode if needed
         if (pData->usePatternMode)
@@ -1804,6 +2394,12 @@ void* PrintEngine::InBackground(void* context)
         
         // convert the image to a projectable format
         pData->pProjector->SetImage(*pOutput);
+        
+        pData->prepTimeSec = GetSeconds() - startTime;
+        
+        // now that this layer is ready, get ahead on upcoming ones if the 
+        // print data is on slow storage (without waiting for the reads)
+        pData->pPrintData->ReadAhead(pData->layer);
     }
     catch (const std::exception& e)
     {
@@ -1879,4 +2475,42 @@ bool PrintEngine::SetPrintMode()
         return false;            
     }
     return true;
+}
+
+// Record that the resin tray jammed during separation.
+void PrintEngine::CountJam()
+{
+    _jams.Increment();
+    _settlingEstimator.Jammed();
+}
+
+// Perform the given work now, or if we're about to start an exposure, as soon 
+// as the exposure has started, so that it doesn't delay the exposure.  
+// Deferred work is performed in the order in which it was requested.
+void PrintEngine::DeferWork(const std::function<void()>& work)
+{
+    if (_deferringWork)
+        _deferredWork.push_back(work);
+    else
+        work();
+}
+
+// Start holding non-critical work, such as status updates, until 
+// RunDeferredWork is called.
+void PrintEngine::StartDeferringWork()
+{
+    _deferringWork = true;
+}
+
+// Stop holding non-critical work and perform any that has been deferred.
+void PrintEngine::RunDeferredWork()
+{
+    _deferringWork = false;
+    
+    // swap the work out first, in case any of it defers more work
+    std::vector<std::function<void()>> work;
+    work.swap(_deferredWork);
+    for (std::vector<std::function<void()>>::iterator it = work.begin();
+            it != work.end(); it++)
+        (*it)();
 }
\ No newline at end of file
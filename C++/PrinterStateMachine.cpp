@@ -227,7 +227,14 @@ Initializing::~Initializing()
 
 sc::result Initializing::react(const EvInitialized&)
 {
-    context<PrinterStateMachine>().SendMotorCommand(GoHome);
+    if (PRINTENGINE->MotorsAtHome())
+    {
+        // no need to move, so let Homing complete as soon as it's entered
+        context<PrinterStateMachine>()._motionCompleted = true;
+    }
+    else
+        context<PrinterStateMachine>().SendMotorCommand(GoHome);
+    
     return transit<Homing>();
 }
 
@@ -761,6 +768,10 @@ InitializingLayer::InitializingLayer(my_context ctx) : my_base(ctx)
         post_event(EvDoorOpened());
     else
     {
+        // from here until the exposure starts, hold any work that would 
+        // only delay it
+        PRINTENGINE->StartDeferringWork();
+        
         // perform initialization needed for next layer
         // (even if the door is opened and closed again while here,
         // this won't be called more than once per layer, because we're going to 
@@ -787,11 +798,15 @@ sc::result InitializingLayer::react(const EvInitialized&)
     {
         // begin with tray deflection
         context<PrinterStateMachine>().SendMotorCommand(Press);
+        // the exposure won't start till after the press, so don't hold work
+        // until it's about to
+        PRINTENGINE->RunDeferredWork();
         return transit<Pressing>();
     }
     else if(PRINTENGINE->NeedsPreExposureDelay())
     {
         // begin with pre-exposure delay
+        PRINTENGINE->RunDeferredWork();
         return transit<PreExposureDelay>();
     }        
     else
@@ -874,7 +889,11 @@ sc::result Unpressing::react(const EvMotionCompleted&)
     if(PRINTENGINE->NeedsPreExposureDelay())
         return transit<PreExposureDelay>();
     else
+    {
+        // hold any work that would only delay the exposure, until it starts
+        PRINTENGINE->StartDeferringWork();
         return transit<Exposing>();
+    }
 }
 
 PreExposureDelay::PreExposureDelay(my_context ctx) : my_base(ctx)
@@ -902,6 +921,8 @@ PreExposureDelay::~PreExposureDelay()
 
 sc::result PreExposureDelay::react(const EvDelayEnded&)
 {     
+    // hold any work that would only delay the exposure, until it starts
+    PRINTENGINE->StartDeferringWork();
     return transit<Exposing>();
 }
 
@@ -925,15 +946,19 @@ Exposing::Exposing(my_context ctx) : my_base(ctx)
     { 
         // initial entry into constructor for exposing this layer
         if(!PRINTENGINE->AwaitEndOfBackgroundThread())
+        {
+            PRINTENGINE->RunDeferredWork();
             return;  // fatal error 
+        }
         
         exposureTimeSec = PRINTENGINE->GetExposureTimeSec();
     }
       
-    // display current layer
-    PRINTENGINE->ShowImage();
+    // display current layer for the exposure time
+    PRINTENGINE->StartExposure(exposureTimeSec);
     
-    PRINTENGINE->StartExposureTimer(exposureTimeSec);
+    // now that the exposure has started, catch up on the work held till now
+    PRINTENGINE->RunDeferredWork();
 }
 
 Exposing::~Exposing()
@@ -999,6 +1024,7 @@ sc::result Separating::react(const EvMotionCompleted&)
         sprintf(msg, LOG_JAM_DETECTED, PRINTENGINE->GetCurrentLayerNum(),
                                        PRINTENGINE->GetTemperature());
         Logger::LogMessage(LOG_INFO, msg);
+        PRINTENGINE->CountJam();
         
         context<PrinterStateMachine>()._remainingUnjamTries = 
                             PrinterSettings::Instance().GetInt(MAX_UNJAM_TRIES);
@@ -56,7 +56,8 @@ _printRating(Unknown),
 _usbDriveFileName(""),
 _jobID(""),
 _canLoadPrintData(false),
-_canUpgradeProjector(false)
+_canUpgradeProjector(false),
+_loadProgress(0)
 {
     GetUUID(_localJobUniqueID); 
 }
@@ -177,7 +178,8 @@ std::string PrinterStatus::ToString() const
             "\"" << SPARK_JOB_STATE_PS_KEY << "\": \"\"," <<
             "\"" << LOCAL_JOB_UUID_PS_KEY  << "\": \"\"," <<
             "\"" << CAN_LOAD_PS_KEY        << "\": \"\"," <<
-            "\"" << CAN_UPGRADE_PROJECTOR_PS_KEY    << "\": false" <<
+            "\"" << CAN_UPGRADE_PROJECTOR_PS_KEY    << "\": false," <<
+            "\"" << LOAD_PROGRESS_PS_KEY   << "\": 0" <<
             "}";
     
     try
@@ -251,6 +253,7 @@ std::string PrinterStatus::ToString() const
         
         doc[CAN_LOAD_PS_KEY] = _canLoadPrintData; 
         doc[CAN_UPGRADE_PROJECTOR_PS_KEY] = _canUpgradeProjector;
+        doc[LOAD_PROGRESS_PS_KEY] = _loadProgress;
         
         StringBuffer buffer; 
         Writer<StringBuffer> writer(buffer);
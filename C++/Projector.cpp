@@ -29,6 +29,8 @@
 //  along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 #include "Projector.h"
 #include "I_I2C_Device.h"
@@ -44,6 +46,47 @@
 // delay times for projector control, expressed in microseconds
 constexpr unsigned int DELAY_10_Ms  =  10000;
 constexpr unsigned int DELAY_100_Ms = 100000;
+// maximum time to wait for the projector to sync up after changing the video
+// resolution, in units of 10 ms
+constexpr unsigned int MAX_VIDEO_SYNC_POLLS = 200;
+// time for which each pattern is shown, once per video frame, in microseconds
+constexpr unsigned int PATTERN_EXPOSURE_US = 16667;
+// the pattern LUT's capacity, which limits the number of frames for which
+// the pattern sequencer can time an exposure
+constexpr int MAX_PATTERN_LUT_ENTRIES = 128;
+
+// Registers that only hold settings, as opposed to those that start an 
+// operation, or whose values the projector may change on its own (like the 
+// LED enable register, which is set by a change of video source).  Writing the
+// value one of these already holds has no effect, so it's skipped.
+static bool IsShadowed(unsigned char registerAddress)
+{
+    switch (registerAddress)
+    {
+        case PROJECTOR_LED_PWM_POLARITY_REG:
+        case PROJECTOR_LED_CURRENT_REG:
+            return true;
+            
+        default:
+            return false;
+    }
+}
+
+// Registers whose writes change the projector's mode, after which the values
+// of the shadowed registers can't be relied upon.
+static bool ResetsShadowedRegisters(unsigned char registerAddress)
+{
+    switch (registerAddress)
+    {
+        case PROJECTOR_DISPLAY_MODE_REG:
+        case PROJECTOR_SOURCE_SELECT_REG:
+        case PROJECTOR_PROGRAM_MODE_REG:
+            return true;
+            
+        default:
+            return false;
+    }
+}
 
 Projector::Projector(const I_I2C_Device& i2cDevice) :
 _i2cDevice(i2cDevice),
@@ -52,7 +95,9 @@ _totalProgramBytes(0L),
 _programBytesWritten(0L),
 _runningChecksum(0L),
 _programmingComplete(false),
-_pFirmwareFile(NULL)
+_pFirmwareFile(NULL),
+_displayMode(UnknownDisplayMode),
+_sequenceFrames(0)
 {
     // see if we have an I2C connection to the projector
     _canControlViaI2C = (I2CRead(PROJECTOR_HW_STATUS_REG) != ERROR_STATUS);
@@ -111,6 +156,7 @@ void Projector::ShowCurrentImage()
     {
         _pFrameBuffer->Swap();
     }
+    RestoreContinuousSequence();
     TurnLEDOn();
 }
 
@@ -131,6 +177,7 @@ void Projector::ShowWhite()
     {
         _pFrameBuffer->Fill(0xFF);
     }
+    RestoreContinuousSequence();
     TurnLEDOn();
 
 }
@@ -146,7 +193,8 @@ void Projector::TurnLEDOff()
 
 // Set the projector's LED(s) current and turn them on. Set the current every
 // time to prevent having to restart the system to observe the effects of
-// changing the LED current setting.
+// changing the LED current setting.  Unless it's changed, the current and PWM 
+// polarity writes are skipped, leaving a single I2C transaction.
 void Projector::TurnLEDOn()
 {
     if (!_canControlViaI2C)
@@ -199,12 +247,18 @@ bool Projector::DisableGamma()
     return false;
 }
 
-// Attempt to put the projector into pattern mode.  
-// Returns false if pattern mode cannot be set.
+// Attempt to put the projector into pattern mode, unless it's already in that
+// mode.  Returns false if pattern mode cannot be set.
 bool Projector::SetPatternMode()
 {   
     if(!_canControlViaI2C || !_supportsPatternMode)
         return false;   // can't set pattern mode
+    
+    if (_displayMode == PatternDisplayMode)
+        return true;    // nothing to do
+    
+    // until we've succeeded, we don't know what mode the projector is in
+    _displayMode = UnknownDisplayMode;
        
     if (!SetVideoResolution(PATTERN_MODE_WIDTH, PATTERN_MODE_HEIGHT))
         return false;   // can't set required video resolution
@@ -223,44 +277,79 @@ bool Projector::SetPatternMode()
     I2CWrite(PROJECTOR_PATTERN_SOURCE_REG, 0);
     usleep(DELAY_100_Ms);
     
+    // 3. - 8. program a sequence that repeats a single pattern
+    if (!ProgramPatternSequence(0, DELAY_100_Ms))
+        return false;
+    
+    usleep(DELAY_100_Ms);
+    
+    // 9. read status
+    if(!PollStatus())
+        return false;   // 10. handle error
+    usleep(DELAY_100_Ms);
+     
+    // 11. start pattern mode
+    I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_START_PATTERN_SEQ);
+    
+    _displayMode = PatternDisplayMode;
+    return true;
+}
+    
+// Program the pattern sequence (steps 3 through 8 of sec 4.1 of the PRO 
+// DLPC350 Programmer’s Guide) to show the pattern from each video frame for
+// the given number of frames and then stop, or to repeat indefinitely if 
+// frames is 0, waiting stepDelay microseconds after each step.  The sequence
+// must already be stopped.  Returns false if it can't be validated.
+bool Projector::ProgramPatternSequence(int frames, unsigned int stepDelay)
+{
+    // sequence frames are only known once they've been validated
+    _sequenceFrames = -1;
+    
+    int entries = frames > 0 ? frames : 1;
+    
     // 3. set pattern LUT control
-    unsigned char lut[4] = {0,   // one entry
-                            1,   // repeat
-                            0,   // one pattern
+    unsigned char lut[4] = {static_cast<unsigned char>(entries - 1), 
+                            // play once or repeat
+                            static_cast<unsigned char>(frames > 0 ? 0 : 1),
+                            static_cast<unsigned char>(entries - 1),
                             0}; // irrelevant
 
     I2CWrite(PROJECTOR_PATTERN_LUT_CTL_REG, lut, 4);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
     
     // 4. set trigger mode 0
     I2CWrite(PROJECTOR_PATTERN_TRIGGER_REG, 0);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
             
     // 5. set pattern exposure time and frame period
-    unsigned char times[8] = {0x1B, 0x41, 0, 0,  // 0x411B = 16667 microseconds
-                              0x1B, 0x41, 0, 0}; 
+    unsigned char times[8] = {PATTERN_EXPOSURE_US & 0xFF, 
+                              PATTERN_EXPOSURE_US >> 8, 0, 0,
+                              PATTERN_EXPOSURE_US & 0xFF, 
+                              PATTERN_EXPOSURE_US >> 8, 0, 0}; 
     I2CWrite(PROJECTOR_PATTERN_TIMES_REG, times, 8);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
     
     // (step 6 not needed)
     // 7.a. open LUT mailbox
     I2CWrite(PROJECTOR_PATTERN_LUT_ACC_REG, 2);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
     
     // 7.b. set mailbox offset
     I2CWrite(PROJECTOR_PATTERN_LUT_OFFSET_REG, 0);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
     
-    // 7.c. fill pattern data
+    // 7.c. fill pattern data, the same for each entry, since each shows the
+    // pattern from the next video frame
     unsigned char data[3] = {0 | (0 << 2),  // internal trigger, pattern 0 
                              7 | (4 << 4),  // 7-bit, Blue LED   
                              0};            // no options needed here     
-    I2CWrite(PROJECTOR_PATTERN_LUT_DATA_REG, data, 3);
-    usleep(DELAY_100_Ms);
+    for (int i = 0; i < entries; i++)
+        I2CWrite(PROJECTOR_PATTERN_LUT_DATA_REG, data, 3);
+    usleep(stepDelay);
     
     // 7.d. close LUT mailbox
     I2CWrite(PROJECTOR_PATTERN_LUT_ACC_REG, 0);
-    usleep(DELAY_100_Ms);
+    usleep(stepDelay);
     
     // 8. validate the commands
     I2CWrite(PROJECTOR_VALIDATE_REG, 0);
@@ -273,19 +362,84 @@ bool Projector::SetPatternMode()
         return false;
     }
     
-    usleep(DELAY_100_Ms);
+    _sequenceFrames = frames;
+    return true;
+}
+
+// Get the number of video frames that most closely matches the given time.
+static int FramesFor(double seconds)
+{
+    return std::max(1L, std::lround(seconds * 1e6 / PATTERN_EXPOSURE_US));
+}
+
+// Returns true if an exposure of the given length can be timed by the 
+// projector's pattern sequencer.
+bool Projector::CanTimeExposure(double seconds)
+{
+    return _displayMode == PatternDisplayMode && 
+           FramesFor(seconds) <= MAX_PATTERN_LUT_ENTRIES;
+}
+
+// Program the pattern sequence for an exposure of the given time ahead of
+// StartTimedExposure, which otherwise has to program it before the exposure 
+// can start.  Nothing is shown until the exposure starts.  Returns false if 
+// the sequence can't be programmed.
+bool Projector::PrepareTimedExposure(double seconds)
+{
+    if (!CanTimeExposure(seconds))
+        return false;
     
-    // 9. read status
-    if(!PollStatus())
-        return false;   // 10. handle error
-    usleep(DELAY_100_Ms);
-     
-    // 11. start pattern mode
-    I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_START_PATTERN_SEQ);
+    int frames = FramesFor(seconds);
+    if (frames == _sequenceFrames)
+        return true;
     
-    return true;
+    I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_STOP_PATTERN_SEQ);
+    return ProgramPatternSequence(frames, DELAY_10_Ms);
+}
+
+// Show the currently held image for the given time, as timed by the 
+// projector's pattern sequencer, which then stops showing it on its own.  That
+// avoids the latency and jitter of waiting for a host timer and writing over
+// I2C to turn the LEDs off.  The sequencer shows the image for the whole 
+// number of video frames closest to the given time, beginning with the first
+// frame after it's started.  Requires that CanTimeExposure(seconds) be true.
+// Returns false if the sequence can't be programmed or started.
+bool Projector::StartTimedExposure(double seconds)
+{
+    int frames = FramesFor(seconds);
+    
+    // stop the sequence, in case a previous exposure was interrupted
+    I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_STOP_PATTERN_SEQ);
+    
+    // the sequence only needs reprogramming when it wasn't prepared for this
+    // exposure time
+    if (frames != _sequenceFrames && 
+        !ProgramPatternSequence(frames, DELAY_10_Ms))
+        return false;
+    
+    if (_pFrameBuffer)
+        _pFrameBuffer->Swap();
+    
+    // nothing is shown while the sequence is stopped
+    TurnLEDOn();
+    return I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_START_PATTERN_SEQ);
 }
+
+// In pattern mode, return to a sequence that repeats until it's stopped, if 
+// it was last programmed for a timed exposure, so that images can be shown 
+// for as long as they're needed.  Returns false if it can't be programmed.
+bool Projector::RestoreContinuousSequence()
+{
+    if (_displayMode != PatternDisplayMode || _sequenceFrames == 0)
+        return true;
+    
+    I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_STOP_PATTERN_SEQ);
+    if (!ProgramPatternSequence(0, DELAY_10_Ms))
+        return false;
     
+    return I2CWrite(PROJECTOR_PATTERN_START_REG, PROJECTOR_START_PATTERN_SEQ);
+}
+
 // Poll system status as required after sending commands to switch between
 // video and pattern modes.  Returns false if an error is detected.
 bool Projector::PollStatus()
@@ -323,10 +477,16 @@ bool Projector::PollStatus()
         return true; 
 }
 
-// Attempt to put the projector into video mode.  
-// Returns false if video mode cannot be set.
+// Attempt to put the projector into video mode, unless it's already in that
+// mode.  Returns false if video mode cannot be set.
 bool Projector::SetVideoMode()
 {    
+    if (_displayMode == VideoDisplayMode)
+        return true;    // nothing to do
+    
+    // until we've succeeded, we don't know what mode the projector is in
+    _displayMode = UnknownDisplayMode;
+    
     if(_canControlViaI2C)
     {
         // exit pattern mode
@@ -344,20 +504,66 @@ bool Projector::SetVideoMode()
     
     if(!DisableGamma())
         Logger::LogError(LOG_ERR, errno, ProjectorGammaError);
+    
+    _displayMode = VideoDisplayMode;
     return true;
 }
 
-// Wrapper that sets msb of register address, as required by the projector.
+// Wrapper that sets msb of register address, as required by the projector,
+// and skips writing the value a shadowed register already holds.
 bool Projector::I2CWrite(unsigned char registerAddress, unsigned char data)
 {
-    return _i2cDevice.Write(registerAddress | PROJECTOR_WRITE_BIT, data);
+    if (IsShadowCurrent(registerAddress, &data, 1))
+        return true;
+    
+    return UpdateShadow(registerAddress, &data, 1, 
+            _i2cDevice.Write(registerAddress | PROJECTOR_WRITE_BIT, data));
 }
 
-// Wrapper that sets msb of register address, as required by the projector.
+// Wrapper that sets msb of register address, as required by the projector,
+// and skips writing the value a shadowed register already holds.
 bool Projector::I2CWrite(unsigned char registerAddress, 
                          const unsigned char* data, int length)
 {
-    return _i2cDevice.Write(registerAddress | PROJECTOR_WRITE_BIT, data, length);
+    if (IsShadowCurrent(registerAddress, data, length))
+        return true;
+    
+    return UpdateShadow(registerAddress, data, length, 
+       _i2cDevice.Write(registerAddress | PROJECTOR_WRITE_BIT, data, length));
+}
+
+// Returns true if the given register is shadowed and was last successfully
+// written with the given value.
+bool Projector::IsShadowCurrent(unsigned char registerAddress, 
+                                const unsigned char* data, int length) const
+{
+    if (!IsShadowed(registerAddress))
+        return false;
+    
+    auto it = _shadowRegisters.find(registerAddress);
+    return it != _shadowRegisters.end() && 
+           it->second == std::vector<unsigned char>(data, data + length);
+}
+
+// Keep track of the value written to a shadowed register, or forget it if 
+// the write failed, since the register may then hold any value.  Forget all 
+// of them after a write that changes the projector's mode.  Returns whether 
+// or not the write succeeded.
+bool Projector::UpdateShadow(unsigned char registerAddress, 
+                             const unsigned char* data, int length, 
+                             bool written)
+{
+    if (ResetsShadowedRegisters(registerAddress))
+        _shadowRegisters.clear();
+    else if (IsShadowed(registerAddress))
+    {
+        if (written)
+            _shadowRegisters[registerAddress].assign(data, data + length);
+        else
+            _shadowRegisters.erase(registerAddress);
+    }
+    
+    return written;
 }
 
 // Wrapper that reads when ready, as required by the projector.
@@ -390,6 +596,8 @@ bool Projector::EnterProgramMode(bool enter)
     
     if (enter)
     {
+        // the display mode will need to be set again when we're done
+        _displayMode = UnknownDisplayMode;
         cmd = PROJECTOR_ENTER_PROGRAM_MODE;  
         retVal= I2CWrite(PROJECTOR_PROGRAM_MODE_REG, &cmd, 1);
         // here we need to wait 5 s for for the projector controller to jump 
@@ -404,6 +612,7 @@ bool Projector::EnterProgramMode(bool enter)
         cmd = PROJECTOR_LEAVE_PROGRAM_MODE;  
         // don't set high bit of register when in Program Mode
         retVal = _i2cDevice.Write(PROJECTOR_PROGRAM_MODE_REG, &cmd, 1);
+        _shadowRegisters.clear();
         
         // this doesn't seem to work to get the projector out of Program Mode, 
         // whether we set the high bit or not
@@ -697,31 +906,34 @@ bool Projector::I2CWriteAndRead(unsigned char regAddress,
     return _i2cDevice.Read(regAddress, readBuf, numBytesToRead);
 }
 
-// Sets the video resolution by creating a new frame buffer with the specified
-// width and height.
+// Sets the video resolution, creating the frame buffer the first time it's
+// called.  The frame buffer keeps the buffers for each resolution it's been 
+// set to, so switching between video and pattern mode resolutions doesn't 
+// require re-creating them.
 // Note: Clients must call this method before using any of the show methods.
 bool Projector::SetVideoResolution(int width, int height)
 {
-    // Call reset() to delete the existing frame buffer.
-    // The existing frame buffer must release its resources before this method
-    // creates a new instance via CreateFrameBuffer().
     try
     {
-        // de-select the current video source while creating the frame buffer
+        // de-select the current video source while changing the resolution
         if (_canControlViaI2C)
             I2CWrite(PROJECTOR_SOURCE_SELECT_REG, PROJECTOR_SOURCE_FPD_LINK);
-        _pFrameBuffer.reset();
-        _pFrameBuffer = std::move(HardwareFactory::CreateFrameBuffer(width, height));
+        
+        if (!_pFrameBuffer)
+            _pFrameBuffer = std::move(HardwareFactory::CreateFrameBuffer(width, 
+                                                                     height));
+        else
+            _pFrameBuffer->SetResolution(width, height);
+        
         if (_canControlViaI2C)
         {
-            // wait for the video to stabilize
-            sleep(1);            
             // re-select the actual video source
             I2CWrite(PROJECTOR_SOURCE_SELECT_REG, PROJECTOR_SOURCE_PARALLEL_24);
             // the source switch turns on the LED, so turn it off again
             TurnLEDOff();
-            // wait for the projector to sync up
-            sleep(1);   
+            // wait for the projector to sync up, failing if it never does
+            if (!AwaitVideoSync())
+                return false;
         }
         return true;
     }
@@ -729,4 +941,26 @@ bool Projector::SetVideoResolution(int width, int height)
     {
         return false;
     }
-}
\ No newline at end of file
+}
+
+// Poll the projector's main status until it shows that the projector is 
+// displaying (unfrozen) video, rather than waiting a fixed time for it to sync
+// up with a new video resolution.  Returns false if it doesn't sync up within
+// the maximum allowed time. 
+bool Projector::AwaitVideoSync()
+{
+    unsigned char status = ERROR_STATUS;
+    for (unsigned int i = 0; i < MAX_VIDEO_SYNC_POLLS; i++)
+    {
+        status = I2CRead(PROJECTOR_MAIN_STATUS_REG);
+        if (status != ERROR_STATUS && 
+            (status & PROJECTOR_SEQUENCER_RUNNING) != 0 &&
+            (status & PROJECTOR_VIDEO_FROZEN) == 0)
+            return true;
+        
+        usleep(DELAY_10_Ms);
+    }
+    
+    Logger::LogError(LOG_WARNING, errno, ProjectorVideoSyncTimeout, status);
+    return false;
+}
@@ -22,6 +22,8 @@
 //  along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include <string.h>
+#include <stdlib.h>
+#include <errno.h>
 #include <libgen.h>
 #include <exception>
 #include <sstream>
@@ -69,6 +71,13 @@ _errorHandler(NULL)
             "\"" << MOTOR_TIMEOUT_FACTOR   << "\": 1.1," <<
             "\"" << MIN_MOTOR_TIMEOUT_SEC  << "\": 15.0," <<
             "\"" << PROJECTOR_LED_CURRENT  << "\": -1," <<
+            "\"" << ADAPTIVE_DELAYS        << "\": 0," <<
+            "\"" << MIN_APPROACH_WAIT      << "\": 500," <<
+            "\"" << MIN_PRESS_WAIT         << "\": 500," <<
+            "\"" << SKIP_REDUNDANT_HOMING  << "\": 0," <<
+            "\"" << QUEUE_APPROACH         << "\": 0," <<
+            "\"" << PROJ_TIMED_EXPOSURE    << "\": 0," <<
+            "\"" << ALLOW_RGB565_SCANOUT   << "\": 0," <<
             
             "\"" << MICRO_STEPS_MODE       << "\": 6," <<
             "\"" << Z_STEP_ANGLE           << "\": 1800," <<
@@ -93,6 +102,8 @@ _errorHandler(NULL)
             "\"" << IMAGE_SCALE_FACTOR     << "\": 1.0," <<
             "\"" << PAT_MODE_SCALE_FACTOR  << "\": 1.0," <<
             "\"" << USB_DRIVE_DATA_DIR     << "\": \"/EmberUSB\"," << 
+            "\"" << DIRECT_USB_PRINT       << "\": 0," <<
+            "\"" << USB_READ_AHEAD_LAYERS  << "\": 20," <<
             "\"" << FW_VERSION             << "\": \"\""; 
     
 
@@ -109,6 +120,11 @@ _errorHandler(NULL)
             "\"" << BURN_IN_LAYERS         << "\": 1," <<
             "\"" << BURN_IN_EXPOSURE       << "\": 4.0," <<
             "\"" << MODEL_EXPOSURE         << "\": 2.5," <<
+            "\"" << EXPOSURE_RAMP_LAYERS   << "\": 0," <<
+            "\"" << EXPOSURE_RAMP_SHAPE    << "\": \"Linear\"," <<
+            "\"" << EXPOSURE_TEMP_COEFF    << "\": 0.0," <<
+            "\"" << EXPOSURE_REF_TEMP      << "\": 20.0," <<
+            "\"" << MIN_EXPOSURE_SCALE     << "\": 0.75," <<
             
             "\"" << HOME_ON_APPROACH       << "\": 0," <<
             "\"" << USE_PATTERN_MODE       << "\": 0," <<
@@ -269,8 +285,12 @@ bool Settings::Load(const std::string& filename, bool initializing)
             for (std::vector<std::string>::iterator it = missing.begin(); 
                                                     it != missing.end(); ++it)
             {
-                _settingsDoc[SETTINGS_ROOT_KEY].AddMember(StringRef(it->c_str()), 
-                        defaultDoc[SETTINGS_ROOT_KEY][StringRef(it->c_str())], 
+                // copy the name and value, since neither the list of 
+                // missing names nor the defaults outlive this method
+                Value name(it->c_str(), _settingsDoc.GetAllocator());
+                Value value(defaultDoc[SETTINGS_ROOT_KEY][it->c_str()], 
+                            _settingsDoc.GetAllocator());
+                _settingsDoc[SETTINGS_ROOT_KEY].AddMember(name, value, 
                         _settingsDoc.GetAllocator());
             }
             Save();
@@ -366,6 +386,57 @@ bool Settings::SetFromFile(const std::string& filename)
     return SetFromJSONString(buffer.str());
 }
 
+// Set the one setting named by key from its value given as text, converting
+// it to the setting's type, without validating any other settings or saving 
+// the change, though any later Save() will then include it.  String values 
+// are taken as is, without quotes.
+bool Settings::SetFromText(const std::string& key, const std::string& text)
+{
+    if (!IsValidSettingName(key))
+    {
+        HandleError(UnknownSetting, true, key.c_str());
+        return false;
+    }
+    
+    Document defaultsDoc;
+    defaultsDoc.Parse(_defaultJSON.c_str());
+    const Value& defaultValue = defaultsDoc[SETTINGS_ROOT_KEY]
+                                          [StringRef(key.c_str())];
+    
+    if (defaultValue.IsString())
+    {
+        Set(key, text);
+        return true;
+    }
+    
+    // numeric values must consist of nothing but the number
+    const char* start = text.c_str();
+    char* end;
+    errno = 0;
+    if (defaultValue.IsInt())
+    {
+        long value = strtol(start, &end, 10);
+        if (end != start && *end == '\0' && errno == 0 && 
+            value >= INT_MIN && value <= INT_MAX)
+        {
+            Set(key, (int)value);
+            return true;
+        }
+    }
+    else if (defaultValue.IsDouble())
+    {
+        double value = strtod(start, &end);
+        if (end != start && *end == '\0' && errno == 0)
+        {
+            Set(key, value);
+            return true;
+        }
+    }
+    
+    HandleError(WrongTypeForSetting, true, key.c_str());
+    return false;
+}
+
 // Save the current settings in the main settings file
 void Settings::Save()
 {
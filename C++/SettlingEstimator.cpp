@@ -0,0 +1,83 @@
+//  File:   SettlingEstimator.cpp
+//  Estimates how much of the configured settling delays before exposure can be
+//  skipped, based on the lit area of a layer and the print's recent history
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+
+#include "SettlingEstimator.h"
+
+// fraction of the image lit at or above which a layer needs its full delay
+constexpr double FULL_SETTLING_LIT_FRACTION = 0.25;
+// smallest fraction of the configured delay used for even the smallest layer
+constexpr double MIN_SETTLING_FACTOR        = 0.25;
+// number of consecutive layers without jams before the full reduction applies
+constexpr int    LAYERS_TO_FULL_CONFIDENCE  = 10;
+
+SettlingEstimator::SettlingEstimator()
+{
+    Reset();
+}
+
+// Forget the history of the previous print.
+void SettlingEstimator::Reset()
+{
+    _successfulLayers = 0;
+    _jammed = false;
+}
+
+// Record the completion of a layer, which only counts towards shortening 
+// later delays if it didn't jam.
+void SettlingEstimator::LayerCompleted()
+{
+    if (_jammed)
+        _successfulLayers = 0;
+    else
+        _successfulLayers++;
+    
+    _jammed = false;
+}
+
+// Record a jam in the current layer, which restores the full delays until 
+// enough later layers complete without jamming.
+void SettlingEstimator::Jammed()
+{
+    _jammed = true;
+    _successfulLayers = 0;
+}
+
+// Returns the delay to use in place of the given configured delay.  Only model 
+// layers are shortened, in proportion to how little of the layer is lit, and 
+// only as far as the number of recent jam-free layers justifies.  The result
+// is never less than the given minimum, nor more than the configured delay.
+int SettlingEstimator::GetDelayMS(int configuredMS, int minimumMS, 
+                                  LayerType type, double litFraction) const
+{
+    if (type != Model || configuredMS <= minimumMS)
+        return configuredMS;
+    
+    double areaFactor = MIN_SETTLING_FACTOR + (1.0 - MIN_SETTLING_FACTOR) * 
+                std::min(1.0, litFraction / FULL_SETTLING_LIT_FRACTION);
+    double confidence = std::min(1.0, 
+                _successfulLayers / (double) LAYERS_TO_FULL_CONFIDENCE);
+    double factor = 1.0 - (1.0 - areaFactor) * confidence;
+    
+    int delayMS = (int) (configuredMS * factor + 0.5);
+    return std::max(minimumMS, std::min(configuredMS, delayMS));
+}
@@ -25,18 +25,23 @@
 #include <zlib.h>
 #include <cstring>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <iostream>
 #include <cerrno>
 #include <vector>
+#include <algorithm>
 
 #include <TarGzFile.h>
 
 static int gzOpenFrontend(const char* pathname, int oflags, int mode);
 
 // Extracts the contents of the tar.gz file specified by archivePath into the 
-// path specified by rootPath
+// path specified by rootPath, reporting progress to the optional callback
+// after each member so that a caller on another thread can follow along or
+// abandon the extraction
 bool TarGzFile::Extract(const std::string& archivePath, 
-                        const std::string& rootPath)
+                        const std::string& rootPath,
+                        const ExtractProgressCallback& progress)
 {
     bool retVal = true;
     
@@ -62,9 +67,42 @@ bool TarGzFile::Extract(const std::string& archivePath,
         return false;
     }
 
-    if (tar_extract_all(tar, rootPathBuf.data()) != 0)
+    // the size of the compressed archive, for reporting progress
+    struct stat archiveStat;
+    double archiveSize = 0.0;
+    if (stat(archivePathBuf.data(), &archiveStat) == 0)
+        archiveSize = archiveStat.st_size;
+    
+    // the tar file descriptor holds the gzFile returned by gzOpenFrontend
+    gzFile gzf = (gzFile)(intptr_t)tar_fd(tar);
+
+    // equivalent to tar_extract_all, one member at a time
+    int status;
+    while ((status = th_read(tar)) == 0)
+    {
+        std::string memberPath = rootPath + "/" + th_get_pathname(tar);
+        std::vector<char> memberPathBuf(memberPath.begin(), memberPath.end());
+        memberPathBuf.push_back('\0');
+        
+        if (tar_extract_file(tar, memberPathBuf.data()) != 0)
+        {
+            std::cerr << "could not extract archive" << std::endl;
+            retVal = false;
+            break;
+        }
+        
+        if (progress && archiveSize > 0.0 &&
+            !progress(std::min(1.0, gzoffset(gzf) / archiveSize)))
+        {
+            std::cerr << "archive extraction abandoned" << std::endl;
+            retVal = false;
+            break;
+        }
+    }
+    
+    if (status == -1)
     {
-        std::cerr << "could not extract archive" << std::endl;
+        std::cerr << "could not read archive" << std::endl;
         retVal = false;
     }
     
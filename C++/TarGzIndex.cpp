@@ -0,0 +1,633 @@
+//  File:   TarGzIndex.cpp
+//  Random access to the members of a gzipped tar file through an index of
+//  points at which decompression can resume
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <zlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <climits>
+
+#include <TarGzIndex.h>
+
+// amount of uncompressed data preceding an access point that is needed to
+// resume inflation there
+constexpr int WINDOW_SIZE = 32768;
+// minimum amount of uncompressed data between access points, trading the size
+// of the index for the amount of data inflated and discarded to reach a member
+constexpr uint64_t ACCESS_POINT_SPAN = 1048576;
+// amount of compressed data read from the archive at a time
+constexpr int INPUT_CHUNK_SIZE = 16384;
+// tar files are made up of blocks of this size
+constexpr size_t TAR_BLOCK_SIZE = 512;
+
+constexpr char INDEX_FILE_MAGIC[] = "EMBRTGZ1";
+
+namespace
+{
+// Follows the tar headers in the uncompressed stream as it is produced,
+// recording the location of each regular file.  Handles ustar prefixes as 
+// well as GNU and pax long names.
+class TarParser
+{
+public:
+    TarParser(TarMemberMap& members) :
+    _members(members),
+    _offset(0),
+    _skip(0),
+    _capture(0),
+    _captureType('\0'),
+    _done(false)
+    {
+    }
+    
+    // Returns false if the stream doesn't hold a tar file.
+    bool Parse(const unsigned char* pData, size_t length)
+    {
+        while (length > 0 && !_done)
+        {
+            size_t count;
+            if (_skip > 0)
+            {
+                // member data and padding
+                count = std::min<uint64_t>(length, _skip);
+                size_t capture = std::min<uint64_t>(count, _capture);
+                _captured.append(reinterpret_cast<const char*>(pData), capture);
+                _capture -= capture;
+                _skip -= count;
+            }
+            else
+            {
+                count = std::min(length, TAR_BLOCK_SIZE - _header.size());
+                _header.append(reinterpret_cast<const char*>(pData), count);
+                if (_header.size() == TAR_BLOCK_SIZE)
+                {
+                    // the offset must point past the header before recording
+                    // a member
+                    _offset += count;
+                    pData += count;
+                    length -= count;
+                    if (!ParseHeader())
+                        return false;
+                    _header.clear();
+                    continue;
+                }
+            }
+            
+            _offset += count;
+            pData += count;
+            length -= count;
+        }
+        
+        return true;
+    }
+    
+    // Returns true once the end of the archive has been reached.
+    bool Done() const { return _done; }
+
+private:
+    bool ParseHeader()
+    {
+        const char* h = _header.data();
+        
+        // an empty block marks the end of the archive
+        if (std::count(_header.begin(), _header.end(), '\0') == 
+                                                        (int)TAR_BLOCK_SIZE)
+        {
+            _done = true;
+            return true;
+        }
+        
+        // the checksum covers the header with the checksum field as spaces
+        unsigned int sum = 0;
+        for (size_t i = 0; i < TAR_BLOCK_SIZE; i++)
+            sum += (i >= 148 && i < 156) ? ' ' : (unsigned char)h[i];
+        if (ParseNumber(h + 148, 8) != sum)
+            return false;
+        
+        uint64_t size = ParseNumber(h + 124, 12);
+        char type = h[156];
+        
+        std::string name;
+        if (_captureType == 'L')
+            name = _captured.c_str();
+        else if (_captureType == 'x')
+            name = PaxPath();
+        
+        if (name.empty())
+        {
+            name = std::string(h, strnlen(h, 100));
+            if (memcmp(h + 257, "ustar", 5) == 0 && h[345] != '\0')
+                name = std::string(h + 345, strnlen(h + 345, 155)) + "/" + name;
+        }
+        
+        _captureType = '\0';
+        _captured.clear();
+        _capture = 0;
+        
+        if (type == 'L' || type == 'x')
+        {
+            // the data holds the name for the next header
+            _captureType = type;
+            _capture = size;
+        }
+        else if (type == '0' || type == '\0' || type == '7')
+        {
+            // names are relative to the directory the archive is extracted to
+            while (name.compare(0, 2, "./") == 0)
+                name.erase(0, 2);
+            
+            TarMember member = { _offset, size };
+            _members[name] = member;
+        }
+        
+        _skip = (size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        return true;
+    }
+    
+    // Numeric fields are octal, or base-256 when the high bit is set.
+    static uint64_t ParseNumber(const char* field, size_t length)
+    {
+        uint64_t value = 0;
+        if ((unsigned char)field[0] & 0x80)
+        {
+            value = (unsigned char)field[0] & 0x7F;
+            for (size_t i = 1; i < length; i++)
+                value = (value << 8) | (unsigned char)field[i];
+            return value;
+        }
+        
+        for (size_t i = 0; i < length; i++)
+        {
+            if (field[i] >= '0' && field[i] <= '7')
+                value = (value << 3) | (field[i] - '0');
+            else if (field[i] != ' ' || value != 0)
+                break;
+        }
+        return value;
+    }
+    
+    // Find the path in a captured pax extended header, made up of records of 
+    // the form "<length> <keyword>=<value>\n".
+    std::string PaxPath() const
+    {
+        size_t pos = 0;
+        while (pos < _captured.size())
+        {
+            size_t space = _captured.find(' ', pos);
+            if (space == std::string::npos)
+                break;
+            size_t length = strtoul(_captured.c_str() + pos, NULL, 10);
+            if (length == 0 || pos + length > _captured.size())
+                break;
+            
+            std::string record = _captured.substr(space + 1, 
+                                                  pos + length - space - 2);
+            if (record.compare(0, 5, "path=") == 0)
+                return record.substr(5);
+            
+            pos += length;
+        }
+        return "";
+    }
+    
+    TarMemberMap& _members;
+    std::string _header;    // header block collected so far
+    uint64_t _offset;       // amount of the uncompressed stream parsed
+    uint64_t _skip;         // remaining member data and padding
+    uint64_t _capture;      // remaining member data to be captured
+    char _captureType;      // type of header whose data is being captured
+    std::string _captured;  // data of a long name or pax header
+    bool _done;
+};
+}
+
+// Constructor, taking the path of the archive and the path of the file holding
+// (or to hold) its index
+TarGzIndex::TarGzIndex(const std::string& archivePath, 
+                       const std::string& indexPath) :
+_archivePath(archivePath),
+_indexPath(indexPath)
+{
+}
+
+// Update the locations of the archive and its index after they've been moved.
+void TarGzIndex::SetPaths(const std::string& archivePath, 
+                          const std::string& indexPath)
+{
+    _archivePath = archivePath;
+    _indexPath = indexPath;
+}
+
+// Decompress the entire archive once, writing an index of access points and 
+// the locations of its members to the index file.  Progress is reported to the
+// optional callback after each chunk of the archive, and the callback may 
+// abandon the build.  Returns false if the archive isn't a valid tar.gz file,
+// leaving no index file behind.
+bool TarGzIndex::Build(const ExtractProgressCallback& progress)
+{
+    _points.clear();
+    _members.clear();
+
+    FILE* pArchive = fopen(_archivePath.c_str(), "rb");
+    if (pArchive == NULL)
+        return false;
+    
+    FILE* pIndex = fopen(_indexPath.c_str(), "wb");
+    if (pIndex == NULL)
+    {
+        fclose(pArchive);
+        return false;
+    }
+    
+    bool success = Index(pArchive, pIndex, progress);
+    
+    fclose(pArchive);
+    if (fclose(pIndex) != 0)
+        success = false;
+    
+    if (!success)
+    {
+        remove(_indexPath.c_str());
+        _points.clear();
+        _members.clear();
+    }
+    
+    return success;
+}
+
+// Inflate the archive, following the tar headers and recording an access 
+// point at the first deflate block boundary past each span.  The preceding 
+// 32K of each access point is written to the index file as it's found, with 
+// the table of points and members following.
+bool TarGzIndex::Index(FILE* pArchive, FILE* pIndex, 
+                       const ExtractProgressCallback& progress)
+{
+    struct stat archiveStat;
+    if (fstat(fileno(pArchive), &archiveStat) != 0)
+        return false;
+    uint64_t archiveSize = archiveStat.st_size;
+    
+    // leave room for the header, written once the table's location is known
+    uint64_t placeholder[2] = { 0, 0 };
+    if (fwrite(INDEX_FILE_MAGIC, 8, 1, pIndex) != 1 ||
+        fwrite(placeholder, sizeof(placeholder), 1, pIndex) != 1)
+        return false;
+    
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    // 47 detects and processes a gzip header before the raw deflate data
+    if (inflateInit2(&stream, 47) != Z_OK)
+        return false;
+    
+    std::vector<unsigned char> input(INPUT_CHUNK_SIZE);
+    std::vector<unsigned char> window(WINDOW_SIZE);
+    TarParser parser(_members);
+    uint64_t totalIn = 0;
+    uint64_t totalOut = 0;
+    uint64_t last = 0;
+    bool success = true;
+    int ret = Z_OK;
+    
+    do
+    {
+        stream.avail_in = fread(input.data(), 1, INPUT_CHUNK_SIZE, pArchive);
+        if (ferror(pArchive) || stream.avail_in == 0)
+        {
+            // unreadable or truncated archive
+            success = false;
+            break;
+        }
+        stream.next_in = input.data();
+        
+        // inflate into the window as a circular buffer, stopping at the end
+        // of each deflate block
+        do
+        {
+            if (stream.avail_out == 0)
+            {
+                stream.avail_out = WINDOW_SIZE;
+                stream.next_out = window.data();
+            }
+            
+            unsigned char* pOut = stream.next_out;
+            totalIn += stream.avail_in;
+            totalOut += stream.avail_out;
+            ret = inflate(&stream, Z_BLOCK);
+            totalIn -= stream.avail_in;
+            totalOut -= stream.avail_out;
+            
+            if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR ||
+                !parser.Parse(pOut, stream.next_out - pOut))
+            {
+                success = false;
+                break;
+            }
+            
+            if (ret == Z_STREAM_END)
+                break;
+            
+            // at the end of a block other than the last one, the compressed 
+            // data after it hasn't been consumed except for up to seven bits,
+            // and a point at the very start follows the gzip header
+            if ((stream.data_type & 128) && !(stream.data_type & 64) &&
+                (totalOut == 0 || totalOut - last > ACCESS_POINT_SPAN))
+            {
+                if (!AddPoint(pIndex, stream.data_type & 7, totalIn, totalOut,
+                              stream.avail_out, window))
+                {
+                    success = false;
+                    break;
+                }
+                last = totalOut;
+            }
+        }
+        while (stream.avail_in != 0);
+        
+        if (success && progress && 
+            !progress(std::min(1.0, (double)totalIn / archiveSize)))
+            success = false;
+    }
+    while (success && ret != Z_STREAM_END);
+    
+    inflateEnd(&stream);
+    
+    // a valid archive holds at least one member and its end marker
+    if (!success || !parser.Done() || _members.empty())
+        return false;
+    
+    return WriteTable(pIndex, archiveSize);
+}
+
+// Record an access point, writing the 32K of uncompressed data preceding it,
+// currently in the circular window buffer, to the index file.
+bool TarGzIndex::AddPoint(FILE* pIndex, uint32_t bits, uint64_t in, 
+                          uint64_t out, unsigned int left, 
+                          const std::vector<unsigned char>& window)
+{
+    AccessPoint point;
+    point.out = out;
+    point.in = in;
+    point.bits = bits;
+    point.window = ftello(pIndex);
+    
+    // the oldest data starts at the unused end of the buffer
+    if (left > 0 && 
+        fwrite(window.data() + WINDOW_SIZE - left, 1, left, pIndex) != left)
+        return false;
+    if (left < WINDOW_SIZE && 
+        fwrite(window.data(), 1, WINDOW_SIZE - left, pIndex) != 
+                                                        WINDOW_SIZE - left)
+        return false;
+    
+    _points.push_back(point);
+    return true;
+}
+
+// Write the tables of access points and members following the windows, then
+// fill in the header with the table's location and the size of the archive it
+// describes.
+bool TarGzIndex::WriteTable(FILE* pIndex, uint64_t archiveSize)
+{
+    uint64_t tableOffset = ftello(pIndex);
+    
+    uint32_t count = _points.size();
+    if (fwrite(&count, sizeof(count), 1, pIndex) != 1)
+        return false;
+    for (size_t i = 0; i < _points.size(); i++)
+    {
+        const AccessPoint& p = _points[i];
+        if (fwrite(&p.out, sizeof(p.out), 1, pIndex) != 1 ||
+            fwrite(&p.in, sizeof(p.in), 1, pIndex) != 1 ||
+            fwrite(&p.bits, sizeof(p.bits), 1, pIndex) != 1 ||
+            fwrite(&p.window, sizeof(p.window), 1, pIndex) != 1)
+            return false;
+    }
+    
+    count = _members.size();
+    if (fwrite(&count, sizeof(count), 1, pIndex) != 1)
+        return false;
+    for (TarMemberMap::const_iterator it = _members.begin(); 
+                                      it != _members.end(); it++)
+    {
+        uint32_t length = it->first.size();
+        if (fwrite(&length, sizeof(length), 1, pIndex) != 1 ||
+            fwrite(it->first.data(), 1, length, pIndex) != length ||
+            fwrite(&it->second.offset, sizeof(uint64_t), 1, pIndex) != 1 ||
+            fwrite(&it->second.size, sizeof(uint64_t), 1, pIndex) != 1)
+            return false;
+    }
+    
+    uint64_t header[2] = { archiveSize, tableOffset };
+    return fseeko(pIndex, 8, SEEK_SET) == 0 &&
+           fwrite(header, sizeof(header), 1, pIndex) == 1;
+}
+
+// Read the tables of access points and members from the index file.  Returns
+// false if there is no usable index for the archive.
+bool TarGzIndex::Load()
+{
+    _points.clear();
+    _members.clear();
+    
+    struct stat archiveStat;
+    if (stat(_archivePath.c_str(), &archiveStat) != 0)
+        return false;
+    
+    FILE* pIndex = fopen(_indexPath.c_str(), "rb");
+    if (pIndex == NULL)
+        return false;
+    
+    bool success = false;
+    char magic[8];
+    uint64_t header[2];
+    uint32_t count;
+    
+    // the index must describe this archive
+    if (fread(magic, sizeof(magic), 1, pIndex) == 1 &&
+        memcmp(magic, INDEX_FILE_MAGIC, sizeof(magic)) == 0 &&
+        fread(header, sizeof(header), 1, pIndex) == 1 &&
+        header[0] == (uint64_t)archiveStat.st_size &&
+        fseeko(pIndex, header[1], SEEK_SET) == 0 &&
+        fread(&count, sizeof(count), 1, pIndex) == 1)
+    {
+        success = count > 0;
+        for (uint32_t i = 0; success && i < count; i++)
+        {
+            AccessPoint p;
+            success = fread(&p.out, sizeof(p.out), 1, pIndex) == 1 &&
+                      fread(&p.in, sizeof(p.in), 1, pIndex) == 1 &&
+                      fread(&p.bits, sizeof(p.bits), 1, pIndex) == 1 &&
+                      fread(&p.window, sizeof(p.window), 1, pIndex) == 1 &&
+                      p.bits < 8;
+            _points.push_back(p);
+        }
+        
+        success = success && fread(&count, sizeof(count), 1, pIndex) == 1;
+        for (uint32_t i = 0; success && i < count; i++)
+        {
+            uint32_t length;
+            TarMember member;
+            success = fread(&length, sizeof(length), 1, pIndex) == 1 &&
+                      length <= PATH_MAX;
+            if (!success)
+                break;
+
+            std::string name(length, '\0');
+            success = fread(&name[0], 1, length, pIndex) == length &&
+                      fread(&member.offset, sizeof(uint64_t), 1, pIndex) == 1 &&
+                      fread(&member.size, sizeof(uint64_t), 1, pIndex) == 1;
+            _members[name] = member;
+        }
+    }
+    
+    fclose(pIndex);
+    
+    if (!success)
+    {
+        _points.clear();
+        _members.clear();
+    }
+    
+    return success;
+}
+
+// Returns true if the archive holds a regular file with the specified name.
+bool TarGzIndex::Contains(const std::string& name) const
+{
+    return _members.count(name) > 0;
+}
+
+// Read the contents of the named member into the specified string by resuming
+// inflation at the last access point before it.  Returns false if the archive
+// doesn't hold the member or it can't be read.  Uses no state beyond the 
+// tables, so members may be read from more than one thread.
+bool TarGzIndex::ReadMember(const std::string& name, 
+                            std::string& contents) const
+{
+    TarMemberMap::const_iterator it = _members.find(name);
+    if (it == _members.end() || _points.empty())
+        return false;
+    
+    const TarMember& member = it->second;
+    contents.clear();
+    if (member.size == 0)
+        return true;
+
+    // find the last access point at or before the member's data
+    size_t i = 0;
+    while (i + 1 < _points.size() && _points[i + 1].out <= member.offset)
+        i++;
+    const AccessPoint& point = _points[i];
+    
+    std::vector<unsigned char> window(WINDOW_SIZE);
+    FILE* pIndex = fopen(_indexPath.c_str(), "rb");
+    if (pIndex == NULL)
+        return false;
+    bool haveWindow = fseeko(pIndex, point.window, SEEK_SET) == 0 &&
+                      fread(window.data(), 1, WINDOW_SIZE, pIndex) == 
+                                                                WINDOW_SIZE;
+    fclose(pIndex);
+    if (!haveWindow)
+        return false;
+    
+    FILE* pArchive = fopen(_archivePath.c_str(), "rb");
+    if (pArchive == NULL)
+        return false;
+    
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    if (inflateInit2(&stream, -15) != Z_OK)
+    {
+        fclose(pArchive);
+        return false;
+    }
+    
+    bool success = fseeko(pArchive, point.in - (point.bits ? 1 : 0), 
+                          SEEK_SET) == 0;
+    if (success && point.bits)
+    {
+        // the block starts partway through the preceding byte
+        int c = getc(pArchive);
+        success = c != EOF && 
+                  inflatePrime(&stream, point.bits, c >> (8 - point.bits)) == 
+                                                                        Z_OK;
+    }
+    success = success && 
+              inflateSetDictionary(&stream, window.data(), WINDOW_SIZE) == Z_OK;
+
+    // inflate and discard the data between the access point and the member,
+    // reusing the window as scratch space, then inflate the member itself
+    std::vector<unsigned char> input(INPUT_CHUNK_SIZE);
+    uint64_t skip = member.offset - point.out;
+    uint64_t done = 0;
+    contents.resize(member.size);
+    
+    while (success && done < member.size)
+    {
+        if (skip > 0)
+        {
+            stream.next_out = window.data();
+            stream.avail_out = std::min<uint64_t>(skip, WINDOW_SIZE);
+        }
+        else
+        {
+            stream.next_out = reinterpret_cast<unsigned char*>(&contents[done]);
+            stream.avail_out = std::min<uint64_t>(member.size - done, UINT_MAX);
+        }
+        
+        if (stream.avail_in == 0)
+        {
+            stream.avail_in = fread(input.data(), 1, INPUT_CHUNK_SIZE, 
+                                    pArchive);
+            stream.next_in = input.data();
+            if (stream.avail_in == 0)
+            {
+                success = false;
+                break;
+            }
+        }
+        
+        unsigned int available = stream.avail_out;
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+        {
+            success = false;
+            break;
+        }
+        
+        unsigned int produced = available - stream.avail_out;
+        if (skip > 0)
+            skip -= produced;
+        else
+            done += produced;
+        
+        if (ret == Z_STREAM_END && done < member.size)
+            success = false;
+    }
+    
+    inflateEnd(&stream);
+    fclose(pArchive);
+    
+    if (!success)
+        contents.clear();
+    
+    return success;
+}
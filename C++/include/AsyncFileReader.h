@@ -0,0 +1,109 @@
+//  File:   AsyncFileReader.h
+//  Reads whole files with several reads in flight, using io_uring when the
+//  kernel supports it and synchronous reads otherwise
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ASYNCFILEREADER_H
+#define	ASYNCFILEREADER_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// default number of reads that can be in flight at once
+constexpr int ASYNC_READ_QUEUE_DEPTH = 4;
+// default size of the buffer for each read, larger files are read 
+// synchronously
+constexpr size_t ASYNC_READ_BUFFER_SIZE = 1024 * 1024;
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// Reads are identified by a caller-supplied tag, such as a layer number.
+class AsyncFileReader
+{
+public:
+    AsyncFileReader(int queueDepth = ASYNC_READ_QUEUE_DEPTH, 
+                    size_t bufferSize = ASYNC_READ_BUFFER_SIZE);
+    ~AsyncFileReader();
+    bool IsAsync() const { return _ringFd >= 0; }
+    bool Submit(int tag, const std::string& path);
+    bool IsPending(int tag) const;
+    bool Wait(int tag, std::string& contents);
+    void DiscardOutside(int firstTag, int lastTag);
+    
+private:
+    // This class owns file based resources
+    // Disable copy construction and copy assignment
+    AsyncFileReader(const AsyncFileReader&);
+    AsyncFileReader& operator=(const AsyncFileReader&);
+
+    enum SlotState
+    {
+        Free,
+        InFlight,
+        Completed,
+        Abandoned,  // still in flight, but no one will wait for it
+    };
+    
+    struct Slot
+    {
+        SlotState state;
+        int tag;
+        int fd;
+        size_t size;
+        int result;
+        std::vector<char> buffer;
+        struct iovec iov;
+    };
+
+    bool SetUpRing(int queueDepth);
+    void TearDownRing();
+    bool SubmitToRing(int slotIndex);
+    bool ReapCompletions(bool wait);
+    void FreeSlot(Slot& slot);
+    int FindSlot(int tag) const;
+
+private:
+    int _ringFd;
+    bool _registeredBuffers;
+    std::vector<Slot> _slots;
+    // reads that couldn't be submitted, to be done synchronously on request
+    std::map<int, std::string> _deferredPaths;
+    
+    // io_uring shared memory
+    void* _sqRing;
+    size_t _sqRingSize;
+    void* _cqRing;
+    size_t _cqRingSize;
+    io_uring_sqe* _sqes;
+    size_t _sqesSize;
+    unsigned* _sqHead;
+    unsigned* _sqTail;
+    unsigned* _sqMask;
+    unsigned* _sqArray;
+    unsigned* _cqHead;
+    unsigned* _cqTail;
+    unsigned* _cqMask;
+    io_uring_cqe* _cqes;
+};
+
+#endif    // ASYNCFILEREADER_H
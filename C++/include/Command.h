@@ -26,6 +26,7 @@
 #define	COMMAND_H
 
 #include <limits.h>
+#include <string>
 
 #include "ErrorMessage.h"
 #include "IErrorHandler.h"
@@ -63,14 +64,26 @@ enum Command
     // load print data and settings from print file
     ProcessPrintData,
     
+    // take ownership of the print file at the path given in the command's 
+    // argument, moving it into place rather than copying it, and then load it
+    // like ProcessPrintData
+    AdoptPrintData,
+    
     // show the data loaded screen (for use when just loading settings)
     ShowPrintDataLoaded,
         
     // re-load the settings from the settings file (after it's been changed))
     RefreshSettings,
     
-    // apply print and printer settings from a file
+    // apply print and printer settings from a file, or from the JSON given in
+    // the command's argument, which must then keep the whole command line 
+    // within PIPE_BUF so that it can't be interleaved with other commands
     ApplySettings,
+    
+    // set the value of a single setting, given in the command's argument as 
+    // its name followed by its value, without saving it to the settings file
+    // (though the next save of any other setting will include it)
+    SetSetting,
         
     // Show a test pattern
     Test,
@@ -125,6 +138,13 @@ class ICommandTarget : public IErrorHandler
 public:
     virtual void Handle(Command command) = 0;
     
+    // Handle a command that may carry an argument.  Targets that don't expect
+    // arguments needn't override this.
+    virtual void Handle(Command command, const std::string& argument)
+    {
+        Handle(command);
+    }
+    
 };
 
 #endif    // COMMAND_H
@@ -30,7 +30,8 @@ class DRM_FrameBuffer
 {
 public:
     DRM_FrameBuffer(const DRM_Device& drmDevice,
-                    const DRM_DumbBuffer& drmDumbBuffer, int depth);
+                    const DRM_DumbBuffer& drmDumbBuffer,
+                    uint32_t pixelFormat);
     ~DRM_FrameBuffer();
     uint32_t GetId() const;
 
@@ -33,6 +33,7 @@ public:
     DRM_Resources(const DRM_Device& drmDevice);
     ~DRM_Resources();
     uint32_t GetConnectorId(int connectorIndex) const;
+    int GetCrtcIndex(uint32_t crtcId) const;
 
 private:
     DRM_Resources(const DRM_Resources&);
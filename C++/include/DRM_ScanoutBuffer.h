@@ -0,0 +1,54 @@
+//  File:   DRM_ScanoutBuffer.h
+//  Encapsulates a memory mapped DRM dumb buffer and the DRM frame buffer used
+//  to scan it out, for one video resolution.
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DRM_SCANOUTBUFFER_H
+#define	DRM_SCANOUTBUFFER_H
+
+#include "DRM_DumbBuffer.h"
+#include "DRM_FrameBuffer.h"
+
+class DRM_Device;
+class DRM_Connector;
+
+class DRM_ScanoutBuffer
+{
+public:
+    DRM_ScanoutBuffer(const DRM_Device& drmDevice,
+                      const DRM_Connector& drmConnector,
+                      int width, int height, uint32_t pixelFormat);
+    ~DRM_ScanoutBuffer();
+    uint8_t* GetMap() const;
+    uint32_t GetFrameBufferId() const;
+    const DRM_DumbBuffer& GetDumbBuffer() const;
+    uint32_t GetPixelFormat() const;
+
+private:
+    DRM_ScanoutBuffer(const DRM_ScanoutBuffer&);
+    DRM_ScanoutBuffer& operator=(const DRM_ScanoutBuffer&);
+    static int GetBitsPerPixel(uint32_t pixelFormat);
+
+    DRM_DumbBuffer _drmDumbBuffer;
+    DRM_FrameBuffer _drmFrameBuffer;
+    uint32_t _pixelFormat;
+    uint8_t* _pMap;
+};
+
+#endif  // DRM_SCANOUTBUFFER_H
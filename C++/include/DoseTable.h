@@ -0,0 +1,49 @@
+//  File:   DoseTable.h
+//  Holds the exposure time for every layer of a print, computed once when the
+//  print starts
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DOSETABLE_H
+#define	DOSETABLE_H
+
+#include <string>
+#include <vector>
+
+class LayerSettings;
+class Settings;
+
+// shapes of the exposure ramp from burn-in to model layers
+constexpr const char* LINEAR_RAMP      = "Linear";
+constexpr const char* EXPONENTIAL_RAMP = "Exponential";
+
+class DoseTable
+{
+public:
+    void Build(int numLayers, LayerSettings& perLayer, Settings& settings);
+    void Clear() { _exposureSec.clear(); }
+    bool Contains(int layer) const;
+    double GetExposureSec(int layer) const { return _exposureSec[layer - 1]; }
+    double GetTotalExposureSec(int fromLayer) const;
+    static double GetTemperatureScale(double temperatureC, Settings& settings);
+    
+private:
+    std::vector<double> _exposureSec;
+};
+
+#endif    // DOSETABLE_H
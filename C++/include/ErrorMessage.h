@@ -192,6 +192,20 @@ enum ErrorCode
     CantOpenMemoryDevice = 154,
     CantMapPriorityRegister = 155,
     CantUnMapPriorityRegister = 156,
+    ProjectorVideoSyncTimeout = 157,
+    CantLoadMesh = 158,
+    MetricsSocketCreation = 159,
+    CantStartLoadThread = 160,
+    PrintDataLoadInProgress = 161,
+    USBDriveRemovedWhilePrinting = 162,
+    CantOpenEventRecording = 163,
+    InvalidEventRecording = 164,
+    MissingCommandArgument = 165,
+    MeshTooLarge = 166,
+    CantCopyPrintData = 167,
+    UnexpectedSequenceCompleted = 168,
+    PrintDataNotHandedOver = 169,
+    CantAdoptPrintData = 170,
 
     // Guardrail for valid error codes
     MaxErrorCode
@@ -356,6 +370,20 @@ public:
             messages[CantOpenMemoryDevice] = "Could not open memory device to prevent video flicker";
             messages[CantMapPriorityRegister] = "Could not map priority register to prevent video flicker";
             messages[CantUnMapPriorityRegister] = "Could not un-map priority register to prevent video flicker";
+            messages[ProjectorVideoSyncTimeout] = "Timed out waiting for projector to sync to video, main status: 0x%X";
+            messages[CantLoadMesh] = "Unable to load binary STL mesh: %s";
+            messages[MetricsSocketCreation] = "Error creating socket for serving metrics";
+            messages[CantStartLoadThread] = "Unable to start the print data loading thread";
+            messages[PrintDataLoadInProgress] = "Can't do that while print data is being loaded";
+            messages[USBDriveRemovedWhilePrinting] = "USB drive holding the print data was removed while printing";
+            messages[CantOpenEventRecording] = "Unable to open event recording: %s";
+            messages[InvalidEventRecording] = "Invalid or truncated event recording: %s";
+            messages[MissingCommandArgument] = "Command requires an argument: %d";
+            messages[MeshTooLarge] = "Mesh is larger than the build area: %s";
+            messages[CantCopyPrintData] = "Unable to copy print data from the USB drive to %s";
+            messages[UnexpectedSequenceCompleted] = "Motor controller completed sequence %d instead of the queued approach";
+            messages[PrintDataNotHandedOver] = "Print file to be adopted is not in the hand-off directory: %s";
+            messages[CantAdoptPrintData] = "Unable to move the handed over print file into place: %s";
                     
             messages[UnknownErrorCode] = "Unknown error code: %d";
             initialized = true;
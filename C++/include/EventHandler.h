@@ -29,10 +29,15 @@
 #include <vector>
 
 #include "IResource.h"
+#include "IBackgroundWork.h"
 #include "EventType.h"
 #include "ICallback.h"
 #include "Command.h"
 
+class Histogram;
+class EventRecorder;
+class EventPlayer;
+
 class EventHandler : public ICommandTarget, public ICallback
 {
 typedef std::vector<ICallback*> SubscriptionVec;
@@ -47,6 +52,9 @@ public:
     void Begin(int numIterations);
 #endif    
     void AddEvent(EventType eventType, IResource* pResource);
+    void AddBackgroundWork(IBackgroundWork* pWork);
+    void SetRecorder(EventRecorder* pRecorder) { _pRecorder = pRecorder; }
+    void Replay(EventPlayer& player);
     void Handle(Command command);
     bool HandleError(ErrorCode code, bool fatal, const char* str, int value) 
                                                             { return false; }
@@ -54,11 +62,20 @@ public:
 
 
 private:    
+    void Poll(int timeout, bool replaying);
+    void Dispatch(EventType eventType, const EventData& data);
+    void AwaitBackgroundWork();
+    
     SubscriptionVec _subscriptions[MaxEventTypes];
     int _epollFd;
     std::map<int, std::pair<EventType, IResource*> > _resources;
+    std::vector<IBackgroundWork*> _backgroundWork;
     // exit flag determines if event loop will return on next iteration
     bool _exit; 
+    // time taken to dispatch each batch of events, which delays any others
+    Histogram& _dispatchDuration;
+    // if set, records the events arising from resources as they're dispatched
+    EventRecorder* _pRecorder;
 };
 
 
@@ -0,0 +1,57 @@
+//  File:   EventPlayer.h
+//  Reads recorded events back for replay
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EVENTPLAYER_H
+#define	EVENTPLAYER_H
+
+#include <fstream>
+#include <string>
+
+#include "EventType.h"
+#include "EventData.h"
+
+// An event read back from a recording.
+struct RecordedEvent
+{
+    RecordedEvent() : type(Undefined), time(0.0), data(boost::any()) {}
+    
+    EventType type;
+    // when the event was dispatched, in seconds since recording started
+    double time;
+    EventData data;
+};
+
+// Reads the events recorded by an EventRecorder, in the order in which they
+// were dispatched, for replay by an EventHandler.
+class EventPlayer
+{
+public:
+    EventPlayer(const std::string& path);
+    ~EventPlayer();
+    bool Next(RecordedEvent& event);
+
+private:
+    EventData Decode(EventType eventType, const std::string& payload) const;
+    
+    std::ifstream _file;
+    std::string _path;
+};
+
+#endif    // EVENTPLAYER_H
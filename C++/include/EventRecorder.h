@@ -0,0 +1,55 @@
+//  File:   EventRecorder.h
+//  Records dispatched events for deterministic replay
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EVENTRECORDER_H
+#define	EVENTRECORDER_H
+
+#include <fstream>
+#include <string>
+
+#include "EventType.h"
+#include "EventData.h"
+
+// identifies a file of recorded events, and the version of its format
+constexpr const char* EVENT_RECORDING_MAGIC = "EMBEREV1";
+constexpr int EVENT_RECORDING_MAGIC_LEN = 8;
+
+// Records the events dispatched by an EventHandler to a file, so that the 
+// same sequence of events can later be replayed by an EventPlayer.
+// Following the magic string, the file holds one record per event, 
+// consisting of its type (1 byte), the time it was dispatched in seconds 
+// since recording started (a double), the size of its payload (2 bytes), and 
+// the payload itself, all in the byte order of the machine that recorded it.
+class EventRecorder
+{
+public:
+    EventRecorder(const std::string& path);
+    ~EventRecorder();
+    void Record(EventType eventType, const EventData& data);
+    static bool IsRecorded(EventType eventType);
+
+private:
+    static std::string Encode(EventType eventType, const EventData& data);
+    
+    std::ofstream _file;
+    double _startTime;
+};
+
+#endif    // EVENTRECORDER_H
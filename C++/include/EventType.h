@@ -82,6 +82,12 @@ enum EventType
     // Fired when a user removes a usb drive
     USBDriveDisconnected,
     
+    // Fired when a metrics scraper connects.  Answered by the resource itself.
+    MetricsRequest,
+    
+    // Fired as the print data loader makes progress, and when it finishes.
+    PrintDataLoad,
+    
     // Guardrail for valid event types.
     MaxEventTypes,
 };
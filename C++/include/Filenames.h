@@ -39,6 +39,7 @@ constexpr const char* UUID_FILE               = "/proc/sys/kernel/random/uuid";
 
 constexpr const char* SLICE_IMAGE_PREFIX       = "slice_";
 constexpr const char* SLICE_IMAGE_EXTENSION    = "png";
+constexpr const char* MESH_FILE                = "model.stl";
 constexpr const char* FILE_FILTER_PREFIX       = "/*.";
 
 constexpr const char* PRINT_FILE_FILTER_TARGZ = "/*.tar.gz";
@@ -57,6 +58,13 @@ constexpr const char* USB_DRIVE_MOUNT_POINT = "/mnt/usb";
 // print data
 constexpr const char* PRINT_DATA_NAME = "print";
 
+// name of the copy, in the staging directory, of print data being printed 
+// directly from a USB drive
+constexpr const char* USB_PRINT_DATA_COPY_NAME = "usb_print_copy.zip";
+
+// appended to the name of a tar.gz print file to name the index of its contents
+constexpr const char* PRINT_DATA_INDEX_EXTENSION = ".index";
+
 constexpr const char* PROJECTOR_FW_FILE = "/lib/projector/Autodesk_3_0_no_images.bin";
 
 constexpr const char* DRM_DEVICE_NODE = "/dev/dri/card0";
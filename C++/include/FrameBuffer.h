@@ -26,6 +26,8 @@
 #ifndef FRAMEBUFFER_H
 #define	FRAMEBUFFER_H
 
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "IFrameBuffer.h"
@@ -33,26 +35,35 @@
 #include "DRM_Resources.h"
 #include "DRM_Connector.h"
 #include "DRM_Encoder.h"
-#include "DRM_DumbBuffer.h"
-#include "DRM_FrameBuffer.h"
+#include "DRM_ScanoutBuffer.h"
+
+// scanout buffers are kept for each resolution used, keyed by width and height
+typedef std::pair<int, int> Resolution;
+typedef std::map<Resolution, std::unique_ptr<DRM_ScanoutBuffer>> 
+                                                            ScanoutBufferMap;
 
 class FrameBuffer : public IFrameBuffer
 {
 public:
-    FrameBuffer(int width, int height);
+    FrameBuffer(int width, int height, bool allowRGB565 = false);
     ~FrameBuffer();
     void Blit(Magick::Image& image);
     void Fill(uint8_t value);
     void Swap();
+    void SetResolution(int width, int height);
 
 private:
+    uint32_t SelectPixelFormat(bool allowRGB565);
+    bool IsPrimaryPlane(uint32_t planeId);
+    bool LoadGreyPalette();
+
     DRM_Device _drmDevice;
     DRM_Resources _drmResources;
     DRM_Connector _drmConnector;
     DRM_Encoder _drmEncoder;
-    DRM_DumbBuffer _drmDumbBuffer;
-    DRM_FrameBuffer _drmFrameBuffer;
-    uint8_t* _pFrameBufferMap;
+    uint32_t _pixelFormat;
+    ScanoutBufferMap _scanoutBuffers;
+    DRM_ScanoutBuffer* _pScanoutBuffer;
     std::vector<uint8_t> _image;
 };
 
@@ -115,6 +115,11 @@ constexpr int PROJECTOR_SYSTEM_MEMORY_FLAG     = 0x01;
 constexpr int PROJECTOR_MAIN_STATUS_REG        = 0x22;
 // main status register Gamma Correction Function Enabled bit mask
 constexpr int PROJECTOR_GAMMA_ENABLED          = 1 << 3;
+// main status register Sequencer Run Flag and Video Frame Buffer Freeze Flag 
+// bit masks, used to determine when the projector has synced to its video 
+// source
+constexpr int PROJECTOR_SEQUENCER_RUNNING      = 1 << 1;
+constexpr int PROJECTOR_VIDEO_FROZEN           = 1 << 2;
 // LED(s) enable register
 constexpr int PROJECTOR_LED_ENABLE_REG         = 0x10;
 // values to enable or disable the projector's LED(s)
@@ -188,6 +193,9 @@ constexpr unsigned char FLASH_BUSY_STATUS       = 0x08;
 constexpr unsigned int VIDEO_MODE_WIDTH  =  1280;
 constexpr unsigned int VIDEO_MODE_HEIGHT =  800;
 
+// size of a video mode pixel at the build plane
+constexpr double VIDEO_MODE_PIXEL_SIZE_MICRONS = 50.0;
+
 // video resolution for pattern mode
 constexpr unsigned int PATTERN_MODE_WIDTH  =  912;
 constexpr unsigned int PATTERN_MODE_HEIGHT =  1140;
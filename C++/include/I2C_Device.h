@@ -27,6 +27,8 @@
 
 #include "I_I2C_Device.h"
 
+class Counter;
+
 class I2C_Device : public I_I2C_Device
 {
 public:
@@ -50,6 +52,8 @@ private:
     I2C_Device& operator=(const I2C_Device&);
 
     int _fd;
+    // number of times a device was found not yet ready
+    Counter& _notReadyRetries;
 };
 
 
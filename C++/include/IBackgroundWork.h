@@ -0,0 +1,35 @@
+//  File:   IBackgroundWork.h
+//  Interface to work done on threads other than the event loop
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef IBACKGROUNDWORK_H
+#define	IBACKGROUNDWORK_H
+
+class IBackgroundWork
+{
+public:
+    virtual ~IBackgroundWork() {}
+    
+    // Wait for any work in progress to finish, so that its results don't
+    // depend on how long the event loop takes to get to them, as when 
+    // replaying recorded events.  Returns true if there was work to wait for.
+    virtual bool AwaitCompletion() = 0;
+};
+
+#endif    // IBACKGROUNDWORK_H
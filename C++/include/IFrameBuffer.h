@@ -38,6 +38,7 @@ public:
     virtual void Blit(Magick::Image& image) = 0;
     virtual void Fill(uint8_t value) = 0;
     virtual void Swap() = 0;
+    virtual void SetResolution(int width, int height) = 0;
 };
 
 #endif  // IFRAMEBUFFER_H
@@ -28,8 +28,11 @@
 #include <stdint.h>
 
 #include "EventData.h"
+#include "LayerArena.h"
 
-typedef std::vector<EventData> EventDataVec;
+// event data only lives until it's been dispatched, so it's allocated from the
+// layer arena
+typedef std::vector<EventData, ArenaAllocator<EventData> > EventDataVec;
 
 class IResource
 {
@@ -32,6 +32,7 @@ public:
     ~ImageProcessor();
     void Scale(Magick::Image* pImage, double scale);
     Magick::Image* MapForPatternMode(Magick::Image& imageIn);
+    double GetLitFraction(Magick::Image& image);
     
 private:
     Magick::Image _patternModeImage;
@@ -0,0 +1,98 @@
+//  File:   LayerArena.h
+//  Resettable monotonic arena for short-lived allocations made while printing
+//  each layer
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LAYERARENA_H
+#define	LAYERARENA_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+#include <Metrics.h>
+
+// size of the arena's buffer, enough for the transient allocations of a 
+// layer's worth of event handling and motor commands
+constexpr size_t LAYER_ARENA_SIZE = 65536;
+
+// Singleton handing out memory from a fixed buffer by bumping an offset.
+// Freeing is nearly free, and the offset rewinds to the start of the buffer
+// whenever everything handed out has been freed.  Only the thread that 
+// created the arena (the event loop's) allocates from it; requests from other
+// threads, or that don't fit, fall back to the heap.
+class LayerArena
+{
+public:
+    static LayerArena& Instance();
+    void* Allocate(size_t bytes, size_t alignment);
+    void Deallocate(void* p);
+    void Reset();
+    size_t GetUsed() const { return _offset; }
+    
+private:
+    LayerArena();
+    LayerArena(LayerArena const&);
+    LayerArena& operator=(LayerArena const&);
+    
+    alignas(16) char _buffer[LAYER_ARENA_SIZE];
+    size_t _offset;      // start of the unused part of the buffer
+    size_t _outstanding; // number of allocations not yet freed
+    size_t _peak;        // largest offset since the last reset
+    pthread_t _owner;
+    Gauge& _peakGauge;
+    Counter& _overflows;
+};
+
+// Allocator for standard containers that draws from the layer arena
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    
+    ArenaAllocator() {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+    
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(LayerArena::Instance().Allocate(n * sizeof(T), 
+                                                               alignof(T)));
+    }
+    
+    void deallocate(T* p, size_t)
+    {
+        LayerArena::Instance().Deallocate(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&)
+{
+    return false;
+}
+
+#endif    // LAYERARENA_H
+
@@ -34,6 +34,7 @@ public:
     bool Load(const std::string& layerParams);
     int GetInt(int layer, std::string name);
     double GetDouble(int layer, std::string name);
+    bool Overrides(int layer, std::string name);
     void Clear();
     
 private:
@@ -44,6 +45,14 @@ private:
 
 };
 
+// The different types of layers that may be printed
+enum LayerType
+{
+    First,
+    BurnIn,
+    Model
+};
+
 // Holds the values of all print settings to use for a single layer 
 struct CurrentLayerSettings
 {
@@ -65,6 +74,7 @@ struct CurrentLayerSettings
     int ApproachZJerk;
     int ApproachMicronsPerSec;
     int LayerThicknessMicrons;
+    LayerType Type;
     
     // these are included to avoid changes while pause & inspect is in progress
     bool CanInspect;
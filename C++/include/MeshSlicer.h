@@ -0,0 +1,93 @@
+//  File:   MeshSlicer.h
+//  Slices a triangle mesh into filled cross sections
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MESHSLICER_H
+#define	MESHSLICER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct MeshVertex
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct MeshTriangle
+{
+    MeshVertex v[3];
+    float minZ;
+    float maxZ;
+};
+
+// Cross sections are expected to be requested at increasing heights, so the 
+// triangles crossing each plane are found by sweeping through the triangles 
+// sorted by their lowest vertex, rather than by testing the whole mesh.
+class MeshSlicer
+{
+public:
+    MeshSlicer();
+    bool LoadBinarySTL(const std::string& filePath);
+    bool IsEmpty() const;
+    double GetHeight() const;
+    double GetWidth() const;
+    double GetDepth() const;
+    void Slice(double z, int width, int height, double pixelSize,
+               std::vector<uint8_t>& pixels);
+
+private:
+    // a line segment where a triangle crosses the slicing plane, directed so
+    // that the solid lies to its left when viewed from above
+    struct Segment
+    {
+        double x0, y0;
+        double x1, y1;
+    };
+    
+    // a segment crossing the centers of one or more rows of pixels
+    struct Edge
+    {
+        int firstRow;
+        int lastRow;
+        double x;       // x coordinate where the edge crosses the current row
+        double dxdy;    // change in x per row
+        int winding;    // +1 or -1 depending on the edge's direction
+    };
+    
+    void UpdateActiveTriangles(double z);
+    void Intersect(double z, std::vector<Segment>& segments) const;
+    void Fill(const std::vector<Segment>& segments, int width, int height,
+              double pixelSize, std::vector<uint8_t>& pixels) const;
+
+    std::vector<MeshTriangle> _triangles; // sorted by lowest vertex
+    std::vector<size_t> _activeTriangles;
+    size_t _nextTriangle;
+    double _lastZ;
+    double _minZ;
+    double _maxZ;
+    double _centerX;
+    double _centerY;
+    double _width;
+    double _depth;
+};
+
+#endif    // MESHSLICER_H
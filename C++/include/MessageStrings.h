@@ -45,7 +45,12 @@ constexpr const char*  LOG_UI_COMMAND            = "UI command: %s";
 constexpr const char*  LOG_TEMPERATURE_PRINTING  = "printing layer #%d of %d: temperature = %g";
 constexpr const char*  LOG_TEMPERATURE           = "temperature = %g";
 constexpr const char*  LOG_JAM_DETECTED          = "jam detected at layer %d: temperature = %g";
+constexpr const char*  LOG_EXPOSURE_RAMP         = "exposure ramp over %d layers (%s) from %g to %g seconds";
+constexpr const char*  LOG_ADAPTIVE_DELAY        = "layer #%d: %s delay of %d ms shortened to %d ms (%.1f%% lit, %d layers without jams)";
+constexpr const char*  LOG_PRINT_DATA_LOAD_CANCELED = "canceled loading of print data";
+constexpr const char*  LOG_SKIPPING_HOMING       = "skipping homing, motors already at home";
 constexpr const char*  LOG_NO_PROJECTOR_I2C      = "no I2C connection to projector";
+constexpr const char*  LOG_USING_PRINT_DATA_COPY = "print data copied from the USB drive to %s";
 constexpr const char*  LOG_INVALID_MOTOR_COMMAND = "register: 0x%x, command: 0x%x";
 
 constexpr const char*  UNKNOWN_REGISTRATION_CODE = "unknown code";
@@ -0,0 +1,136 @@
+//  File:   Metrics.h
+//  Registry of performance metrics, exported in Prometheus text format
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef METRICS_H
+#define	METRICS_H
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <ostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// metric names
+constexpr const char* LAYER_CYCLE_METRIC     = "smith_layer_cycle_seconds";
+constexpr const char* IMAGE_PREP_METRIC      = "smith_image_prep_seconds";
+constexpr const char* DISPATCH_METRIC        = "smith_event_dispatch_seconds";
+constexpr const char* I2C_RETRIES_METRIC     = "smith_i2c_retries_total";
+constexpr const char* JAMS_METRIC            = "smith_jams_total";
+constexpr const char* TEMPERATURE_METRIC     = "smith_temperature_celsius";
+constexpr const char* LAYER_ARENA_PEAK_METRIC      = "smith_layer_arena_peak_bytes";
+constexpr const char* LAYER_ARENA_OVERFLOWS_METRIC = "smith_layer_arena_overflows_total";
+
+class Metric
+{
+public:
+    Metric(const std::string& name, const std::string& help) : 
+    _name(name), _help(help) {}
+    virtual ~Metric() {}
+    void Write(std::ostream& out) const;
+    
+protected:
+    virtual const char* GetType() const = 0;
+    virtual void WriteSamples(std::ostream& out) const = 0;
+    
+    std::string _name;
+    std::string _help;
+};
+
+// A count that only goes up.  Safe to increment from any thread.
+class Counter : public Metric
+{
+public:
+    Counter(const std::string& name, const std::string& help) :
+    Metric(name, help), _value(0) {}
+    void Increment(uint64_t amount = 1) 
+    { 
+        _value.fetch_add(amount, std::memory_order_relaxed); 
+    }
+    uint64_t GetValue() const { return _value.load(); }
+    
+protected:
+    const char* GetType() const { return "counter"; }
+    void WriteSamples(std::ostream& out) const;
+    
+private:
+    std::atomic<uint64_t> _value;
+};
+
+// A value that can go up and down.  Safe to set from any thread.
+class Gauge : public Metric
+{
+public:
+    Gauge(const std::string& name, const std::string& help) :
+    Metric(name, help), _value(0.0) {}
+    void Set(double value) { _value.store(value, std::memory_order_relaxed); }
+    double GetValue() const { return _value.load(); }
+    
+protected:
+    const char* GetType() const { return "gauge"; }
+    void WriteSamples(std::ostream& out) const;
+    
+private:
+    std::atomic<double> _value;
+};
+
+// Counts of observed values falling at or below each of a set of bounds.
+// Only observe values from the event loop's thread.
+class Histogram : public Metric
+{
+public:
+    Histogram(const std::string& name, const std::string& help,
+              const std::vector<double>& upperBounds);
+    void Observe(double value);
+    uint64_t GetCount() const { return _count; }
+    
+protected:
+    const char* GetType() const { return "histogram"; }
+    void WriteSamples(std::ostream& out) const;
+    
+private:
+    std::vector<double> _upperBounds;
+    std::vector<uint64_t> _bucketCounts;
+    uint64_t _count;
+    double _sum;
+};
+
+// Singleton holding all the metrics.  Metrics are created when first 
+// requested, so clients should look them up once and keep the reference.
+class Metrics
+{
+public:
+    static Metrics& Instance();
+    Counter& GetCounter(const std::string& name, const std::string& help);
+    Gauge& GetGauge(const std::string& name, const std::string& help);
+    Histogram& GetHistogram(const std::string& name, const std::string& help,
+                            const std::vector<double>& upperBounds);
+    std::string ToPrometheusText() const;
+    
+private:
+    Metrics() {}
+    Metrics(Metrics const&);
+    Metrics& operator=(Metrics const&);
+    
+    std::map<std::string, std::unique_ptr<Metric>> _metrics;
+};
+
+#endif    // METRICS_H
@@ -0,0 +1,46 @@
+//  File:   MetricsServer.h
+//  Serves the metrics registry to scrapers on a loopback HTTP port
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef METRICSSERVER_H
+#define	METRICSSERVER_H
+
+#include "IResource.h"
+
+class MetricsServer : public IResource
+{
+public:
+    MetricsServer(int port);
+    ~MetricsServer();
+    uint32_t GetEventTypes() const;
+    int GetFileDescriptor() const;
+    EventDataVec Read();
+    bool QualifyEvents(uint32_t events) const;
+
+private:
+    // This class owns a socket
+    // Disable copy construction and copy assignment
+    MetricsServer(const MetricsServer&);
+    MetricsServer& operator=(const MetricsServer&);
+
+private:
+    int _listenFd;
+};
+
+#endif    // METRICSSERVER_H
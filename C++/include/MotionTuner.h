@@ -0,0 +1,45 @@
+//  File:   MotionTuner.h
+//  Finds the fastest separation and approach profiles that run reliably on a
+//  given printer, and records them in its settings
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MOTIONTUNER_H
+#define	MOTIONTUNER_H
+
+#include "LayerSettings.h"
+#include "IMotionTrial.h"
+
+class Settings;
+
+class MotionTuner
+{
+public:
+    MotionTuner(Settings& settings, IMotionTrial& trial);
+    double Tune(const CurrentLayerSettings& cls);
+    static void Scale(CurrentLayerSettings& cls, double factor);
+    
+private:
+    bool RunTrials(const CurrentLayerSettings& cls, double factor);
+    void Record(const CurrentLayerSettings& cls);
+    
+    Settings& _settings;
+    IMotionTrial& _trial;
+};
+
+#endif    // MOTIONTUNER_H
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include <MotorCommand.h>
+#include <LayerArena.h>
 #include <PrinterStatus.h>
 #include <LayerSettings.h>
 #include <Settings.h>
@@ -44,6 +45,11 @@ constexpr int UNITS_PER_REVOLUTION = 360 * 10; // deci-degrees in a full circle
 constexpr int R_SPEED_FACTOR = UNITS_PER_REVOLUTION;
 constexpr int Z_SPEED_FACTOR = 60;
 
+// the commands for a move only live until they're sent, so they're allocated
+// from the layer arena
+typedef std::vector<MotorCommand, ArenaAllocator<MotorCommand> > 
+                                                            MotorCommandVec;
+
 class I_I2C_Device;
 
 class Motor
@@ -59,20 +65,27 @@ public:
     bool ClearPendingCommands(bool withInterrupt = false);
     bool GoHome(bool withInterrupt = true, bool rotateHome = true, 
                                            bool stayOpen = false);
-    bool GoToStartPosition();
+    bool GoToStartPosition(bool homeFirst = true);
     bool Separate(const CurrentLayerSettings& cls);
     bool Approach(const CurrentLayerSettings& cls, bool unJamFirst = false);
+    bool QueueApproach(const CurrentLayerSettings& cls, int& tag);
     bool PauseAndInspect(const CurrentLayerSettings& cls);
     bool ResumeFromInspect(const CurrentLayerSettings& cls);
     bool UnJam(const CurrentLayerSettings& cls, bool withInterrupt = true);
     bool Press(const CurrentLayerSettings& cls);
     bool Unpress(const CurrentLayerSettings& cls);
+    bool ReadQueueStatus(int& lastCompletedTag, int& freeSlots);
     
 private:
-    bool SendCommands(std::vector<MotorCommand> commands);
+    bool SendCommands(MotorCommandVec& commands);
+    void RequestInterrupt(MotorCommandVec& commands);
+    void AddApproachCommands(const CurrentLayerSettings& cls, 
+                             MotorCommandVec& commands);
 
     const I_I2C_Device& _i2cDevice;
     Settings& _settings;
+    // tag of the last sequence of commands sent with an interrupt request
+    int _lastTag;
 };
 
 #endif    // MOTOR_H
@@ -52,11 +52,35 @@ constexpr uint8_t MC_ROT_SETTINGS_REG   = 0xA2; // for rotation settings
 constexpr uint8_t MC_ROT_ACTION_REG     = 0xA3; // for rotation actions 
 constexpr uint8_t MC_Z_SETTINGS_REG     = 0xA4; // for Z axis settings  
 constexpr uint8_t MC_Z_ACTION_REG       = 0xA5; // for Z axis actions
-constexpr uint8_t MC_COMMAND_REG_HIGH_FENCEPOST = 0xA6;
+constexpr uint8_t MC_SEQUENCE_REG       = 0xA6; // for sequence tags
+constexpr uint8_t MC_COMMAND_REG_HIGH_FENCEPOST = 0xA7;
 
-// status (read-only) register address 
+// status (read-only) register addresses 
 // gives motor controller status
 constexpr uint8_t MC_STATUS_REG             = 0x30;
+// gives the tag of the last completed sequence, followed by the number of 
+// commands that can be sent without overflowing the motor controller's queues
+constexpr uint8_t MC_QUEUE_REG              = 0x31;
+
+// profiling (read-only) register addresses, one for each interrupt service
+// routine and state machine event profiled by the motor controller firmware
+// when it's built with PROFILE=1 (otherwise they read as all zeros)
+// Each gives the maximum time spent in one call, the number of calls, and the
+// total time spent in those calls, as little-endian 16, 16, and 32 bit
+// integers, with times in ticks of MC_PROFILE_CYCLES_PER_TICK CPU cycles.
+// When the number of calls would overflow, it and the total are halved.
+constexpr uint8_t MC_PROFILE_REG_LOW_FENCEPOST = 0x3F;
+constexpr uint8_t MC_PROFILE_DDA_ISR_REG    = 0x40; // step generation
+constexpr uint8_t MC_PROFILE_EXEC_ISR_REG   = 0x41; // move execution
+constexpr uint8_t MC_PROFILE_LOAD_ISR_REG   = 0x42; // move loading
+constexpr uint8_t MC_PROFILE_I2C_ISR_REG    = 0x43; // I2C communication
+// followed by one register for each of the MC_PROFILE_EVENT_COUNT state
+// machine events, in the order of their codes in StateMachine_smdefs.h
+constexpr uint8_t MC_PROFILE_EVENT_REG      = 0x44;
+constexpr uint8_t MC_PROFILE_EVENT_COUNT    = 18;
+constexpr uint8_t MC_PROFILE_REG_HIGH_FENCEPOST = 0x56;
+constexpr uint8_t MC_PROFILE_DATA_SIZE      = 8;
+constexpr uint8_t MC_PROFILE_CYCLES_PER_TICK = 8;
 
 // general motor controller commands (with no argument)
 constexpr uint8_t MC_GENERAL_LOW_FENCEPOST = 0;
@@ -92,6 +116,13 @@ constexpr uint8_t MC_MOVE             = 1; // move by specified amount (units)
 constexpr uint8_t MC_HOME             = 2;
 constexpr uint8_t MC_ACTION_HIGH_FENCEPOST = 3;
 
+// sequence command (with tag argument, x, from 1 to MC_MAX_TAG)
+// generate an interrupt when all preceding commands have completed, like 
+// MC_INTERRUPT, and report x as the tag of the last completed sequence
+constexpr uint8_t MC_TAG              = 1;
+constexpr uint8_t MC_SEQUENCE_HIGH_FENCEPOST = 2;
+constexpr uint8_t MC_MAX_TAG          = 255;
+
 // status codes
 // success, no errors
 constexpr uint8_t MC_STATUS_SUCCESS                              = 0;  
@@ -0,0 +1,36 @@
+//  File:   PixelConversion.h
+//  Converts rows of 8-bit grey slice pixels into the formats scanned out by
+//  the display controller
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PIXELCONVERSION_H
+#define	PIXELCONVERSION_H
+
+#include <stdint.h>
+
+// Pack an 8-bit grey level into a 5-6-5 RGB pixel.
+inline uint16_t GreyToRGB565(uint8_t value)
+{
+    return ((value >> 3) << 11) | ((value >> 2) << 5) | (value >> 3);
+}
+
+void GreyRowToRGB565(const uint8_t* pSource, uint16_t* pDest, int width);
+void GreyRowToXRGB8888(const uint8_t* pSource, uint32_t* pDest, int width);
+
+#endif    // PIXELCONVERSION_H
@@ -28,6 +28,8 @@
 #include <string>
 #include <Magick++.h>
 
+#include "TarGzFile.h"
+
 class PrintFileStorage;
 
 class PrintData
@@ -41,10 +43,22 @@ public:
     virtual bool Move(const std::string& destination) = 0;
     virtual bool GetImageForLayer(int layer, Magick::Image* pImage) = 0;
     virtual int GetLayerCount() = 0;
+    // Gives print data on slow storage a chance to read upcoming layers 
+    // while the given one is being printed
+    virtual void ReadAhead(int layer) {}
+    // Returns true if reading the print data still depends on removable 
+    // storage, such as a USB drive, e.g. because it hasn't been copied off yet
+    virtual bool IsOnRemovableStorage() { return false; }
+    // Gives print data that's sliced as it's printed the layer thickness, in
+    // microns, that its layer count and images are for
+    virtual void SetLayerThickness(int microns) {}
     
     static PrintData* CreateFromNewData(const PrintFileStorage& storage,
-        const std::string& dataParentDirectory, const std::string& newName);
+        const std::string& dataParentDirectory, const std::string& newName,
+        const ExtractProgressCallback& progress = ExtractProgressCallback());
     static PrintData* CreateFromExistingData(const std::string& printDataPath);
+    static PrintData* CreateFromRemovableStorage(const std::string& filePath,
+        int readAheadLayers, const std::string& copyPath = "");
 };
 
 #endif    // PRINTDATA_H
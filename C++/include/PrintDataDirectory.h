@@ -25,7 +25,10 @@
 #ifndef PRINTDATADIRECTORY_H
 #define	PRINTDATADIRECTORY_H
 
+#include <boost/scoped_ptr.hpp>
+
 #include <PrintData.h>
+#include <AsyncFileReader.h>
 
 class PrintDataDirectory : public PrintData
 {
@@ -38,12 +41,16 @@ public:
     bool Move(const std::string& destination);
     bool GetImageForLayer(int layer, Magick::Image* pImage);
     int GetLayerCount();
+    void ReadAhead(int layer);
 
 private:
     std::string GetLayerFileName(int layer);
 
 private:
     std::string _directoryPath; // the directory containing the print data
+    // keeps reads of upcoming slice images in flight while printing, created
+    // only once an image is needed
+    boost::scoped_ptr<AsyncFileReader> _pReader;
 };
 
 #endif    // PRINTDATADIRECTORY_H
@@ -0,0 +1,109 @@
+//  File:   PrintDataLoader.h
+//  Stages, extracts, and validates incoming print data on a worker thread,
+//  reporting progress to the event loop
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRINTDATALOADER_H
+#define	PRINTDATALOADER_H
+
+#include <atomic>
+#include <string>
+#include <pthread.h>
+
+#include "IResource.h"
+#include "IBackgroundWork.h"
+#include "ErrorMessage.h"
+
+class PrintData;
+
+// Payload of the PrintDataLoad event
+struct PrintDataLoadStatus
+{
+    // how much of the load is complete, from 0 to 100
+    int percent;
+    // the worker thread has exited and its results can be collected
+    bool finished;
+};
+
+class PrintDataLoader : public IResource, public IBackgroundWork
+{
+public:
+    PrintDataLoader();
+    ~PrintDataLoader();
+    uint32_t GetEventTypes() const;
+    int GetFileDescriptor() const;
+    EventDataVec Read();
+    bool QualifyEvents(uint32_t events) const;
+    bool AwaitCompletion();
+    bool Start(const std::string& sourcePath, const std::string& downloadDir,
+               const std::string& stagingDir, const std::string& newName,
+               int layerThickness, const std::string& adoptedName = "");
+    bool StartDirect(const std::string& sourcePath, int readAheadLayers,
+                     const std::string& copyPath = "");
+    void Cancel();
+    bool IsLoading() const { return _loading; }
+    bool IsDirect() const { return _direct; }
+    bool WasCanceled() const { return _canceled; }
+    ErrorCode GetResult() const { return _result; }
+    std::string GetFileName() const { return _fileName; }
+    bool GetEmbeddedSettings(std::string& settings) const;
+    PrintData* ReleasePrintData();
+
+private:
+    // This class owns a file based resource and a thread
+    // Disable copy construction and copy assignment
+    PrintDataLoader(const PrintDataLoader&);
+    PrintDataLoader& operator=(const PrintDataLoader&);
+
+    bool StartThread();
+    void Load();
+    void LoadDirect();
+    bool SetProgress(int percent);
+    void Signal();
+    static void* InBackground(void* context);
+
+private:
+    int _fd;
+    pthread_t _thread;
+    bool _loading;
+    std::atomic<int> _percent;
+    std::atomic<bool> _finished;
+    std::atomic<bool> _cancelRequested;
+
+    // inputs to the worker thread, set before it starts
+    std::string _sourcePath;
+    std::string _downloadDir;
+    std::string _stagingDir;
+    std::string _newName;
+    std::string _adoptedName;
+    int _layerThickness;
+    bool _direct;
+    int _readAheadLayers;
+    std::string _copyPath;
+    
+    // results of the worker thread, only read after it has been joined
+    bool _canceled;
+    ErrorCode _result;
+    std::string _fileName;
+    bool _haveEmbeddedSettings;
+    std::string _embeddedSettings;
+    PrintData* _pPrintData;
+};
+
+#endif    // PRINTDATALOADER_H
@@ -0,0 +1,49 @@
+//  File:   PrintDataMesh.h
+//  Handles print data holding a mesh that's sliced as each layer is needed
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRINTDATAMESH_H
+#define	PRINTDATAMESH_H
+
+#include <vector>
+#include <atomic>
+
+#include <PrintDataDirectory.h>
+#include <MeshSlicer.h>
+
+class PrintDataMesh : public PrintDataDirectory
+{
+public:
+    PrintDataMesh(const std::string& directoryPath);
+    virtual ~PrintDataMesh();
+    bool Validate();
+    bool GetImageForLayer(int layer, Magick::Image* pImage);
+    int GetLayerCount();
+    void SetLayerThickness(int microns);
+    
+    static bool ContainsMesh(const std::string& directoryPath);
+
+private:
+    MeshSlicer _slicer;
+    std::vector<uint8_t> _pixels;
+    // set from the event loop but read while loading or printing, so atomic
+    std::atomic<int> _layerThickness;
+};
+
+#endif    // PRINTDATAMESH_H
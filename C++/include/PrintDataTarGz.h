@@ -0,0 +1,51 @@
+//  File:   PrintDataTarGz.h
+//  Handles data stored in a tar.gz file for the 3D model to be printed,
+//  reading its members in place through an index rather than extracting it
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRINTDATATARGZ_H
+#define	PRINTDATATARGZ_H
+
+#include <PrintData.h>
+#include <TarGzIndex.h>
+
+class PrintDataTarGz : public PrintData
+{
+public:
+    PrintDataTarGz(const std::string& filePath);
+    virtual ~PrintDataTarGz();
+    bool Validate();
+    bool GetFileContents(const std::string& fileName, std::string& contents);
+    bool Remove();
+    bool Move(const std::string& destination);
+    bool GetImageForLayer(int layer, Magick::Image* pImage);
+    int GetLayerCount();
+    
+    static std::string GetIndexPath(const std::string& filePath);
+
+private:
+    std::string GetLayerFileName(int layer);
+
+private:
+    std::string _filePath; // the path to the tar.gz file backing this instance
+    TarGzIndex _index;     // locations of the archive's members
+};
+
+#endif    // PRINTDATATARGZ_H
+
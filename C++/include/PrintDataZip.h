@@ -24,6 +24,11 @@
 #ifndef PRINTDATAZIP_H
 #define	PRINTDATAZIP_H
 
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <pthread.h>
+#include <boost/scoped_ptr.hpp>
 #include <zpp.h>
 
 #include <PrintData.h>
@@ -31,7 +36,8 @@
 class PrintDataZip : public PrintData
 {
 public:
-    PrintDataZip(const std::string& filePath);
+    PrintDataZip(const std::string& filePath, bool ownsFile = true,
+                 int readAheadLayers = 0, const std::string& copyPath = "");
     virtual ~PrintDataZip();
     bool Validate();
     bool GetFileContents(const std::string& fileName, std::string& contents);
@@ -39,15 +45,49 @@ public:
     bool Move(const std::string& destination);
     bool GetImageForLayer(int layer, Magick::Image* pImage);
     int GetLayerCount();
+    void ReadAhead(int layer);
+    bool IsOnRemovableStorage();
+    void AwaitReadAhead();
 
     static void Initialize();
 
 private:
+    // This class owns a thread
+    // Disable copy construction and copy assignment
+    PrintDataZip(const PrintDataZip&);
+    PrintDataZip& operator=(const PrintDataZip&);
+
     std::string GetLayerFileName(int layer);
+    bool ReadLayerFile(int layer, std::string& contents);
+    bool HasReadAheadWork();
+    void CopyNextChunk();
+    void AbandonCopy();
+    static void* InBackground(void* context);
 
 private:
     std::string _filePath;     // the path to the zip file backing this instance
-    zppZipArchive _zipArchive; // zpp zip archive wrapper
+    boost::scoped_ptr<zppZipArchive> _pZipArchive; // zpp zip archive wrapper
+    bool _ownsFile;            // false if the file belongs to someone else
+    int _readAheadLayers;      // number of upcoming layers to keep in memory
+    std::string _copyPath;     // where to copy a file we don't own, or empty
+    
+    // reading ahead and copying happen on a worker thread, started when the 
+    // first layer is printed, so that preparing an image never waits on them
+    pthread_t _worker;
+    bool _workerStarted;
+    // guards the archive and everything below
+    std::mutex _mutex;
+    std::condition_variable _workChanged;
+    std::map<int, std::string> _layerCache; // layer files read ahead
+    int _nextReadAheadLayer;   // next layer the worker should read ahead
+    int _lastReadAheadLayer;   // last layer the worker should read ahead
+    bool _copying;             // the copy is neither finished nor abandoned
+    bool _usingCopy;           // reading from the finished copy
+    bool _stopWorker;
+    
+    // only used by the worker thread
+    int _copySourceFd;
+    int _copyDestinationFd;
 };
 
 #endif    // PRINTDATAZIP_H
@@ -26,6 +26,9 @@
 #define	PRINTENGINE_H
 
 #include <map>
+#include <functional>
+#include <vector>
+#include <atomic>
 
 #include <boost/scoped_ptr.hpp>
 #include <Magick++.h>
@@ -39,6 +42,9 @@
 #include <LayerSettings.h>
 #include <ImageProcessor.h>
 #include <Settings.h>
+#include <SettlingEstimator.h>
+#include <DoseTable.h>
+#include <IBackgroundWork.h>
 
 // high-level motor commands, that may result in multiple low-level commands
 enum HighLevelMotorCommand
@@ -57,13 +63,21 @@ enum HighLevelMotorCommand
 };
 
 constexpr double TEMPERATURE_MEASUREMENT_INTERVAL_SEC = 20.0;
+// how far print data loading must progress (in percent) before another status
+// update is sent, to avoid redrawing the front panel for every archive member
+constexpr int LOAD_PROGRESS_STATUS_STEP = 10;
 
 class PrinterStateMachine;
 class PrintData;
 class Projector;
 class PrinterStatusQueue;
+class PrintDataLoader;
+struct PrintDataLoadStatus;
 class Timer;
 class Projector;
+class Histogram;
+class Gauge;
+class Counter;
 
 // Aggregates the data used by the background thread.
 struct ThreadData 
@@ -75,23 +89,22 @@ struct ThreadData
     Projector*  pProjector;
     double      scaleFactor;
     bool        usePatternMode;
+    double      prepTimeSec;
+    bool        measureLitArea;
+    // set as soon as it's measured, so it can be read while the rest of the 
+    // image is still being prepared; negative until then
+    std::atomic<double> litFraction;
 };
 
 
-// The different types of layers that may be printed
-enum LayerType
-{
-    First,
-    BurnIn,
-    Model
-};
-
 // The class that controls the printing process
-class PrintEngine : public ICallback, public ICommandTarget
+class PrintEngine : public ICallback, public ICommandTarget, 
+                    public IBackgroundWork
 {
 public: 
     PrintEngine(bool haveHardware, Motor& motor, Projector& projector,
-            PrinterStatusQueue& printerStatusPipe,
+            PrinterStatusQueue& printerStatusPipe, 
+            PrintDataLoader& printDataLoader,
             const Timer& exposureTimer, const Timer& temperatureTimer,
             const Timer& delayTimer, const Timer& motorTimeoutTimer);
     ~PrintEngine();
@@ -104,6 +117,7 @@ public:
     bool MoreLayers();
     void SetEstimatedPrintTime();
     void StartExposureTimer(double seconds);
+    void StartExposure(double seconds);
     void ClearExposureTimer();
     void StartDelayTimer(double seconds);
     void ClearDelayTimer();
@@ -115,6 +129,7 @@ public:
     void Begin();
     void ClearCurrentPrint(bool withInterrupt = false);
     double GetExposureTimeSec();
+    bool ProjectorTimesExposure(double seconds);
     double GetPreExposureDelayTimeSec();
     bool NeedsPreExposureDelay();
     double GetRemainingExposureTimeSec();
@@ -148,13 +163,16 @@ public:
     bool NeedsTrayDeflectionPause();
     void GetCurrentLayerSettings();
     void DisableMotors() { _motor.DisableMotors(); }
+    bool MotorsAtHome();
     void SetPrintFeedback(PrintRating rating);
     bool PrintIsInProgress() { return _printerStatus._numLayers != 0; }
     bool DemoModeRequested();
     bool SetDemoMode();
     void LoadPrintFileFromUSBDrive();
+    bool IsLoadingPrintData();
     bool LoadNextLayerImage();
     bool AwaitEndOfBackgroundThread(bool ignoreErrors = false);
+    bool AwaitCompletion();
     void SetCanLoadPrintData(bool canLoad);
     bool ShowScreenFor(UISubState substate);
     bool CanUpgradeProjector() { return _printerStatus._canUpgradeProjector; }
@@ -162,6 +180,10 @@ public:
     void UpgradeProjectorFirmware();
     bool ProjectorProgrammingCompleted();
     bool SetPrintMode();
+    void CountJam();
+    void DeferWork(const std::function<void()>& work);
+    void StartDeferringWork();
+    void RunDeferredWork();
 
 #ifdef DEBUG
     // for testing only 
@@ -186,9 +208,29 @@ private:
     bool _skipCalibration;
     double _remainingMotorTimeoutSec;
     LayerSettings _perLayer;
+    DoseTable _doseTable;
     int _currentZPosition;
+    // the axes are known to be at their home positions, as confirmed by the 
+    // motor controller's completion of the last homing move
+    bool _zAtHome;
+    bool _rotationAtHome;
+    // the axes the motion in progress will leave at home if it completes
+    bool _zHomePending;
+    bool _rotationHomePending;
+    // the tray hasn't been disturbed since it was last homed, so returning it
+    // by the homing angle after a print leaves it at home
+    bool _rotationTracked;
+    // the approach for the next layer was sent along with the separation
+    bool _approachQueued;
+    // time the exposure timer runs beyond an exposure timed by the projector
+    double _exposureTimerMarginSec;
+    // tag of the queued approach whose completion hasn't yet been confirmed,
+    // or 0 if there is none
+    int _queuedApproachTag;
     CurrentLayerSettings _cls;
     boost::scoped_ptr<PrintData> _pPrintData;
+    // the print data is being read in place from a USB drive
+    bool _printDataOnUSBDrive;
     bool _demoModeRequested;
     ImageProcessor _imageProcessor;
     pthread_t _bgndThread;
@@ -198,12 +240,22 @@ private:
     static const char* _threadErrorMsg;
 
     PrinterStatusQueue& _printerStatusQueue;
+    PrintDataLoader& _printDataLoader;
     const Timer& _exposureTimer;
     const Timer& _temperatureTimer;
     const Timer& _delayTimer;
     const Timer& _motorTimeoutTimer;
     Projector& _projector;
     Settings& _settings;
+    Histogram& _layerCycleTime;
+    Histogram& _imagePrepTime;
+    Gauge& _temperatureGauge;
+    Counter& _jams;
+    double _layerStartTime;
+    SettlingEstimator _settlingEstimator;
+    // work that can wait until the exposure of the current layer has begun
+    bool _deferringWork;
+    std::vector<std::function<void()>> _deferredWork;
 
     // This class has reference and pointer members
     // Disable copy construction and copy assignment
@@ -212,6 +264,7 @@ private:
 
     virtual void Callback(EventType eventType, const EventData& data);
     virtual void Handle(Command command);
+    virtual void Handle(Command command, const std::string& argument);
     void MotorCallback(unsigned char status);
     void ButtonCallback(unsigned char status);
     void DoorCallback(char data);
@@ -219,8 +272,14 @@ private:
     bool IsBurnInLayer();
     void HandleProcessDataFailed(ErrorCode errorCode, 
                                  const std::string& jobName);
-    void ProcessData();
-    double GetLayerTimeSec(LayerType type);
+    void ProcessData(const std::string& sourcePath = "", bool direct = false,
+                     const std::string& adoptedName = "");
+    void AdoptData(const std::string& argument);
+    void SetSettingFromText(const std::string& argument);
+    void PrintDataLoadCallback(const PrintDataLoadStatus& status);
+    void FinishProcessingData();
+    double GetLayerTimeSec(LayerType type, bool withExposure = true);
+    void BuildDoseTable();
     bool IsPrinterTooHot();
     void LogStatusAndSettings();
     int GetHomingTimeoutSec();
@@ -228,11 +287,18 @@ private:
     int GetPauseAndInspectTimeoutSec(bool toInspect);
     int GetUnjammingTimeoutSec();
     int GetPressTimeoutSec();
+    int GetAdaptiveDelayMS(int configuredMS, const char* minimumSetting,
+                           const char* delayName);
     int GetUnpressTimeoutSec();
     int GetSeparationTimeoutSec();
     int GetApproachTimeoutSec();
     void USBDriveConnectedCallback(const std::string& deviceNode);
     void USBDriveDisconnectedCallback();
+    void ForgetMotorPositions();
+    bool CanQueueApproach();
+    LayerType GetLayerType(int layer);
+    double GetLayerExposureSec(int layer, LayerType type);
+    void PrepareNextExposure();
     static void* InBackground(void* context);
 }; 
 
@@ -149,6 +149,7 @@ public:
     std::string _jobID;
     bool _canLoadPrintData;
     bool _canUpgradeProjector;
+    int _loadProgress;
 };
 
 #endif    // PRINTERSTATUS_H
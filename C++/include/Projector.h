@@ -26,6 +26,8 @@
 #define PROJECTOR_H
 
 #include <memory>
+#include <map>
+#include <vector>
 
 class I_I2C_Device;
 class IFrameBuffer;
@@ -52,11 +54,25 @@ public:
     double GetUpgradeProgress();
     bool ProgrammingComplete() { return _programmingComplete; }
     bool SetVideoResolution(int width, int height);
+    bool CanTimeExposure(double seconds);
+    bool PrepareTimedExposure(double seconds);
+    bool StartTimedExposure(double seconds);
 
 private:
+    // the projector's display mode, as last set by this class
+    enum DisplayMode
+    {
+        UnknownDisplayMode,
+        VideoDisplayMode,
+        PatternDisplayMode
+    };
+    
     void TurnLEDOn();
     void TurnLEDOff();
     bool PollStatus();
+    bool ProgramPatternSequence(int frames, unsigned int stepDelay);
+    bool RestoreContinuousSequence();
+    bool AwaitVideoSync();
     
     bool _canControlViaI2C;
     bool _supportsPatternMode;
@@ -67,10 +83,20 @@ private:
     bool _programmingComplete;
     FILE* _pFirmwareFile;
     std::unique_ptr<IFrameBuffer> _pFrameBuffer;
+    DisplayMode _displayMode;
+    // number of frames shown by the pattern sequence before it stops, or 0 if
+    // it repeats until stopped
+    int _sequenceFrames;
+    // the values last written to the projector's shadowed registers
+    std::map<unsigned char, std::vector<unsigned char>> _shadowRegisters;
     
     bool I2CWrite(unsigned char registerAddress, unsigned char data);
     bool I2CWrite(unsigned char registerAddress, const unsigned char* data, 
                   int length);
+    bool IsShadowCurrent(unsigned char registerAddress, 
+                         const unsigned char* data, int length) const;
+    bool UpdateShadow(unsigned char registerAddress, const unsigned char* data, 
+                      int length, bool written);
     unsigned char I2CRead(unsigned char registerAddress);
     bool I2CWriteAndRead(unsigned char regAddress, unsigned char *writeBuf, 
                          unsigned numBytesToWrite, unsigned char *readBuf, 
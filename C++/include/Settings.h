@@ -43,6 +43,11 @@ constexpr const char* BURN_IN_LAYERS         = "BurnInLayers";
 constexpr const char* FIRST_EXPOSURE         = "FirstExposureSec";
 constexpr const char* BURN_IN_EXPOSURE       = "BurnInExposureSec";
 constexpr const char* MODEL_EXPOSURE         = "ModelExposureSec";
+constexpr const char* EXPOSURE_RAMP_LAYERS   = "ExposureRampLayers";
+constexpr const char* EXPOSURE_RAMP_SHAPE    = "ExposureRampShape";
+constexpr const char* EXPOSURE_TEMP_COEFF    = "ExposureTempCoefficient";
+constexpr const char* EXPOSURE_REF_TEMP      = "ExposureReferenceTempC";
+constexpr const char* MIN_EXPOSURE_SCALE     = "MinTempExposureScale";
 constexpr const char* PRINT_DATA_DIR         = "PrintDataDir";
 constexpr const char* DOWNLOAD_DIR           = "DownloadDir";
 constexpr const char* STAGING_DIR            = "StagingDir";
@@ -58,7 +63,16 @@ constexpr const char* FRONT_PANEL_AWAKE_TIME = "FrontPanelScreenSaverMinutes";
 constexpr const char* IMAGE_SCALE_FACTOR     = "ImageScaleFactor";
 constexpr const char* PAT_MODE_SCALE_FACTOR  = "PatternModeImageScaleFactor";
 constexpr const char* USB_DRIVE_DATA_DIR     = "USBDriveDataDir";
+constexpr const char* DIRECT_USB_PRINT       = "PrintDirectlyFromUSBDrive";
+constexpr const char* USB_READ_AHEAD_LAYERS  = "USBReadAheadLayers";
 constexpr const char* FW_VERSION             = "FirmwareVersion";
+constexpr const char* ADAPTIVE_DELAYS        = "AdaptiveSettlingDelays";
+constexpr const char* MIN_APPROACH_WAIT      = "MinAdaptiveApproachWaitMS";
+constexpr const char* MIN_PRESS_WAIT         = "MinAdaptivePressWaitMS";
+constexpr const char* SKIP_REDUNDANT_HOMING  = "SkipRedundantHoming";
+constexpr const char* QUEUE_APPROACH         = "QueueApproachDuringSeparation";
+constexpr const char* PROJ_TIMED_EXPOSURE    = "ProjectorTimedExposure";
+constexpr const char* ALLOW_RGB565_SCANOUT   = "AllowRGB565Scanout";
 
 // motor control settings for moving between layers
 // FL = first layer, BI = burn-in layer, ML = model Layer
@@ -170,6 +184,7 @@ public:
     std::string GetAllSettingsAsJSONString();
     bool SetFromJSONString(const std::string& str);
     bool SetFromFile(const std::string& filename);
+    bool SetFromText(const std::string& key, const std::string& text);
     
 protected:
     std::string _settingsPath;
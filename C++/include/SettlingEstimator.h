@@ -0,0 +1,43 @@
+//  File:   SettlingEstimator.h
+//  Estimates how much of the configured settling delays before exposure can be
+//  skipped, based on the lit area of a layer and the print's recent history
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SETTLINGESTIMATOR_H
+#define	SETTLINGESTIMATOR_H
+
+#include "LayerSettings.h"
+
+class SettlingEstimator
+{
+public:
+    SettlingEstimator();
+    void Reset();
+    void LayerCompleted();
+    void Jammed();
+    int GetDelayMS(int configuredMS, int minimumMS, LayerType type, 
+                   double litFraction) const;
+    int GetSuccessfulLayers() const { return _successfulLayers; }
+    
+private:
+    int _successfulLayers;
+    bool _jammed;
+};
+
+#endif    // SETTLINGESTIMATOR_H
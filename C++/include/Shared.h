@@ -32,11 +32,19 @@ constexpr const char* VERSION_MINOR = "1";
 constexpr const char* COMMAND_PIPE           = "/tmp/CommandPipe";
 constexpr const char* STATUS_TO_WEB_PIPE     = "/tmp/StatusToWebPipe";
 
+// loopback port on which metrics are served in Prometheus text format
+constexpr int METRICS_PORT                   = 9110;
+
 constexpr const char* ROOT_DIR               = "/var/smith";
 
 // path (relative to ROOT_DIR) to file containing all current smith settings
 constexpr const char* SETTINGS_FILE          = "/config/settings";
 
+// path (relative to ROOT_DIR) to the directory in which the web server 
+// receives uploaded print files to hand over to smith, which must be on the
+// same mount as the download directory for them to be moved without copying
+constexpr const char* PRINT_FILE_HANDOFF_DIR = "/handoff";
+
 // path to print settings file containing settings from web 
 constexpr const char* TEMP_SETTINGS_FILE             = "/tmp/print_settings";
 
@@ -61,6 +69,7 @@ constexpr const char* CMD_RESUME                          = "RESUME";
 constexpr const char* CMD_RESET_PRINTER                   = "RESET";
 constexpr const char* CMD_REFRESH_SETTINGS                = "REFRESH";
 constexpr const char* CMD_APPLY_SETTINGS                  = "APPLYSETTINGS";
+constexpr const char* CMD_SET_SETTING                     = "SET";
 constexpr const char* CMD_TEST                            = "TEST";
 constexpr const char* CMD_CAL_IMAGE                       = "CALIMAGE";
 constexpr const char* CMD_EXIT                            = "EXIT";
@@ -70,6 +79,7 @@ constexpr const char* CMD_SHOW_PRINT_DOWNLOAD_FAILED      = "SHOWPRINTDOWNLOADFA
 constexpr const char* CMD_START_PRINT_DATA_LOAD           = "STARTPRINTDATALOAD";
 constexpr const char* CMD_SHOW_PRINT_DATA_LOADED          = "SHOWPRINTDATALOADED";
 constexpr const char* CMD_PROCESS_PRINT_DATA              = "PROCESSPRINTDATA";
+constexpr const char* CMD_ADOPT_PRINT_DATA                = "ADOPTPRINTDATA";
 constexpr const char* CMD_REGISTRATION_CODE               = "DISPLAYPRIMARYREGISTRATIONCODE";
 constexpr const char* CMD_REGISTERED                      = "PRIMARYREGISTRATIONSUCCEEDED";
 constexpr const char* CMD_SHOW_WIRELESS_CONNECTING        = "SHOWWIRELESSCONNECTING";
@@ -105,6 +115,7 @@ constexpr const char* SPARK_JOB_STATE_PS_KEY        = "spark_job_state";
 constexpr const char* LOCAL_JOB_UUID_PS_KEY         = "spark_local_job_uuid";
 constexpr const char* CAN_LOAD_PS_KEY               = "can_load_print_data";
 constexpr const char* CAN_UPGRADE_PROJECTOR_PS_KEY  = "can_upgrade_projector";
+constexpr const char* LOAD_PROGRESS_PS_KEY          = "load_progress";
 
 // StaeChange enum names
 constexpr const char* NO_CHANGE               = "none";
@@ -24,9 +24,18 @@
 #ifndef TARGZFILE_H
 #define	TARGZFILE_H
 
+#include <string>
+#include <functional>
+
+// Called after each archive member is extracted with the fraction of the 
+// compressed archive consumed so far.  Returning false abandons extraction.
+typedef std::function<bool(double fractionDone)> ExtractProgressCallback;
+
 namespace TarGzFile
 {
-    bool Extract(const std::string& archivePath, const std::string& rootPath);
+    bool Extract(const std::string& archivePath, const std::string& rootPath,
+                 const ExtractProgressCallback& progress = 
+                                                    ExtractProgressCallback());
 }
 
 #endif    // TARGZFILE_H
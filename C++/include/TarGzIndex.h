@@ -0,0 +1,79 @@
+//  File:   TarGzIndex.h
+//  Random access to the members of a gzipped tar file through an index of
+//  points at which decompression can resume
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TARGZINDEX_H
+#define	TARGZINDEX_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <TarGzFile.h>
+
+// Location of a regular file's data within the uncompressed tar stream
+struct TarMember
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+typedef std::map<std::string, TarMember> TarMemberMap;
+
+class TarGzIndex
+{
+public:
+    TarGzIndex(const std::string& archivePath, const std::string& indexPath);
+    bool Build(const ExtractProgressCallback& progress = 
+                                                    ExtractProgressCallback());
+    bool Load();
+    void SetPaths(const std::string& archivePath, const std::string& indexPath);
+    bool Contains(const std::string& name) const;
+    bool ReadMember(const std::string& name, std::string& contents) const;
+    const TarMemberMap& GetMembers() const { return _members; }
+
+private:
+    // A point in the compressed stream at which inflation can resume, given 
+    // the 32K of uncompressed data preceding it
+    struct AccessPoint
+    {
+        uint64_t out;    // offset in the uncompressed stream
+        uint64_t in;     // offset of the first whole byte in the archive
+        uint32_t bits;   // number of bits of the previous byte still needed
+        uint64_t window; // offset of the preceding uncompressed data in the 
+                         // index file
+    };
+    
+    bool Index(FILE* pArchive, FILE* pIndex, 
+               const ExtractProgressCallback& progress);
+    bool AddPoint(FILE* pIndex, uint32_t bits, uint64_t in, uint64_t out, 
+                  unsigned int left, const std::vector<unsigned char>& window);
+    bool WriteTable(FILE* pIndex, uint64_t archiveSize);
+    
+    std::string _archivePath;
+    std::string _indexPath;
+    std::vector<AccessPoint> _points;
+    TarMemberMap _members;
+};
+
+#endif    // TARGZINDEX_H
+
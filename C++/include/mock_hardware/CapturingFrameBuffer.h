@@ -0,0 +1,72 @@
+//  File:   CapturingFrameBuffer.h
+//  Frame buffer implementation that logs a checksum of each displayed frame and
+//  optionally keeps recent frames in a memory mapped ring file (for testing 
+//  purposes)
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MOCKHARDWARE_CAPTURINGFRAMEBUFFER_H
+#define MOCKHARDWARE_CAPTURINGFRAMEBUFFER_H
+
+#include "IFrameBuffer.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// header of each slot in the ring file, followed by the frame's pixels
+struct CapturedFrame
+{
+    uint32_t frameNumber;
+    uint16_t width;
+    uint16_t height;
+    uint32_t crc;
+};
+
+class CapturingFrameBuffer : public IFrameBuffer
+{
+public:
+    CapturingFrameBuffer(int width, int height, const std::string& logPath,
+                         const std::string& ringPath = "", 
+                         int ringFrames = 0);
+    ~CapturingFrameBuffer();
+    void Blit(Magick::Image& image);
+    void Fill(uint8_t value);
+    void Swap();
+    void SetResolution(int width, int height);
+    bool DumpFrame(uint32_t frameNumber, const std::string& outputPath);
+
+private:
+    CapturingFrameBuffer(const CapturingFrameBuffer&);
+    CapturingFrameBuffer& operator=(const CapturingFrameBuffer&);
+    void Capture(const std::vector<uint8_t>& pixels);
+    CapturedFrame* GetSlot(uint32_t frameNumber) const;
+
+    std::ofstream _log;
+    int _width;
+    int _height;
+    std::vector<uint8_t> _pixels;
+    std::vector<uint8_t> _fillPixels;
+    uint32_t _frameCount;
+    int _ringFrames;
+    size_t _slotCapacity;
+    size_t _ringSize;
+    uint8_t* _pRing;
+};
+
+#endif  // MOCKHARDWARE_CAPTURINGFRAMEBUFFER_H
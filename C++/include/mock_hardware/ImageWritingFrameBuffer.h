@@ -38,12 +38,13 @@ public:
     void Blit(Magick::Image& image);
     void Fill(uint8_t value);
     void Swap();
+    void SetResolution(int width, int height);
     
 private:
     const std::string _outputPath;
     int _width;
     int _height;
-    std::vector<unsigned int> _pixels;
+    std::vector<uint8_t> _pixels;
 };
 
 #endif  // MOCKHARDWARE_IMAGEWRITINGFRAMEBUFFER_H
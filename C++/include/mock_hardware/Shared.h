@@ -34,4 +34,11 @@ constexpr const char* MOTOR_CONTROLLER_INTERRUPT_READ_PIPE = "motor_controller_i
 constexpr const char* FRONT_PANEL_INTERRUPT_READ_PIPE = "front_panel_interrupt_read_pipe";
 constexpr const char* FRAME_BUFFER_IMAGE = "frame_buffer_image.png";
 
+// environment variables that select capturing displayed frames instead of 
+// writing each one to FRAME_BUFFER_IMAGE
+constexpr const char* FRAME_CAPTURE_LOG_VAR = "SMITH_FRAME_CAPTURE_LOG";
+constexpr const char* FRAME_CAPTURE_RING_VAR = "SMITH_FRAME_CAPTURE_RING";
+constexpr const char* FRAME_CAPTURE_RING_FRAMES_VAR = 
+                                            "SMITH_FRAME_CAPTURE_RING_FRAMES";
+
 #endif  // MOCKHARDWARE_SHARED_H
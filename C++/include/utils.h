@@ -28,6 +28,8 @@
 constexpr int UUID_LEN = 36;  // characters in hex ASCII string for a UUID
 
 long GetMillis();
+double GetSeconds();
+void SetVirtualSeconds(double seconds);
 void StartStopwatch();
 long StopStopwatch();
 std::string GetFirmwareVersion();
@@ -37,6 +39,7 @@ std::string GetFilePath(const char* fileName);
 bool PurgeDirectory(const std::string& path);
 bool Copy(const std::string& sourcePath, 
           const std::string& providedDestinationPath);
+bool Adopt(const std::string& sourcePath, const std::string& destinationPath);
 int MakePath(const std::string& path);
 int MkdirCheck(const std::string& path);
 void GetUUID(char* uuid);
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <fstream> 
 #include <string>
+#include <memory>
 #include <utils.h>
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -42,6 +43,7 @@
 #include <Hardware.h>
 #include <MotorController.h>
 #include <Filenames.h>
+#include <Shared.h>
 
 #include "StandardIn.h"
 #include "CommandPipe.h"
@@ -54,11 +56,20 @@
 #include "I2C_Device.h"
 #include "Projector.h"
 #include "HardwareFactory.h"
+#include "MetricsServer.h"
+#include "PrintDataLoader.h"
+#include "EventRecorder.h"
+#include "EventPlayer.h"
 
 using namespace std;
 
 // command line argument to suppress use of stdin & stdout
 constexpr const char* NO_STDIO = "--nostdio";
+// command line arguments, each followed by a file path, to record the events
+// handled to that file, or to replay the events it holds (typically with mock
+// hardware) instead of handling those that arise
+constexpr const char* RECORD_EVENTS = "--record";
+constexpr const char* REPLAY_EVENTS = "--replay";
 
 // for setting DMA priority to avoid video flicker
 constexpr unsigned long MAP_SIZE = 4096UL;
@@ -77,9 +88,16 @@ int main(int argc, char** argv)
         
         // see if we should support keyboard input and TerminalUI output
         bool useStdio = true;
-        if (argc > 1) 
+        string recordPath;
+        string replayPath;
+        for (int i = 1; i < argc; i++) 
         {
-            useStdio = strcmp(argv[1], NO_STDIO) != 0;
+            if (strcmp(argv[i], NO_STDIO) == 0)
+                useStdio = false;
+            else if (strcmp(argv[i], RECORD_EVENTS) == 0 && i + 1 < argc)
+                recordPath = argv[++i];
+            else if (strcmp(argv[i], REPLAY_EVENTS) == 0 && i + 1 < argc)
+                replayPath = argv[++i];
         }
         
         // report the firmware version, board serial number, and startup message
@@ -226,6 +244,19 @@ int main(int argc, char** argv)
                 HardwareFactory::CreateFrontPanelInterruptResource();
         I2C_Resource buttonInterrupt(*pFrontPanelInterruptResource,
                 *pFrontPanelI2cDevice, BTN_STATUS);
+        
+        // metrics are optional, so run without them if their port can't be 
+        // bound, e.g. because another process already holds it
+        std::unique_ptr<MetricsServer> pMetricsServer;
+        try
+        {
+            pMetricsServer.reset(new MetricsServer(METRICS_PORT));
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogMessage(LOG_WARNING, e.what());
+        }
+        PrintDataLoader printDataLoader;
 
         eh.AddEvent(Keyboard, &standardIn);
         eh.AddEvent(UICommand, &commandPipe);
@@ -241,10 +272,15 @@ int main(int argc, char** argv)
         eh.AddEvent(MotorTimeout, &motorControllerTimeout);
         eh.AddEvent(MotorInterrupt, &motorControllerInterrupt);
         eh.AddEvent(ButtonInterrupt, &buttonInterrupt);
+        if (pMetricsServer)
+            eh.AddEvent(MetricsRequest, pMetricsServer.get());
+        eh.AddEvent(PrintDataLoad, &printDataLoader);
+        eh.AddBackgroundWork(&printDataLoader);
 
         // create a print engine that communicates with actual hardware
-        PrintEngine pe(true, motor, projector, printerStatusQueue, exposureTimer,
-                temperatureTimer, delayTimer, motorTimeoutTimer);
+        PrintEngine pe(true, motor, projector, printerStatusQueue, 
+                printDataLoader, exposureTimer, temperatureTimer, delayTimer, 
+                motorTimeoutTimer);
         
         // give it to the settings singleton as an error handler
         settings.SetErrorHandler(&pe);
@@ -282,6 +318,11 @@ int main(int argc, char** argv)
         eh.Subscribe(USBDriveConnected, &pe);
         eh.Subscribe(USBDriveDisconnected, &pe);
         
+        // subscribe the print engine to print data loading progress
+        eh.Subscribe(PrintDataLoad, &pe);
+        // replay waits for its image processing thread between events
+        eh.AddBackgroundWork(&pe);
+        
         CommandInterpreter peCmdInterpreter(&pe);
         // subscribe the command interpreter to command input events,
         // from UI and possibly the keyboard
@@ -311,11 +352,27 @@ int main(int argc, char** argv)
             eh.Subscribe(PrinterStatusUpdate, &terminal);
         }
         
+        std::unique_ptr<EventRecorder> pRecorder;
+        if (!recordPath.empty())
+        {
+            pRecorder.reset(new EventRecorder(recordPath));
+            eh.SetRecorder(pRecorder.get());
+        }
+        
         // start the print engine's state machine
         pe.Begin();
 
-        // begin handling events
-        eh.Begin();
+        if (replayPath.empty())
+        {
+            // begin handling events
+            eh.Begin();
+        }
+        else
+        {
+            // handle the recorded events, then exit
+            EventPlayer player(replayPath);
+            eh.Replay(player);
+        }
 
         return 0;
     }
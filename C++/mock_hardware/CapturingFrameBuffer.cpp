@@ -0,0 +1,180 @@
+//  File:   CapturingFrameBuffer.cpp
+//  Frame buffer implementation that logs a checksum of each displayed frame and
+//  optionally keeps recent frames in a memory mapped ring file (for testing 
+//  purposes)
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include "mock_hardware/CapturingFrameBuffer.h"
+
+#include <Magick++.h>
+#include <zlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+
+#include "Hardware.h"
+
+// Constructor
+// Each displayed frame is logged to logPath as a line holding its number, 
+// resolution, and CRC-32.  If ringFrames is non-zero, the pixels of that many 
+// of the most recent frames are also kept in a ring file at ringPath, so that
+// any of them can be dumped as an image later.
+CapturingFrameBuffer::CapturingFrameBuffer(int width, int height, 
+        const std::string& logPath, const std::string& ringPath, 
+        int ringFrames) :
+_log(logPath.c_str(), std::ios_base::out | std::ios_base::trunc),
+_width(width),
+_height(height),
+_pixels(width * height),
+_frameCount(0),
+_ringFrames(ringFrames),
+_slotCapacity(0),
+_ringSize(0),
+_pRing(NULL)
+{
+    if (!_log.is_open())
+    {
+        throw std::runtime_error(
+                "unable to open frame log in CapturingFrameBuffer");
+    }
+    
+    if (_ringFrames <= 0 || ringPath.empty())
+        return;
+    
+    // size the slots to hold a frame in either projector mode
+    _slotCapacity = std::max(VIDEO_MODE_WIDTH * VIDEO_MODE_HEIGHT, 
+                             PATTERN_MODE_WIDTH * PATTERN_MODE_HEIGHT);
+    _slotCapacity = std::max(_slotCapacity, _pixels.size());
+    _ringSize = _ringFrames * (sizeof(CapturedFrame) + _slotCapacity);
+    
+    int fd = open(ringPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, _ringSize) < 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error(
+                "unable to create frame ring in CapturingFrameBuffer");
+    }
+    
+    void* pMap = mmap(NULL, _ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, 
+                      fd, 0);
+    // the mapping stays valid after its descriptor is closed
+    close(fd);
+    
+    if (pMap == MAP_FAILED)
+    {
+        throw std::runtime_error(
+                "unable to map frame ring in CapturingFrameBuffer");
+    }
+    _pRing = static_cast<uint8_t*>(pMap);
+}
+
+CapturingFrameBuffer::~CapturingFrameBuffer()
+{
+    if (_pRing)
+        munmap(_pRing, _ringSize);
+}
+
+void CapturingFrameBuffer::Blit(Magick::Image& image)
+{
+    image.write(0, 0, _width, _height, "G", Magick::CharPixel, _pixels.data());
+}
+
+void CapturingFrameBuffer::Fill(uint8_t value)
+{
+    // use a separate buffer so the blitted image isn't lost
+    _fillPixels.assign(_width * _height, value);
+    Capture(_fillPixels);
+}
+
+void CapturingFrameBuffer::Swap()
+{
+    Capture(_pixels);
+}
+
+void CapturingFrameBuffer::SetResolution(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _pixels.assign(width * height, 0);
+}
+
+// Write the image held in the ring for the specified frame to outputPath, in 
+// the format given by its extension.  Returns false if the frame has already 
+// been overwritten or wasn't kept.
+bool CapturingFrameBuffer::DumpFrame(uint32_t frameNumber, 
+                                     const std::string& outputPath)
+{
+    CapturedFrame* pFrame = GetSlot(frameNumber);
+    
+    if (!pFrame || pFrame->frameNumber != frameNumber || pFrame->width == 0)
+        return false;
+    
+    Magick::Image image(pFrame->width, pFrame->height, "I", Magick::CharPixel,
+                        reinterpret_cast<uint8_t*>(pFrame + 1));
+    image.write(outputPath);
+    return true;
+}
+
+// Record the checksum of a displayed frame and keep its pixels in the ring.
+void CapturingFrameBuffer::Capture(const std::vector<uint8_t>& pixels)
+{
+    _frameCount++;
+    
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, pixels.data(), pixels.size());
+    
+    _log << _frameCount << " " << _width << "x" << _height << " " 
+         << std::hex << std::setw(8) << std::setfill('0') << crc 
+         << std::dec << std::endl;
+    
+    CapturedFrame* pFrame = GetSlot(_frameCount);
+    if (!pFrame)
+        return;
+    
+    pFrame->frameNumber = _frameCount;
+    pFrame->crc = crc;
+    if (pixels.size() <= _slotCapacity)
+    {
+        pFrame->width = _width;
+        pFrame->height = _height;
+        std::memcpy(pFrame + 1, pixels.data(), pixels.size());
+    }
+    else
+    {
+        // too large to keep, mark slot as holding no image
+        pFrame->width = 0;
+        pFrame->height = 0;
+    }
+}
+
+// Get the ring slot used for the specified frame, or NULL if there's no ring.
+CapturedFrame* CapturingFrameBuffer::GetSlot(uint32_t frameNumber) const
+{
+    if (!_pRing)
+        return NULL;
+    
+    size_t slot = frameNumber % _ringFrames;
+    return reinterpret_cast<CapturedFrame*>(
+            _pRing + slot * (sizeof(CapturedFrame) + _slotCapacity));
+}
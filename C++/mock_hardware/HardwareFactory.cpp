@@ -24,10 +24,13 @@
 
 #include "HardwareFactory.h"
 
+#include <cstdlib>
+
 #include "mock_hardware/Shared.h"
 #include "mock_hardware/NamedPipeResource.h"
 #include "mock_hardware/NamedPipeI2C_Device.h"
 #include "mock_hardware/ImageWritingFrameBuffer.h"
+#include "mock_hardware/CapturingFrameBuffer.h"
 
 I2C_DevicePtr HardwareFactory::CreateMotorControllerI2cDevice()
 {
@@ -61,6 +64,17 @@ ResourcePtr HardwareFactory::CreateFrontPanelInterruptResource()
 
 FrameBufferPtr HardwareFactory::CreateFrameBuffer(int width, int height)
 {
+    // log checksums of displayed frames rather than encoding them as images if
+    // a capture log is specified
+    const char* logPath = getenv(FRAME_CAPTURE_LOG_VAR);
+    if (logPath)
+    {
+        const char* ringPath = getenv(FRAME_CAPTURE_RING_VAR);
+        const char* ringFrames = getenv(FRAME_CAPTURE_RING_FRAMES_VAR);
+        return FrameBufferPtr(new CapturingFrameBuffer(width, height, logPath,
+                ringPath ? ringPath : "", ringFrames ? atoi(ringFrames) : 0));
+    }
+
     return FrameBufferPtr(new ImageWritingFrameBuffer(width, height,
             FRAME_BUFFER_IMAGE));
 }
\ No newline at end of file
@@ -42,7 +42,7 @@ ImageWritingFrameBuffer::~ImageWritingFrameBuffer()
 // Copy the green channel from the specified image into the pixel member vector.
 void ImageWritingFrameBuffer::Blit(Magick::Image& image)
 {
-    image.write(0, 0, _width, _height, "G", Magick::IntegerPixel, _pixels.data());
+    image.write(0, 0, _width, _height, "G", Magick::CharPixel, _pixels.data());
 }
 
 // Write an image to the output path with all pixels having green value set to
@@ -58,6 +58,14 @@ void ImageWritingFrameBuffer::Fill(uint8_t value)
 // member vector.
 void ImageWritingFrameBuffer::Swap()
 {
-    Magick::Image image(_width, _height, "I", Magick::IntegerPixel, _pixels.data());
+    Magick::Image image(_width, _height, "I", Magick::CharPixel, _pixels.data());
     image.write(_outputPath);
 }
+
+// Change the dimensions of the images written to the output path.
+void ImageWritingFrameBuffer::SetResolution(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _pixels.assign(width * height, 0);
+}
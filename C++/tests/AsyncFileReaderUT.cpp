@@ -0,0 +1,194 @@
+//  File:   AsyncFileReaderUT.cpp
+//  Tests AsyncFileReader
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#include "support/FileUtils.hpp"
+#include <AsyncFileReader.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+std::string testDir;
+
+void Setup()
+{
+    testDir = CreateTempDir();
+}
+
+void TearDown()
+{
+    RemoveDir(testDir);
+    
+    testDir = "";
+}
+
+// Write a file with contents that depend on the given number and size, 
+// returning its path.
+std::string WriteFile(int number, size_t size, std::string& contents)
+{
+    std::ostringstream path;
+    path << testDir << "/file" << number;
+    
+    contents.clear();
+    for (size_t i = 0; i < size; i++)
+        contents.push_back((char)(i * number));
+    
+    std::ofstream file(path.str().c_str(), std::ios::binary);
+    file.write(contents.data(), contents.size());
+    return path.str();
+}
+
+void CheckRead(const char* testName, AsyncFileReader& reader, int tag,
+               const std::string& expected)
+{
+    std::string contents;
+    if (!reader.Wait(tag, contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (AsyncFileReaderUT) message=Expected Wait to return true for tag " 
+                << tag << ", got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    if (contents != expected)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (AsyncFileReaderUT) message=Contents read for tag " << tag 
+                << " differ from file, got " << contents.size() 
+                << " bytes, expected " << expected.size() << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestReadsInFlight()
+{
+    std::cout << "AsyncFileReaderUT TestReadsInFlight" << std::endl;
+    
+    AsyncFileReader reader(4, 64 * 1024);
+    std::cout << "\tusing " << (reader.IsAsync() ? "io_uring" : 
+                                "synchronous reads") << std::endl;
+    
+    // more files than can be in flight at once, the extra ones being read 
+    // synchronously
+    std::string contents[6];
+    for (int i = 1; i <= 6; i++)
+        reader.Submit(i, WriteFile(i, 1000 * i, contents[i - 1]));
+    
+    // wait for them out of order
+    for (int i = 6; i >= 1; i--)
+        CheckRead("TestReadsInFlight", reader, i, contents[i - 1]);
+    
+    if (reader.IsPending(1))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestReadsInFlight (AsyncFileReaderUT) "
+                << "message=Expected read to no longer be pending after waiting for it" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestReadLargerThanBuffer()
+{
+    std::cout << "AsyncFileReaderUT TestReadLargerThanBuffer" << std::endl;
+    
+    AsyncFileReader reader(2, 1024);
+    
+    std::string contents;
+    reader.Submit(1, WriteFile(1, 5000, contents));
+    CheckRead("TestReadLargerThanBuffer", reader, 1, contents);
+}
+
+void TestDiscardOutside()
+{
+    std::cout << "AsyncFileReaderUT TestDiscardOutside" << std::endl;
+    
+    AsyncFileReader reader(2, 64 * 1024);
+    
+    std::string contents[4];
+    for (int i = 1; i <= 2; i++)
+        reader.Submit(i, WriteFile(i, 100, contents[i - 1]));
+
+    // discarding frees the slots for later reads
+    reader.DiscardOutside(3, 4);
+    for (int i = 3; i <= 4; i++)
+        reader.Submit(i, WriteFile(i, 100, contents[i - 1]));
+
+    if (reader.IsPending(1) || reader.IsPending(2))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestDiscardOutside (AsyncFileReaderUT) "
+                << "message=Expected discarded reads to no longer be pending" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    for (int i = 3; i <= 4; i++)
+        CheckRead("TestDiscardOutside", reader, i, contents[i - 1]);
+}
+
+void TestSubmitWhenFileMissing()
+{
+    std::cout << "AsyncFileReaderUT TestSubmitWhenFileMissing" << std::endl;
+    
+    AsyncFileReader reader;
+    std::string contents;
+    
+    if (reader.Submit(1, testDir + "/bogus") || reader.Wait(1, contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestSubmitWhenFileMissing (AsyncFileReaderUT) "
+                << "message=Expected Submit and Wait to return false for a missing file" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% AsyncFileReaderUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestReadsInFlight (AsyncFileReaderUT)" << std::endl;
+    Setup();
+    TestReadsInFlight();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestReadsInFlight (AsyncFileReaderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestReadLargerThanBuffer (AsyncFileReaderUT)" << std::endl;
+    Setup();
+    TestReadLargerThanBuffer();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestReadLargerThanBuffer (AsyncFileReaderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestDiscardOutside (AsyncFileReaderUT)" << std::endl;
+    Setup();
+    TestDiscardOutside();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestDiscardOutside (AsyncFileReaderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestSubmitWhenFileMissing (AsyncFileReaderUT)" << std::endl;
+    Setup();
+    TestSubmitWhenFileMissing();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestSubmitWhenFileMissing (AsyncFileReaderUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
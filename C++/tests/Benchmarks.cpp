@@ -0,0 +1,240 @@
+//  File:   Benchmarks.cpp
+//  Performance regression suite timing the firmware's hot paths, with results
+//  compared against a stored baseline
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <Magick++.h>
+
+#include <PrinterStatus.h>
+#include <Settings.h>
+#include <LayerSettings.h>
+#include <EventHandler.h>
+#include <PrinterStatusQueue.h>
+#include <PrintDataZip.h>
+#include <ImageProcessor.h>
+#include <PixelConversion.h>
+#include <Hardware.h>
+
+#include "support/FileUtils.hpp"
+#include "support/Benchmark.hpp"
+
+constexpr const char* DEFAULT_BASELINE = "tests/benchmark_baseline.json";
+constexpr double DEFAULT_TOLERANCE = 0.15;
+
+// Subscriber that stops the event loop as soon as it receives a status 
+// update, so that each call to Begin() times one trip around the loop.
+class LoopStopper : public ICallback
+{
+public:
+    LoopStopper(EventHandler& eh) : _eh(eh) {}
+    
+private:
+    void Callback(EventType eventType, const EventData& data)
+    {
+        _eh.Handle(Exit);
+    }
+    
+    EventHandler& _eh;
+};
+
+void BenchmarkPrinterStatus(BenchmarkRunner& runner)
+{
+    PrinterStatus ps;
+    ps._numLayers = 1000;
+    ps._currentLayer = 500;
+    ps._estimatedSecondsRemaining = 3600;
+    ps._temperature = 35.5;
+    
+    runner.Run("PrinterStatus_ToString", [&]
+    {
+        std::string json = ps.ToString();
+        KeepAlive(json);
+    });
+}
+
+void BenchmarkSettings(BenchmarkRunner& runner, const std::string& tempDir)
+{
+    Settings settings(tempDir + "/settings");
+    
+    runner.Run("Settings_GetInt", [&]
+    {
+        int value = settings.GetInt(LAYER_THICKNESS);
+        KeepAlive(value);
+    });
+    
+    runner.Run("Settings_GetDouble", [&]
+    {
+        double value = settings.GetDouble(MODEL_EXPOSURE);
+        KeepAlive(value);
+    });
+}
+
+void BenchmarkLayerSettings(BenchmarkRunner& runner)
+{
+    std::ifstream layerParamsFile("resources/good_layer_params.csv");
+    std::stringstream layerParams;
+    layerParams << layerParamsFile.rdbuf();
+    std::string csv = layerParams.str();
+    LayerSettings layerSettings;
+    
+    runner.Run("LayerSettings_Load", [&]
+    {
+        bool loaded = layerSettings.Load(csv);
+        KeepAlive(loaded);
+    });
+}
+
+void BenchmarkEventHandler(BenchmarkRunner& runner)
+{
+    EventHandler eh;
+    PrinterStatusQueue statusQueue;
+    LoopStopper stopper(eh);
+    PrinterStatus ps;
+    
+    eh.AddEvent(PrinterStatusUpdate, &statusQueue);
+    eh.Subscribe(PrinterStatusUpdate, &stopper);
+    
+    runner.Run("EventHandler_Dispatch", [&]
+    {
+        statusQueue.Push(ps);
+        eh.Begin();
+    });
+}
+
+void BenchmarkPrintDataZip(BenchmarkRunner& runner)
+{
+    PrintDataZip printData("resources/print.zip");
+    Magick::Image image;
+    
+    runner.Run("PrintDataZip_GetImageForLayer", [&]
+    {
+        bool gotImage = printData.GetImageForLayer(1, &image);
+        KeepAlive(gotImage);
+    });
+}
+
+void BenchmarkImageProcessor(BenchmarkRunner& runner)
+{
+    ImageProcessor ip;
+    Magick::Image slice("resources/test_image.png");
+    Magick::Image patternModeInput("resources/patModeInput.png");
+    
+    runner.Run("ImageProcessor_Scale", [&]
+    {
+        // scale a copy, so that every iteration starts from the same image
+        Magick::Image image(slice);
+        ip.Scale(&image, 1.1);
+    });
+
+    runner.Run("ImageProcessor_MapForPatternMode", [&]
+    {
+        Magick::Image* pOutput = ip.MapForPatternMode(patternModeInput);
+        KeepAlive(pOutput);
+    });
+}
+
+void BenchmarkFrameBufferExpansion(BenchmarkRunner& runner)
+{
+    int width = VIDEO_MODE_WIDTH;
+    int height = VIDEO_MODE_HEIGHT;
+    std::vector<uint8_t> grey(width * height);
+    for (size_t i = 0; i < grey.size(); i++)
+        grey[i] = i % 256;
+    std::vector<uint16_t> rgb565(width * height);
+    std::vector<uint32_t> xrgb8888(width * height);
+    
+    runner.Run("FrameBuffer_ExpandRGB565", [&]
+    {
+        for (int y = 0; y < height; y++)
+            GreyRowToRGB565(&grey[width * y], &rgb565[width * y], width);
+        KeepAlive(rgb565[0]);
+    });
+    
+    runner.Run("FrameBuffer_ExpandXRGB8888", [&]
+    {
+        for (int y = 0; y < height; y++)
+            GreyRowToXRGB8888(&grey[width * y], &xrgb8888[width * y], width);
+        KeepAlive(xrgb8888[0]);
+    });
+}
+
+void PrintUsage(const char* name)
+{
+    std::cout << "usage: " << name << " [--filter <text>] [--output <file>]"
+              << " [--baseline <file>] [--tolerance <fraction>]" << std::endl;
+}
+
+// Run the benchmarks whose names contain the filter text, optionally write 
+// the results to a JSON file, and compare them with the baseline.  Returns
+// the number of benchmarks that regressed by more than the tolerance.
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string outputPath;
+    std::string baselinePath = DEFAULT_BASELINE;
+    double tolerance = DEFAULT_TOLERANCE;
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+            filter = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--output") == 0)
+            outputPath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0)
+            baselinePath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--tolerance") == 0)
+            tolerance = atof(argv[++i]);
+        else
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    std::string tempDir = CreateTempDir();
+    BenchmarkRunner runner(filter);
+    
+    BenchmarkPrinterStatus(runner);
+    BenchmarkSettings(runner, tempDir);
+    BenchmarkLayerSettings(runner);
+    BenchmarkEventHandler(runner);
+    BenchmarkPrintDataZip(runner);
+    BenchmarkImageProcessor(runner);
+    BenchmarkFrameBufferExpansion(runner);
+    
+    RemoveDir(tempDir);
+    
+    if (!outputPath.empty() && !runner.WriteResults(outputPath))
+        return EXIT_FAILURE;
+    
+    int regressions = runner.CompareToBaseline(baselinePath, tolerance);
+    if (regressions < 0)
+        return EXIT_FAILURE;
+    
+    std::cout << regressions << " regression(s) beyond " << tolerance * 100.0
+              << "% tolerance" << std::endl;
+    return regressions;
+}
@@ -0,0 +1,184 @@
+//  File:   CapturingFrameBufferUT.cpp
+//  Compares the frames logged by CapturingFrameBuffer with a golden run
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Magick++.h>
+
+#include "support/FileUtils.hpp"
+#include <mock_hardware/CapturingFrameBuffer.h>
+
+// the frames displayed by DisplayFrames, as logged by a known good run
+constexpr const char* GOLDEN_FRAME_LOG = "resources/golden_frames.log";
+
+constexpr int WIDTH = 64;
+constexpr int HEIGHT = 48;
+constexpr int SMALL_WIDTH = 32;
+constexpr int SMALL_HEIGHT = 16;
+
+int mainReturnValue = EXIT_SUCCESS;
+std::string tempDir;
+
+void Setup()
+{
+    tempDir = CreateTempDir();
+}
+
+void TearDown()
+{
+    RemoveDir(tempDir);
+}
+
+std::vector<uint8_t> Gradient()
+{
+    std::vector<uint8_t> pixels(WIDTH * HEIGHT);
+    for (int y = 0; y < HEIGHT; y++)
+        for (int x = 0; x < WIDTH; x++)
+            pixels[WIDTH * y + x] = (x * 4 + y) & 0xFF;
+    return pixels;
+}
+
+std::vector<uint8_t> Checkerboard()
+{
+    std::vector<uint8_t> pixels(SMALL_WIDTH * SMALL_HEIGHT);
+    for (int y = 0; y < SMALL_HEIGHT; y++)
+        for (int x = 0; x < SMALL_WIDTH; x++)
+            pixels[SMALL_WIDTH * y + x] = (x / 4 + y / 4) % 2 ? 0xFF : 0;
+    return pixels;
+}
+
+// Show a sequence of frames covering Fill, Blit and Swap, and a change of 
+// resolution.
+void DisplayFrames(CapturingFrameBuffer& frameBuffer)
+{
+    frameBuffer.Fill(0);
+    
+    std::vector<uint8_t> gradient = Gradient();
+    Magick::Image gradientImage(WIDTH, HEIGHT, "I", Magick::CharPixel, 
+                                gradient.data());
+    frameBuffer.Blit(gradientImage);
+    frameBuffer.Swap();
+    
+    frameBuffer.Fill(0xFF);
+    
+    frameBuffer.SetResolution(SMALL_WIDTH, SMALL_HEIGHT);
+    std::vector<uint8_t> checkerboard = Checkerboard();
+    Magick::Image checkerboardImage(SMALL_WIDTH, SMALL_HEIGHT, "I", 
+                                    Magick::CharPixel, checkerboard.data());
+    frameBuffer.Blit(checkerboardImage);
+    frameBuffer.Swap();
+}
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void TestFrameLogMatchesGoldenRun()
+{
+    std::cout << "CapturingFrameBufferUT TestFrameLogMatchesGoldenRun" << std::endl;
+    
+    std::string logPath = tempDir + "/frames.log";
+    {
+        CapturingFrameBuffer frameBuffer(WIDTH, HEIGHT, logPath);
+        DisplayFrames(frameBuffer);
+    }
+    
+    std::string log = ReadFile(logPath);
+    std::string golden = ReadFile(GOLDEN_FRAME_LOG);
+    if (golden.empty() || log != golden)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestFrameLogMatchesGoldenRun (CapturingFrameBufferUT) "
+                  << "message=Frame log differs from golden run, expected:\n" << golden 
+                  << "but got:\n" << log << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestDumpedFrameMatchesDisplayedImage()
+{
+    std::cout << "CapturingFrameBufferUT TestDumpedFrameMatchesDisplayedImage" << std::endl;
+    
+    std::string logPath = tempDir + "/frames.log";
+    std::string ringPath = tempDir + "/frames.ring";
+    std::string imagePath = tempDir + "/frame2.png";
+    CapturingFrameBuffer frameBuffer(WIDTH, HEIGHT, logPath, ringPath, 4);
+    DisplayFrames(frameBuffer);
+    
+    if (!frameBuffer.DumpFrame(2, imagePath))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestDumpedFrameMatchesDisplayedImage (CapturingFrameBufferUT) "
+                  << "message=Frame 2 not kept in the ring" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    Magick::Image image(imagePath);
+    std::vector<uint8_t> pixels(WIDTH * HEIGHT);
+    image.write(0, 0, WIDTH, HEIGHT, "G", Magick::CharPixel, pixels.data());
+    if (image.columns() != WIDTH || image.rows() != HEIGHT || 
+        pixels != Gradient())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestDumpedFrameMatchesDisplayedImage (CapturingFrameBufferUT) "
+                  << "message=Dumped frame differs from the displayed image" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    
+    // frames that have been overwritten in the ring can't be dumped
+    frameBuffer.Fill(0);
+    frameBuffer.Fill(0);
+    frameBuffer.Fill(0);
+    if (frameBuffer.DumpFrame(2, imagePath))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestDumpedFrameMatchesDisplayedImage (CapturingFrameBufferUT) "
+                  << "message=Dumped a frame that was overwritten in the ring" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% CapturingFrameBufferUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestFrameLogMatchesGoldenRun (CapturingFrameBufferUT)" << std::endl;
+    Setup();
+    TestFrameLogMatchesGoldenRun();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestFrameLogMatchesGoldenRun (CapturingFrameBufferUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestDumpedFrameMatchesDisplayedImage (CapturingFrameBufferUT)" << std::endl;
+    Setup();
+    TestDumpedFrameMatchesDisplayedImage();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestDumpedFrameMatchesDisplayedImage (CapturingFrameBufferUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
@@ -32,12 +32,19 @@
 int mainReturnValue = EXIT_SUCCESS;
 Command expected;
 bool handled = false;
+std::string argument;
 
 const char* expectedErrorMsg;
 bool gotExpectedError = false;
 
 class TestTarget: public ICommandTarget
 {
+    void Handle(Command command, const std::string& arg)
+    {
+        argument = arg;
+        Handle(command);
+    }
+    
     void Handle(Command command)
     {
         if (command != expected)
@@ -120,6 +127,39 @@ void test1() {
     cmdInterp.Callback(Keyboard, EventData(std::string("PAUSE")));
     CheckHandled(expected);
     
+    // check that arguments are passed along with their case preserved
+    expected = AdoptPrintData;
+    cmdInterp.Callback(UICommand, 
+            EventData(std::string("adoptPrintData  /tmp/Upload.zip My Part.zip\n")));
+    CheckHandled(expected);
+    if (argument != "/tmp/Upload.zip My Part.zip")
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (CommandInterpreterUT) message=unexpected argument: '" << 
+                      argument << "'" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    
+    expected = SetSetting;
+    cmdInterp.Callback(UICommand, 
+            EventData(std::string("set JobName Whos Yer Daddy")));
+    CheckHandled(expected);
+    if (argument != "JobName Whos Yer Daddy")
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (CommandInterpreterUT) message=unexpected argument: '" << 
+                      argument << "'" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    
+    expected = Start;
+    cmdInterp.Callback(UICommand, EventData(std::string("Start\n")));
+    CheckHandled(expected);
+    if (!argument.empty())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (CommandInterpreterUT) message=unexpected argument: '" << 
+                      argument << "'" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    
     // check that illegal commands are not handled   
     expectedErrorMsg = ErrorMessage::GetMessage(UnknownTextCommand);
     cmdInterp.Callback(UICommand, EventData(std::string("garbageIn")));
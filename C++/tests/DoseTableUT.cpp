@@ -0,0 +1,257 @@
+//  File:   DoseTableUT.cpp
+//  Tests DoseTable
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+#include <DoseTable.h>
+#include <LayerSettings.h>
+#include <Settings.h>
+
+#define SETTINGS (PrinterSettings::Instance())
+
+int mainReturnValue = EXIT_SUCCESS;
+
+void Setup()
+{
+    SETTINGS.Set(FIRST_EXPOSURE, 10.0);
+    SETTINGS.Set(BURN_IN_LAYERS, 2);
+    SETTINGS.Set(BURN_IN_EXPOSURE, 8.0);
+    SETTINGS.Set(MODEL_EXPOSURE, 2.0);
+}
+
+void TearDown()
+{
+    SETTINGS.Restore(FIRST_EXPOSURE);
+    SETTINGS.Restore(BURN_IN_LAYERS);
+    SETTINGS.Restore(BURN_IN_EXPOSURE);
+    SETTINGS.Restore(MODEL_EXPOSURE);
+    SETTINGS.Restore(EXPOSURE_RAMP_LAYERS);
+    SETTINGS.Restore(EXPOSURE_RAMP_SHAPE);
+    SETTINGS.Restore(EXPOSURE_TEMP_COEFF);
+    SETTINGS.Restore(EXPOSURE_REF_TEMP);
+    SETTINGS.Restore(MIN_EXPOSURE_SCALE);
+}
+
+// Check the exposures of the given table against the expected values for
+// layers 1 through numLayers.
+void CheckExposures(const char* testName, const DoseTable& table, 
+                    const double* expected, int numLayers)
+{
+    for (int n = 1; n <= numLayers; n++)
+    {
+        if (!table.Contains(n) || 
+            std::fabs(table.GetExposureSec(n) - expected[n - 1]) > 1e-9)
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                    << " (DoseTableUT) message=Expected exposure of " 
+                    << expected[n - 1] << " s for layer " << n << ", got " 
+                    << (table.Contains(n) ? table.GetExposureSec(n) : -1.0) 
+                    << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+    
+    if (table.Contains(0) || table.Contains(numLayers + 1))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (DoseTableUT) message=Table contains layers outside the print" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestNoRamp()
+{
+    std::cout << "DoseTableUT TestNoRamp" << std::endl;
+    
+    LayerSettings perLayer;
+    DoseTable table;
+    table.Build(6, perLayer, SETTINGS);
+    
+    double expected[] = {10.0, 8.0, 8.0, 2.0, 2.0, 2.0};
+    CheckExposures("TestNoRamp", table, expected, 6);
+}
+
+void TestLinearRamp()
+{
+    std::cout << "DoseTableUT TestLinearRamp" << std::endl;
+    
+    SETTINGS.Set(EXPOSURE_RAMP_LAYERS, 2);
+    SETTINGS.Set(EXPOSURE_RAMP_SHAPE, std::string(LINEAR_RAMP));
+    
+    LayerSettings perLayer;
+    DoseTable table;
+    table.Build(7, perLayer, SETTINGS);
+    
+    double expected[] = {10.0, 8.0, 8.0, 6.0, 4.0, 2.0, 2.0};
+    CheckExposures("TestLinearRamp", table, expected, 7);
+}
+
+void TestExponentialRamp()
+{
+    std::cout << "DoseTableUT TestExponentialRamp" << std::endl;
+    
+    SETTINGS.Set(EXPOSURE_RAMP_LAYERS, 1);
+    SETTINGS.Set(EXPOSURE_RAMP_SHAPE, std::string(EXPONENTIAL_RAMP));
+    
+    LayerSettings perLayer;
+    DoseTable table;
+    table.Build(5, perLayer, SETTINGS);
+    
+    // geometric mean of the burn-in and model exposures
+    double expected[] = {10.0, 8.0, 8.0, 4.0, 2.0};
+    CheckExposures("TestExponentialRamp", table, expected, 5);
+}
+
+void TestPerLayerOverridesRamp()
+{
+    std::cout << "DoseTableUT TestPerLayerOverridesRamp" << std::endl;
+    
+    SETTINGS.Set(EXPOSURE_RAMP_LAYERS, 2);
+    SETTINGS.Set(EXPOSURE_RAMP_SHAPE, std::string(LINEAR_RAMP));
+    
+    LayerSettings perLayer;
+    perLayer.Load(std::string("Layer,") + MODEL_EXPOSURE + "\n5,3.5\n7,1.5\n");
+    DoseTable table;
+    table.Build(7, perLayer, SETTINGS);
+    
+    double expected[] = {10.0, 8.0, 8.0, 6.0, 3.5, 2.0, 1.5};
+    CheckExposures("TestPerLayerOverridesRamp", table, expected, 7);
+}
+
+void TestTotalExposure()
+{
+    std::cout << "DoseTableUT TestTotalExposure" << std::endl;
+    
+    SETTINGS.Set(EXPOSURE_RAMP_LAYERS, 2);
+    SETTINGS.Set(EXPOSURE_RAMP_SHAPE, std::string(LINEAR_RAMP));
+    
+    LayerSettings perLayer;
+    DoseTable table;
+    table.Build(7, perLayer, SETTINGS);
+    
+    // exposures are 10, 8, 8, 6, 4, 2, 2
+    double totals[] = {40.0, 40.0, 30.0, 14.0, 8.0, 2.0, 0.0};
+    int fromLayers[] = {0, 1, 2, 4, 5, 7, 8};
+    for (int i = 0; i < 7; i++)
+    {
+        double total = table.GetTotalExposureSec(fromLayers[i]);
+        if (std::fabs(total - totals[i]) > 1e-9)
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestTotalExposure "
+                    << "(DoseTableUT) message=Expected total exposure of " 
+                    << totals[i] << " s from layer " << fromLayers[i] 
+                    << ", got " << total << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+    
+    table.Clear();
+    if (table.Contains(1) || table.GetTotalExposureSec(1) != 0.0)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestTotalExposure "
+                << "(DoseTableUT) message=Expected cleared table to be empty" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void CheckScale(double temperatureC, double expected)
+{
+    double scale = DoseTable::GetTemperatureScale(temperatureC, SETTINGS);
+    if (std::fabs(scale - expected) > 1e-9)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestTemperatureScale "
+                << "(DoseTableUT) message=Expected scale of " << expected 
+                << " at " << temperatureC << " C, got " << scale << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestTemperatureScale()
+{
+    std::cout << "DoseTableUT TestTemperatureScale" << std::endl;
+    
+    // no scaling by default
+    CheckScale(30.0, 1.0);
+    
+    SETTINGS.Set(EXPOSURE_TEMP_COEFF, 0.02);
+    SETTINGS.Set(EXPOSURE_REF_TEMP, 20.0);
+    SETTINGS.Set(MIN_EXPOSURE_SCALE, 0.75);
+    
+    CheckScale(20.0, 1.0);
+    CheckScale(30.0, std::exp(-0.2));
+    // never longer for colder resin
+    CheckScale(15.0, 1.0);
+    // never shorter than the minimum scale
+    CheckScale(40.0, 0.75);
+    // unknown temperature
+    CheckScale(-1.0, 1.0);
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% DoseTableUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestNoRamp (DoseTableUT)" << std::endl;
+    Setup();
+    TestNoRamp();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestNoRamp (DoseTableUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestLinearRamp (DoseTableUT)" << std::endl;
+    Setup();
+    TestLinearRamp();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestLinearRamp (DoseTableUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestExponentialRamp (DoseTableUT)" << std::endl;
+    Setup();
+    TestExponentialRamp();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestExponentialRamp (DoseTableUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestPerLayerOverridesRamp (DoseTableUT)" << std::endl;
+    Setup();
+    TestPerLayerOverridesRamp();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestPerLayerOverridesRamp (DoseTableUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestTotalExposure (DoseTableUT)" << std::endl;
+    Setup();
+    TestTotalExposure();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestTotalExposure (DoseTableUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestTemperatureScale (DoseTableUT)" << std::endl;
+    Setup();
+    TestTemperatureScale();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestTemperatureScale (DoseTableUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
@@ -0,0 +1,362 @@
+//  File:   EventRecorderUT.cpp
+//  Unit tests for recording and replaying events
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "support/FileUtils.hpp"
+#include <EventHandler.h>
+#include <EventRecorder.h>
+#include <EventPlayer.h>
+#include <PrinterStatusQueue.h>
+#include <PrinterStatus.h>
+#include <Timer.h>
+#include <utils.h>
+#include <IBackgroundWork.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+std::string tempDir;
+
+// Describes each event it receives, along with the time it was received
+class EventLog : public ICallback
+{
+public:
+    std::vector<std::string> events;
+    std::vector<double> times;
+    
+    void Callback(EventType eventType, const EventData& data)
+    {
+        std::ostringstream event;
+        event << eventType << ":";
+        
+        switch (eventType)
+        {
+            case MotorInterrupt:
+                event << static_cast<int>(data.Get<unsigned char>());
+                break;
+                
+            case DoorInterrupt:
+                event << data.Get<char>();
+                break;
+                
+            case DelayEnd:
+                event << data.Get<uint64_t>();
+                break;
+                
+            case PrinterStatusUpdate:
+                event << data.Get<PrinterStatus>()._currentLayer;
+                break;
+                
+            default:
+                event << data.Get<std::string>();
+                break;
+        }
+        
+        events.push_back(event.str());
+        times.push_back(GetSeconds());
+    }
+};
+
+// Starts slow work on another thread when told to load, and raises a printer
+// status update once it's done, as print data loading does
+class SlowLoad : public ICallback, public IBackgroundWork
+{
+public:
+    SlowLoad(PrinterStatusQueue& queue) : _queue(queue), _thread(0) {}
+    
+    void Callback(EventType eventType, const EventData& data)
+    {
+        if (data.Get<std::string>() == "load")
+            pthread_create(&_thread, NULL, &Work, NULL);
+    }
+    
+    bool AwaitCompletion()
+    {
+        if (_thread == 0)
+            return false;
+        
+        pthread_join(_thread, NULL);
+        _thread = 0;
+        
+        PrinterStatus status;
+        status._currentLayer = 3;
+        _queue.Push(status);
+        return true;
+    }
+    
+private:
+    static void* Work(void* context)
+    {
+        usleep(50000);
+        return NULL;
+    }
+    
+    PrinterStatusQueue& _queue;
+    pthread_t _thread;
+};
+
+void Fail(const std::string& testName, const std::string& message)
+{
+    std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+              << " (EventRecorderUT) message=" << message << std::endl;
+    mainReturnValue = EXIT_FAILURE;
+}
+
+void CheckEvents(const std::string& testName, const EventLog& log, 
+                 const std::vector<std::string>& expected)
+{
+    if (log.events == expected)
+        return;
+    
+    std::ostringstream message;
+    message << "Expected " << expected.size() << " events:";
+    for (const std::string& event : expected)
+        message << " " << event;
+    message << ", got " << log.events.size() << ":";
+    for (const std::string& event : log.events)
+        message << " " << event;
+    Fail(testName, message.str());
+}
+
+void TestReplaysEventsWithRecordedTiming()
+{
+    std::cout << "EventRecorderUT TestReplaysEventsWithRecordedTiming" 
+              << std::endl;
+
+    std::string path = tempDir + "/timing";
+    {
+        EventRecorder recorder(path);
+        recorder.Record(MotorInterrupt, EventData(static_cast<unsigned char>(4)));
+        usleep(50000);
+        recorder.Record(DoorInterrupt, EventData('1'));
+        recorder.Record(UICommand, EventData(std::string("startprint")));
+        usleep(50000);
+        recorder.Record(DelayEnd, EventData(static_cast<uint64_t>(1)));
+    }
+    
+    EventHandler eh;
+    EventLog log;
+    eh.Subscribe(MotorInterrupt, &log);
+    eh.Subscribe(DoorInterrupt, &log);
+    eh.Subscribe(UICommand, &log);
+    eh.Subscribe(DelayEnd, &log);
+    
+    EventPlayer player(path);
+    double startTime = GetSeconds();
+    eh.Replay(player);
+    double replayTime = GetSeconds() - startTime;
+    
+    std::ostringstream motor, door, command, delay;
+    motor << MotorInterrupt << ":4";
+    door << DoorInterrupt << ":1";
+    command << UICommand << ":startprint";
+    delay << DelayEnd << ":1";
+    CheckEvents("TestReplaysEventsWithRecordedTiming", log, 
+                {motor.str(), door.str(), command.str(), delay.str()});
+    
+    if (log.times.size() != 4)
+        return;
+    
+    // subscribers see the recorded intervals between events, but replay 
+    // doesn't wait for them to elapse
+    double first = log.times[1] - log.times[0];
+    double second = log.times[3] - log.times[2];
+    if (first < 0.05 || first > 0.1 || second < 0.05 || second > 0.1 ||
+        log.times[2] - log.times[1] > 0.01)
+    {
+        std::ostringstream message;
+        message << "Unexpected intervals between replayed events: " << first 
+                << ", " << log.times[2] - log.times[1] << ", " << second;
+        Fail("TestReplaysEventsWithRecordedTiming", message.str());
+    }
+    
+    if (replayTime >= 0.1)
+    {
+        std::ostringstream message;
+        message << "Replay took " << replayTime << " seconds";
+        Fail("TestReplaysEventsWithRecordedTiming", message.str());
+    }
+    
+    // the clock is real again once replay is complete
+    if (GetSeconds() < startTime)
+        Fail("TestReplaysEventsWithRecordedTiming", 
+             "Clock still virtual after replay");
+}
+
+void TestReplayAwaitsBackgroundWork()
+{
+    std::cout << "EventRecorderUT TestReplayAwaitsBackgroundWork" << std::endl;
+
+    std::string path = tempDir + "/background";
+    {
+        EventRecorder recorder(path);
+        recorder.Record(UICommand, EventData(std::string("load")));
+        recorder.Record(UICommand, EventData(std::string("start")));
+    }
+    
+    EventHandler eh;
+    PrinterStatusQueue statusQueue;
+    eh.AddEvent(PrinterStatusUpdate, &statusQueue);
+    
+    EventLog log;
+    SlowLoad load(statusQueue);
+    eh.Subscribe(UICommand, &load);
+    eh.Subscribe(UICommand, &log);
+    eh.Subscribe(PrinterStatusUpdate, &log);
+    eh.AddBackgroundWork(&load);
+    
+    EventPlayer player(path);
+    eh.Replay(player);
+    
+    // the command that followed the load in the recording is only replayed 
+    // once the load has finished
+    std::ostringstream loadCommand, status, startCommand;
+    loadCommand << UICommand << ":load";
+    status << PrinterStatusUpdate << ":3";
+    startCommand << UICommand << ":start";
+    CheckEvents("TestReplayAwaitsBackgroundWork", log, 
+                {loadCommand.str(), status.str(), startCommand.str()});
+}
+
+void TestRecordsOnlyEventsFromOutsideThePrintEngine()
+{
+    std::cout << "EventRecorderUT TestRecordsOnlyEventsFromOutsideThePrintEngine" 
+              << std::endl;
+
+    std::string path = tempDir + "/dispatched";
+    {
+        EventHandler eh;
+        EventRecorder recorder(path);
+        eh.SetRecorder(&recorder);
+        
+        Timer delayTimer;
+        PrinterStatusQueue statusQueue;
+        eh.AddEvent(DelayEnd, &delayTimer);
+        eh.AddEvent(PrinterStatusUpdate, &statusQueue);
+        
+        EventLog log;
+        eh.Subscribe(DelayEnd, &log);
+        eh.Subscribe(PrinterStatusUpdate, &log);
+        
+        PrinterStatus status;
+        status._currentLayer = 7;
+        statusQueue.Push(status);
+        delayTimer.Start(0.001);
+        eh.Begin(5);
+        
+        if (log.events.size() != 2)
+            Fail("TestRecordsOnlyEventsFromOutsideThePrintEngine", 
+                 "Expected both events to be dispatched");
+    }
+    
+    EventPlayer player(path);
+    RecordedEvent event;
+    std::vector<EventType> types;
+    while (player.Next(event))
+        types.push_back(event.type);
+    
+    if (types.size() != 1 || types[0] != DelayEnd)
+        Fail("TestRecordsOnlyEventsFromOutsideThePrintEngine", 
+             "Expected only the timer event to be recorded");
+    
+    // the loader thread started by a replayed command reports its own 
+    // progress, and is only joined once it has reported finishing
+    if (EventRecorder::IsRecorded(PrintDataLoad))
+        Fail("TestRecordsOnlyEventsFromOutsideThePrintEngine", 
+             "Expected print data load progress not to be recorded");
+}
+
+void TestTruncatedRecordingRejected()
+{
+    std::cout << "EventRecorderUT TestTruncatedRecordingRejected" << std::endl;
+
+    std::string path = tempDir + "/truncated";
+    {
+        EventRecorder recorder(path);
+        recorder.Record(UICommand, EventData(std::string("pause")));
+    }
+    
+    // drop the last byte of the command
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), 
+                         std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out << contents.substr(0, contents.size() - 1);
+    out.close();
+    
+    EventPlayer player(path);
+    RecordedEvent event;
+    try
+    {
+        player.Next(event);
+        Fail("TestTruncatedRecordingRejected", 
+             "Expected truncated event to be rejected");
+    }
+    catch (const std::runtime_error& e)
+    {
+    }
+    
+    try
+    {
+        EventPlayer notRecording(tempDir + "/truncated_missing");
+        Fail("TestTruncatedRecordingRejected", 
+             "Expected missing recording to be rejected");
+    }
+    catch (const std::runtime_error& e)
+    {
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% EventRecorderUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    tempDir = CreateTempDir();
+
+    std::cout << "%TEST_STARTED% TestReplaysEventsWithRecordedTiming (EventRecorderUT)" << std::endl;
+    TestReplaysEventsWithRecordedTiming();
+    std::cout << "%TEST_FINISHED% time=0 TestReplaysEventsWithRecordedTiming (EventRecorderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestReplayAwaitsBackgroundWork (EventRecorderUT)" << std::endl;
+    TestReplayAwaitsBackgroundWork();
+    std::cout << "%TEST_FINISHED% time=0 TestReplayAwaitsBackgroundWork (EventRecorderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestRecordsOnlyEventsFromOutsideThePrintEngine (EventRecorderUT)" << std::endl;
+    TestRecordsOnlyEventsFromOutsideThePrintEngine();
+    std::cout << "%TEST_FINISHED% time=0 TestRecordsOnlyEventsFromOutsideThePrintEngine (EventRecorderUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestTruncatedRecordingRejected (EventRecorderUT)" << std::endl;
+    TestTruncatedRecordingRejected();
+    std::cout << "%TEST_FINISHED% time=0 TestTruncatedRecordingRejected (EventRecorderUT)" << std::endl;
+
+    RemoveDir(tempDir);
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
@@ -0,0 +1,158 @@
+//  File:   LayerArenaUT.cpp
+//  Unit tests for LayerArena
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <iostream>
+#include <vector>
+
+#include <LayerArena.h>
+
+typedef std::vector<int, ArenaAllocator<int> > IntVec;
+
+int mainReturnValue = EXIT_SUCCESS;
+
+void TestAllocationsRewindWhenAllFreed()
+{
+    std::cout << "LayerArenaUT TestAllocationsRewindWhenAllFreed" << std::endl;
+
+    {
+        IntVec values;
+        for (int i = 0; i < 100; i++)
+            values.push_back(i);
+
+        if (LayerArena::Instance().GetUsed() == 0)
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestAllocationsRewindWhenAllFreed (LayerArenaUT) "
+                    << "message=Expected vector to be allocated from the arena" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+
+    if (LayerArena::Instance().GetUsed() != 0)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestAllocationsRewindWhenAllFreed (LayerArenaUT) "
+                << "message=Expected arena to rewind once everything was freed, still using "
+                << LayerArena::Instance().GetUsed() << " bytes" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestLargeAllocationUsesHeap()
+{
+    std::cout << "LayerArenaUT TestLargeAllocationUsesHeap" << std::endl;
+
+    IntVec values(LAYER_ARENA_SIZE, 1);
+
+    if (LayerArena::Instance().GetUsed() != 0)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestLargeAllocationUsesHeap (LayerArenaUT) "
+                << "message=Expected allocation larger than the arena to come from the heap, arena using "
+                << LayerArena::Instance().GetUsed() << " bytes" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+// Allocate a vector and record how much of the arena is in use meanwhile
+void* AllocateOnOtherThread(void* context)
+{
+    IntVec values(100, 1);
+    *static_cast<size_t*>(context) = LayerArena::Instance().GetUsed();
+    return NULL;
+}
+
+void TestAllocationOnOtherThreadUsesHeap()
+{
+    std::cout << "LayerArenaUT TestAllocationOnOtherThreadUsesHeap" << std::endl;
+
+    // claim the arena for this thread
+    LayerArena::Instance();
+
+    size_t used = 1;
+    pthread_t thread;
+    pthread_create(&thread, NULL, &AllocateOnOtherThread, &used);
+    pthread_join(thread, NULL);
+
+    if (used != 0)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestAllocationOnOtherThreadUsesHeap (LayerArenaUT) "
+                << "message=Expected allocation on another thread to come from the heap, arena using "
+                << used << " bytes" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestResetKeepsOutstandingAllocations()
+{
+    std::cout << "LayerArenaUT TestResetKeepsOutstandingAllocations" << std::endl;
+
+    IntVec values(100, 1);
+    size_t used = LayerArena::Instance().GetUsed();
+
+    LayerArena::Instance().Reset();
+
+    if (LayerArena::Instance().GetUsed() != used)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestResetKeepsOutstandingAllocations (LayerArenaUT) "
+                << "message=Expected reset to leave outstanding allocations in place, arena using "
+                << LayerArena::Instance().GetUsed() << " bytes instead of " << used << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    // the memory stays usable
+    IntVec moreValues(100, 2);
+    if (values.back() != 1 || moreValues.back() != 2)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestResetKeepsOutstandingAllocations (LayerArenaUT) "
+                << "message=Expected allocations made before and after reset not to overlap" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% LayerArenaUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestAllocationsRewindWhenAllFreed (LayerArenaUT)" << std::endl;
+    TestAllocationsRewindWhenAllFreed();
+    std::cout << "%TEST_FINISHED% time=0 TestAllocationsRewindWhenAllFreed (LayerArenaUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestLargeAllocationUsesHeap (LayerArenaUT)" << std::endl;
+    TestLargeAllocationUsesHeap();
+    std::cout << "%TEST_FINISHED% time=0 TestLargeAllocationUsesHeap (LayerArenaUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestAllocationOnOtherThreadUsesHeap (LayerArenaUT)" << std::endl;
+    TestAllocationOnOtherThreadUsesHeap();
+    std::cout << "%TEST_FINISHED% time=0 TestAllocationOnOtherThreadUsesHeap (LayerArenaUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestResetKeepsOutstandingAllocations (LayerArenaUT)" << std::endl;
+    TestResetKeepsOutstandingAllocations();
+    std::cout << "%TEST_FINISHED% time=0 TestResetKeepsOutstandingAllocations (LayerArenaUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
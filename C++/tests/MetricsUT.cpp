@@ -0,0 +1,165 @@
+//  File:   MetricsUT.cpp
+//  Tests Metrics
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <Metrics.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+// Report a failure unless the registry's text output contains the given line.
+void CheckOutputContains(const char* testName, const std::string& line)
+{
+    std::string text = Metrics::Instance().ToPrometheusText();
+    if (text.find(line + "\n") == std::string::npos)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (MetricsUT) message=Expected output to contain \"" 
+                << line << "\", got:\n" << text << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestCounter()
+{
+    std::cout << "MetricsUT TestCounter" << std::endl;
+    
+    Counter& counter = Metrics::Instance().GetCounter("test_counter_total", 
+                                                      "A test counter");
+    counter.Increment();
+    counter.Increment(4);
+    
+    // getting it again must return the same counter
+    Counter& again = Metrics::Instance().GetCounter("test_counter_total", 
+                                                    "A test counter");
+    if (&again != &counter || again.GetValue() != 5)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestCounter (MetricsUT) "
+                << "message=Expected the same counter with value 5, got " 
+                << again.GetValue() << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    CheckOutputContains("TestCounter", "# HELP test_counter_total A test counter");
+    CheckOutputContains("TestCounter", "# TYPE test_counter_total counter");
+    CheckOutputContains("TestCounter", "test_counter_total 5");
+}
+
+void TestGauge()
+{
+    std::cout << "MetricsUT TestGauge" << std::endl;
+    
+    Gauge& gauge = Metrics::Instance().GetGauge("test_gauge", "A test gauge");
+    gauge.Set(12.5);
+    gauge.Set(-3.25);
+    
+    if (gauge.GetValue() != -3.25)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGauge (MetricsUT) "
+                << "message=Expected gauge value -3.25, got " 
+                << gauge.GetValue() << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    CheckOutputContains("TestGauge", "# TYPE test_gauge gauge");
+    CheckOutputContains("TestGauge", "test_gauge -3.25");
+}
+
+void TestHistogram()
+{
+    std::cout << "MetricsUT TestHistogram" << std::endl;
+    
+    std::vector<double> bounds = {0.5, 1, 2};
+    Histogram& histogram = Metrics::Instance().GetHistogram("test_seconds", 
+                                                "A test histogram", bounds);
+    histogram.Observe(0.25);
+    histogram.Observe(0.5);
+    histogram.Observe(1.5);
+    histogram.Observe(10);
+    
+    if (histogram.GetCount() != 4)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestHistogram (MetricsUT) "
+                << "message=Expected 4 observations, got " 
+                << histogram.GetCount() << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    // buckets are cumulative, and a value equal to a bound falls in its bucket
+    CheckOutputContains("TestHistogram", "# TYPE test_seconds histogram");
+    CheckOutputContains("TestHistogram", "test_seconds_bucket{le=\"0.5\"} 2");
+    CheckOutputContains("TestHistogram", "test_seconds_bucket{le=\"1\"} 2");
+    CheckOutputContains("TestHistogram", "test_seconds_bucket{le=\"2\"} 3");
+    CheckOutputContains("TestHistogram", "test_seconds_bucket{le=\"+Inf\"} 4");
+    CheckOutputContains("TestHistogram", "test_seconds_sum 12.25");
+    CheckOutputContains("TestHistogram", "test_seconds_count 4");
+}
+
+void TestTypeMismatch()
+{
+    std::cout << "MetricsUT TestTypeMismatch" << std::endl;
+    
+    Metrics::Instance().GetCounter("test_mismatch_total", "A test counter");
+    try
+    {
+        Metrics::Instance().GetGauge("test_mismatch_total", "A test gauge");
+        std::cout << "%TEST_FAILED% time=0 testname=TestTypeMismatch (MetricsUT) "
+                << "message=Expected getting a counter as a gauge to throw" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    catch (const std::logic_error&)
+    {
+        // expected
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% MetricsUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestCounter (MetricsUT)" << std::endl;
+    TestCounter();
+    std::cout << "%TEST_FINISHED% time=0 TestCounter (MetricsUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGauge (MetricsUT)" << std::endl;
+    TestGauge();
+    std::cout << "%TEST_FINISHED% time=0 TestGauge (MetricsUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestHistogram (MetricsUT)" << std::endl;
+    TestHistogram();
+    std::cout << "%TEST_FINISHED% time=0 TestHistogram (MetricsUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestTypeMismatch (MetricsUT)" << std::endl;
+    TestTypeMismatch();
+    std::cout << "%TEST_FINISHED% time=0 TestTypeMismatch (MetricsUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
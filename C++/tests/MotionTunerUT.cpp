@@ -0,0 +1,219 @@
+//  File:   MotionTunerUT.cpp
+//  Tests MotionTuner
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <iostream>
+#include <cmath>
+
+#include "support/FileUtils.hpp"
+#include <MotionTuner.h>
+#include <Settings.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+std::string tempDir;
+
+// Stands in for the motors, succeeding only while the separation speed stays 
+// within a given limit
+class FakeTrial : public IMotionTrial
+{
+public:
+    FakeTrial(int maxSeparationMicronsPerSec) :
+    _maxSeparationMicronsPerSec(maxSeparationMicronsPerSec),
+    _runs(0)
+    {
+    }
+    
+    bool Run(const CurrentLayerSettings& cls)
+    {
+        _runs++;
+        return cls.SeparationMicronsPerSec <= _maxSeparationMicronsPerSec;
+    }
+    
+    int GetRuns() { return _runs; }
+    
+private:
+    int _maxSeparationMicronsPerSec;
+    int _runs;
+};
+
+// Load the motion profiles for the given layer type from the given settings.
+CurrentLayerSettings LoadProfile(Settings& settings, LayerType type)
+{
+    CurrentLayerSettings cls = CurrentLayerSettings();
+    cls.Type = type;
+    if (type == First)
+    {
+        cls.SeparationRotJerk = settings.GetInt(FL_SEPARATION_R_JERK);
+        cls.SeparationRPM = settings.GetInt(FL_SEPARATION_R_SPEED);
+        cls.SeparationZJerk = settings.GetInt(FL_SEPARATION_Z_JERK);
+        cls.SeparationMicronsPerSec = settings.GetInt(FL_SEPARATION_Z_SPEED);
+        cls.ApproachRotJerk = settings.GetInt(FL_APPROACH_R_JERK);
+        cls.ApproachRPM = settings.GetInt(FL_APPROACH_R_SPEED);
+        cls.ApproachZJerk = settings.GetInt(FL_APPROACH_Z_JERK);
+        cls.ApproachMicronsPerSec = settings.GetInt(FL_APPROACH_Z_SPEED);
+    }
+    else
+    {
+        cls.SeparationRotJerk = settings.GetInt(ML_SEPARATION_R_JERK);
+        cls.SeparationRPM = settings.GetInt(ML_SEPARATION_R_SPEED);
+        cls.SeparationZJerk = settings.GetInt(ML_SEPARATION_Z_JERK);
+        cls.SeparationMicronsPerSec = settings.GetInt(ML_SEPARATION_Z_SPEED);
+        cls.ApproachRotJerk = settings.GetInt(ML_APPROACH_R_JERK);
+        cls.ApproachRPM = settings.GetInt(ML_APPROACH_R_SPEED);
+        cls.ApproachZJerk = settings.GetInt(ML_APPROACH_Z_JERK);
+        cls.ApproachMicronsPerSec = settings.GetInt(ML_APPROACH_Z_SPEED);
+    }
+    return cls;
+}
+
+void CheckProfile(const char* testName, const CurrentLayerSettings& actual,
+                  const CurrentLayerSettings& expected)
+{
+    if (actual.SeparationRotJerk != expected.SeparationRotJerk ||
+        actual.SeparationRPM != expected.SeparationRPM ||
+        actual.SeparationZJerk != expected.SeparationZJerk ||
+        actual.SeparationMicronsPerSec != expected.SeparationMicronsPerSec ||
+        actual.ApproachRotJerk != expected.ApproachRotJerk ||
+        actual.ApproachRPM != expected.ApproachRPM ||
+        actual.ApproachZJerk != expected.ApproachZJerk ||
+        actual.ApproachMicronsPerSec != expected.ApproachMicronsPerSec)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (MotionTunerUT) message=Expected separation speed of " 
+                << expected.SeparationMicronsPerSec << " and RPM of " 
+                << expected.SeparationRPM << ", got " 
+                << actual.SeparationMicronsPerSec << " and " 
+                << actual.SeparationRPM << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void CheckFactor(const char* testName, double actual, double expected)
+{
+    if (std::abs(actual - expected) > 0.001)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (MotionTunerUT) message=Expected factor of " << expected
+                << ", got " << actual << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestRecordsFastestReliableProfileWithMargin()
+{
+    std::cout << "MotionTunerUT TestRecordsFastestReliableProfileWithMargin" << std::endl;
+
+    Settings settings(tempDir + "/settings");
+    CurrentLayerSettings original = LoadProfile(settings, Model);
+    CurrentLayerSettings firstLayer = LoadProfile(settings, First);
+    
+    // reliable up to 1.5 times the current separation speed
+    FakeTrial trial(original.SeparationMicronsPerSec * 1.55);
+    MotionTuner tuner(settings, trial);
+    double factor = tuner.Tune(original);
+    
+    CheckFactor("TestRecordsFastestReliableProfileWithMargin", factor, 
+                1.5 * 0.85);
+    
+    CurrentLayerSettings expected = original;
+    MotionTuner::Scale(expected, 1.5 * 0.85);
+    CheckProfile("TestRecordsFastestReliableProfileWithMargin", 
+                 LoadProfile(settings, Model), expected);
+    
+    // the tuned profile was persisted
+    settings.Refresh();
+    CheckProfile("TestRecordsFastestReliableProfileWithMargin", 
+                 LoadProfile(settings, Model), expected);
+    
+    // other layer types aren't changed
+    CheckProfile("TestRecordsFastestReliableProfileWithMargin", 
+                 LoadProfile(settings, First), firstLayer);
+}
+
+void TestUnreliableProfileNotRecorded()
+{
+    std::cout << "MotionTunerUT TestUnreliableProfileNotRecorded" << std::endl;
+
+    Settings settings(tempDir + "/unreliable");
+    CurrentLayerSettings original = LoadProfile(settings, Model);
+    
+    // fails even at the current speed
+    FakeTrial trial(original.SeparationMicronsPerSec - 1);
+    MotionTuner tuner(settings, trial);
+    double factor = tuner.Tune(original);
+    
+    CheckFactor("TestUnreliableProfileNotRecorded", factor, 0.0);
+    CheckProfile("TestUnreliableProfileNotRecorded", 
+                 LoadProfile(settings, Model), original);
+    
+    // no faster profiles are tried after the current one fails
+    if (trial.GetRuns() != 1)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestUnreliableProfileNotRecorded (MotionTunerUT) "
+                << "message=Expected a single trial, got " << trial.GetRuns() 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestNeverSlowerThanCurrentProfile()
+{
+    std::cout << "MotionTunerUT TestNeverSlowerThanCurrentProfile" << std::endl;
+
+    Settings settings(tempDir + "/slower");
+    CurrentLayerSettings original = LoadProfile(settings, Model);
+    
+    // only reliable up to 1.1 times the current speed, which after the safety
+    // margin is slower than the current profile
+    FakeTrial trial(original.SeparationMicronsPerSec * 1.15);
+    MotionTuner tuner(settings, trial);
+    double factor = tuner.Tune(original);
+    
+    CheckFactor("TestNeverSlowerThanCurrentProfile", factor, 1.0);
+    CheckProfile("TestNeverSlowerThanCurrentProfile", 
+                 LoadProfile(settings, Model), original);
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% MotionTunerUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    tempDir = CreateTempDir();
+
+    std::cout << "%TEST_STARTED% TestRecordsFastestReliableProfileWithMargin (MotionTunerUT)" << std::endl;
+    TestRecordsFastestReliableProfileWithMargin();
+    std::cout << "%TEST_FINISHED% time=0 TestRecordsFastestReliableProfileWithMargin (MotionTunerUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestUnreliableProfileNotRecorded (MotionTunerUT)" << std::endl;
+    TestUnreliableProfileNotRecorded();
+    std::cout << "%TEST_FINISHED% time=0 TestUnreliableProfileNotRecorded (MotionTunerUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestNeverSlowerThanCurrentProfile (MotionTunerUT)" << std::endl;
+    TestNeverSlowerThanCurrentProfile();
+    std::cout << "%TEST_FINISHED% time=0 TestNeverSlowerThanCurrentProfile (MotionTunerUT)" << std::endl;
+
+    RemoveDir(tempDir);
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
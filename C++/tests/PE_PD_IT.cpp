@@ -39,11 +39,15 @@
 #include "CommandPipe.h"
 #include "Projector.h"
 #include "FrameBuffer.h"
+#include "PrintDataLoader.h"
 
 int mainReturnValue = EXIT_SUCCESS;
 
 #define SETTINGS (PrinterSettings::Instance())
 
+// upper bound on event loop iterations to wait for print data loading
+constexpr int MAX_LOAD_ITERATIONS = 1000;
+
 class UIProxy : public ICallback
 {
     public:
@@ -92,6 +96,7 @@ public:
     Projector projector;
     PrinterStatusQueue printerStatusQueue;
     CommandPipe commandPipe;
+    PrintDataLoader printDataLoader;
     Timer timer1;
     Timer timer2;
     Timer timer3;
@@ -110,12 +115,13 @@ public:
     projector(nullI2cDevice),
     printerStatusQueue(),
     commandPipe(),
+    printDataLoader(),
     timer1(),
     timer2(),
     timer3(),
     timer4(),
-    printEngine(false, motor, projector, printerStatusQueue, timer1, timer2,
-                timer3, timer4),
+    printEngine(false, motor, projector, printerStatusQueue, printDataLoader,
+                timer1, timer2, timer3, timer4),
     commandInterpreter(&printEngine),
     ui()
     {
@@ -125,8 +131,10 @@ public:
 
         eventHandler.AddEvent(UICommand, &commandPipe);
         eventHandler.AddEvent(PrinterStatusUpdate, &printerStatusQueue);
+        eventHandler.AddEvent(PrintDataLoad, &printDataLoader);
         
         eventHandler.Subscribe(UICommand, &commandInterpreter);
+        eventHandler.Subscribe(PrintDataLoad, &printEngine);
         eventHandler.Subscribe(PrinterStatusUpdate, &ui);
         printEngine.Begin();
     }
@@ -176,6 +184,13 @@ public:
         
         // Process event queue
         eventHandler.Begin(4);
+        
+        // Keep processing events while the print data loads in the background,
+        // then deliver the status updates resulting from its completion
+        for (int i = 0; i < MAX_LOAD_ITERATIONS && 
+                        printEngine.IsLoadingPrintData(); i++)
+            eventHandler.Begin(1);
+        eventHandler.Begin(2);
     }
     
     void TestProcessPrintDataWhenPrintFileIsTarGzWhenTempSettingsFileNotPresent()
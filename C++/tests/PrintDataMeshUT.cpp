@@ -0,0 +1,334 @@
+//  File:   PrintDataMeshUT.cpp
+//  Tests PrintDataMesh
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+
+#include "support/FileUtils.hpp"
+#include <PrintDataMesh.h>
+#include <Filenames.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+std::string testDataDir;
+
+// layer thickness, in microns, that the tests slice with
+constexpr int layerThickness = 25;
+
+// Write a binary STL file containing a cube of the given side (in mm) with 
+// its base on the xy plane, centered on the z axis.
+void WriteCube(const std::string& path, float side)
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    char header[80] = {0};
+    file.write(header, sizeof(header));
+    uint32_t count = 12;
+    file.write(reinterpret_cast<char*>(&count), sizeof(count));
+    
+    float v[8][3];
+    for (int i = 0; i < 8; i++)
+    {
+        v[i][0] = (i & 1) ? side / 2 : -side / 2;
+        v[i][1] = (i & 2) ? side / 2 : -side / 2;
+        v[i][2] = (i & 4) ? side : 0;
+    }
+    
+    // vertices of each face in counter-clockwise order seen from outside
+    int faces[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                       {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+    float normal[3] = {0, 0, 0};
+    uint16_t attributes = 0;
+    for (int f = 0; f < 6; f++)
+    {
+        int triangles[2][3] = {{faces[f][0], faces[f][1], faces[f][2]},
+                               {faces[f][0], faces[f][2], faces[f][3]}};
+        for (int t = 0; t < 2; t++)
+        {
+            file.write(reinterpret_cast<char*>(normal), sizeof(normal));
+            for (int i = 0; i < 3; i++)
+                file.write(reinterpret_cast<char*>(v[triangles[t][i]]),
+                           sizeof(v[0]));
+            file.write(reinterpret_cast<char*>(&attributes), 
+                       sizeof(attributes));
+        }
+    }
+}
+
+void Setup()
+{
+    testDataDir = CreateTempDir();
+}
+
+void TearDown()
+{
+    RemoveDir(testDataDir);
+    
+    testDataDir = "";
+}
+
+void TestValidateWhenMeshValid()
+{
+    std::cout << "PrintDataMeshUT TestValidateWhenMeshValid" << std::endl;
+
+    WriteCube(testDataDir + "/" + MESH_FILE, 10.0);
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+
+    if (!printData.Validate())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestValidateWhenMeshValid (PrintDataMeshUT) "
+                << "message=Expected validate to return true when print data contains a valid mesh, got false" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestValidateWhenMeshNotBinarySTL()
+{
+    std::cout << "PrintDataMeshUT TestValidateWhenMeshNotBinarySTL" << std::endl;
+
+    std::ofstream file((testDataDir + "/" + MESH_FILE).c_str());
+    file << "solid cube" << std::endl << "endsolid cube" << std::endl;
+    file.close();
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+
+    if (printData.Validate())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestValidateWhenMeshNotBinarySTL (PrintDataMeshUT) "
+                << "message=Expected validate to return false when mesh is not a binary STL file, got true" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestValidateWhenMeshLargerThanBuildArea()
+{
+    std::cout << "PrintDataMeshUT TestValidateWhenMeshLargerThanBuildArea" << std::endl;
+
+    // wider than the 40 mm depth of the build area
+    WriteCube(testDataDir + "/" + MESH_FILE, 50.0);
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+
+    if (printData.Validate())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestValidateWhenMeshLargerThanBuildArea (PrintDataMeshUT) "
+                << "message=Expected validate to return false when mesh doesn't fit in the build area, got true" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestValidateWhenTriangleCountOverflows()
+{
+    std::cout << "PrintDataMeshUT TestValidateWhenTriangleCountOverflows" << std::endl;
+
+    std::string path = testDataDir + "/" + MESH_FILE;
+    WriteCube(path, 10.0);
+    
+    // replace the count of 12 triangles with one that, multiplied by the 
+    // size of each triangle record, wraps around to the same size in 32 bits
+    uint32_t count = 12 + 0x80000000;
+    std::fstream file(path.c_str(), 
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(80);
+    file.write(reinterpret_cast<char*>(&count), sizeof(count));
+    file.close();
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+
+    if (printData.Validate())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestValidateWhenTriangleCountOverflows (PrintDataMeshUT) "
+                << "message=Expected validate to return false when triangle count doesn't match file size, got true" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetLayerCount()
+{
+    std::cout << "PrintDataMeshUT TestGetLayerCount" << std::endl;
+
+    WriteCube(testDataDir + "/" + MESH_FILE, 10.0);
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+
+    // 10 mm at 25 microns per layer
+    int expectedLayerCount = 400;
+    int actualLayerCount = printData.GetLayerCount();
+    if (expectedLayerCount != actualLayerCount)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetLayerCount (PrintDataMeshUT) "
+                << "message=Layer count incorrect, expected " << expectedLayerCount << ", got " 
+                << actualLayerCount << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    // the count follows the thickness given, rather than the settings
+    printData.SetLayerThickness(2 * layerThickness);
+    expectedLayerCount = 200;
+    actualLayerCount = printData.GetLayerCount();
+    if (expectedLayerCount != actualLayerCount)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetLayerCount (PrintDataMeshUT) "
+                << "message=Layer count incorrect after changing thickness, expected " 
+                << expectedLayerCount << ", got " << actualLayerCount << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetImageForLayer()
+{
+    std::cout << "PrintDataMeshUT TestGetImageForLayer" << std::endl;
+
+    WriteCube(testDataDir + "/" + MESH_FILE, 10.0);
+
+    PrintDataMesh printData(testDataDir);
+    printData.SetLayerThickness(layerThickness);
+    
+    // check the first, a middle, and the last layer
+    int layers[] = {1, 200, 400};
+    for (int i = 0; i < 3; i++)
+    {
+        Magick::Image image;
+        if (!printData.GetImageForLayer(layers[i], &image))
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayer (PrintDataMeshUT) "
+                    << "message=Expected GetImageForLayer to return true for layer " << layers[i] 
+                    << ", got false" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+        
+        // the 10 mm cube covers 200 x 200 pixels of 50 microns each
+        std::vector<uint8_t> pixels(image.columns() * image.rows());
+        image.write(0, 0, image.columns(), image.rows(), "I", Magick::CharPixel,
+                    pixels.data());
+        int filled = 0;
+        for (size_t j = 0; j < pixels.size(); j++)
+            if (pixels[j] == 0xFF)
+                filled++;
+
+        if (filled != 200 * 200 || 
+            pixels[image.columns() * image.rows() / 2 + image.columns() / 2] != 0xFF)
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayer (PrintDataMeshUT) "
+                    << "message=Expected 40000 filled pixels centered in image for layer " << layers[i] 
+                    << ", got " << filled << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+    
+    // layers beyond the top of the mesh have no image
+    Magick::Image image;
+    if (printData.GetImageForLayer(401, &image))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayer (PrintDataMeshUT) "
+                << "message=Expected GetImageForLayer to return false for layer above mesh, got true" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestCreateFromExistingDataWhenDirectoryContainsMesh()
+{
+    std::cout << "PrintDataMeshUT TestCreateFromExistingDataWhenDirectoryContainsMesh" << std::endl;
+
+    WriteCube(testDataDir + "/" + MESH_FILE, 10.0);
+
+    PrintData* pPrintData = PrintData::CreateFromExistingData(testDataDir);
+
+    if (!dynamic_cast<PrintDataMesh*>(pPrintData))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestCreateFromExistingDataWhenDirectoryContainsMesh (PrintDataMeshUT) "
+                << "message=Expected CreateFromExistingData to return a PrintDataMesh instance" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    
+    delete pPrintData;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% PrintDataMeshUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestValidateWhenMeshValid (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestValidateWhenMeshValid();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestValidateWhenMeshValid (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestValidateWhenMeshNotBinarySTL (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestValidateWhenMeshNotBinarySTL();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestValidateWhenMeshNotBinarySTL (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestValidateWhenMeshLargerThanBuildArea (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestValidateWhenMeshLargerThanBuildArea();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestValidateWhenMeshLargerThanBuildArea (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestValidateWhenTriangleCountOverflows (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestValidateWhenTriangleCountOverflows();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestValidateWhenTriangleCountOverflows (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetLayerCount (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestGetLayerCount();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetLayerCount (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetImageForLayer (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestGetImageForLayer();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetImageForLayer (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestCreateFromExistingDataWhenDirectoryContainsMesh (PrintDataMeshUT)" << std::endl;
+    Setup();
+    TestCreateFromExistingDataWhenDirectoryContainsMesh();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestCreateFromExistingDataWhenDirectoryContainsMesh (PrintDataMeshUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
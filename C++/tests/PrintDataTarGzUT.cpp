@@ -0,0 +1,365 @@
+//  File:   PrintDataTarGzUT.cpp
+//  Tests PrintDataTarGz and TarGzIndex
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <stdexcept>
+
+#include "support/FileUtils.hpp"
+#include <PrintDataTarGz.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+std::string testDir;
+
+void Setup()
+{
+    testDir = CreateTempDir();
+}
+
+void TearDown()
+{
+    RemoveDir(testDir);
+    
+    testDir = "";
+}
+
+// Copy the specified archive into the test directory and index it, returning
+// the path to the copy
+std::string CopyAndIndex(const std::string& archive)
+{
+    Copy("resources/" + archive, testDir);
+    std::string archivePath = testDir + "/" + archive;
+    TarGzIndex index(archivePath, PrintDataTarGz::GetIndexPath(archivePath));
+    index.Build();
+    return archivePath;
+}
+
+void TestValidateWhenPrintDataValid()
+{
+    std::cout << "PrintDataTarGzUT TestValidateWhenPrintDataValid" << std::endl;
+
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+    
+    if (!printData.Validate())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestValidateWhenPrintDataValid (PrintDataTarGzUT) "
+                << "message=Expected validate to return true when print file contains consecutively named slice "
+                << "images starting with 1, got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetFileContentsWhenFilePresent()
+{
+    std::cout << "PrintDataTarGzUT TestGetFileContentsWhenFilePresent" << std::endl;
+
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+    
+    std::string contents;
+    if (!printData.GetFileContents("printsettings", contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetFileContentsWhenFilePresent (PrintDataTarGzUT) "
+                << "message=Expected GetFileContents to return true, got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    std::string expected = "{\"Settings\":{\"LayerThicknessMicrons\":10,\"JobName\":\"MyPrintJob\"}}";
+    if (contents.compare(0, expected.size(), expected) != 0)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetFileContentsWhenFilePresent (PrintDataTarGzUT) "
+                << "message=Expected contents to be \"" << expected << "\", got \"" << contents << "\"" 
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetFileContentsWhenFileNotPresent()
+{
+    std::cout << "PrintDataTarGzUT TestGetFileContentsWhenFileNotPresent" << std::endl;
+
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+    
+    std::string contents;
+    if (printData.GetFileContents("bogus", contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetFileContentsWhenFileNotPresent (PrintDataTarGzUT) "
+                << "message=Expected GetFileContents to return false, got true" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetImageForLayer()
+{
+    std::cout << "PrintDataTarGzUT TestGetImageForLayer" << std::endl;
+
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+    
+    Magick::Image image;
+    for (int layer = 1; layer <= 2; layer++)
+    {
+        if (!printData.GetImageForLayer(layer, &image))
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayer (PrintDataTarGzUT) "
+                    << "message=Expected GetImageForLayer to return true, got false for layer "
+                    << layer << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+}
+
+void TestMoveWhenDestinationDirectoryExists()
+{
+    std::cout << "PrintDataTarGzUT TestMoveWhenDestinationDirectoryExists" << std::endl;
+
+    // Make a destination directory
+    std::string destinationDir = testDir + "/destination";
+    mkdir(destinationDir.c_str(), 0755);
+    
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+    
+    if (!printData.Move(destinationDir))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMoveWhenDestinationDirectoryExists (PrintDataTarGzUT) "
+                << "message=Expected Move to return true, got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    // Specified destination contains the print file and its index
+    std::string printFile = destinationDir + "/print.tar.gz";
+    std::string indexFile = PrintDataTarGz::GetIndexPath(printFile);
+    if (!std::ifstream(printFile.c_str()) || !std::ifstream(indexFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMoveWhenDestinationDirectoryExists (PrintDataTarGzUT) "
+                << "message=Expected destination directory to contain print file and its index, "
+                << "not all present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    // Verify that PrintData instance knows where its data resides after moving
+    std::string contents;
+    if (!printData.GetFileContents("printsettings", contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMoveWhenDestinationDirectoryExists (PrintDataTarGzUT) "
+                << "message=Unable to read print data after moving" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestMoveWhenDestinationDirectoryDoesNotExist()
+{
+    std::cout << "PrintDataTarGzUT TestMoveWhenDestinationDirectoryDoesNotExist" << std::endl;
+
+    PrintDataTarGz printData(CopyAndIndex("print.tar.gz"));
+
+    if (printData.Move("bogus"))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMoveWhenDestinationDirectoryDoesNotExist (PrintDataTarGzUT) "
+                << "message=Expected Move to return false, got true" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    // Verify that PrintData instance knows where its data resides after failure to move
+    std::string contents;
+    if (!printData.GetFileContents("printsettings", contents))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMoveWhenDestinationDirectoryDoesNotExist (PrintDataTarGzUT) "
+                << "message=Unable to read print data after failing to move" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestRemoveWhenUnderlyingDataExists()
+{
+    std::cout << "PrintDataTarGzUT TestRemoveWhenUnderlyingDataExists" << std::endl;
+
+    std::string printFile = CopyAndIndex("print.tar.gz");
+    PrintDataTarGz printData(printFile);
+
+    if (!printData.Remove())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestRemoveWhenUnderlyingDataExists (PrintDataTarGzUT) "
+                << "message=Expected Remove to return true, got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    std::string indexFile = PrintDataTarGz::GetIndexPath(printFile);
+    if (std::ifstream(printFile.c_str()) || std::ifstream(indexFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestRemoveWhenUnderlyingDataExists (PrintDataTarGzUT) "
+                << "message=Expected Remove to remove print file and its index, file still present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestConstructorWhenIndexMissing()
+{
+    std::cout << "PrintDataTarGzUT TestConstructorWhenIndexMissing" << std::endl;
+
+    Copy("resources/print.tar.gz", testDir);
+
+    try
+    {
+        PrintDataTarGz printData(testDir + "/print.tar.gz");
+        
+        std::cout << "%TEST_FAILED% time=0 testname=TestConstructorWhenIndexMissing (PrintDataTarGzUT) "
+                << "message=Expected constructor to throw when print file has not been indexed" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    catch (const std::runtime_error& e)
+    {
+    }
+}
+
+void TestBuildIndexWhenArchiveCorrupt()
+{
+    std::cout << "PrintDataTarGzUT TestBuildIndexWhenArchiveCorrupt" << std::endl;
+
+    Copy("resources/corrupt.tar.gz", testDir);
+    
+    std::string printFile = testDir + "/corrupt.tar.gz";
+    std::string indexFile = PrintDataTarGz::GetIndexPath(printFile);
+    TarGzIndex index(printFile, indexFile);
+
+    if (index.Build())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestBuildIndexWhenArchiveCorrupt (PrintDataTarGzUT) "
+                << "message=Expected Build to return false, got true" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    if (std::ifstream(indexFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestBuildIndexWhenArchiveCorrupt (PrintDataTarGzUT) "
+                << "message=Expected Build to leave no index file behind, file present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestBuildIndexWhenAbandoned()
+{
+    std::cout << "PrintDataTarGzUT TestBuildIndexWhenAbandoned" << std::endl;
+
+    Copy("resources/print.tar.gz", testDir);
+    
+    std::string printFile = testDir + "/print.tar.gz";
+    std::string indexFile = PrintDataTarGz::GetIndexPath(printFile);
+    TarGzIndex index(printFile, indexFile);
+
+    if (index.Build([](double fractionDone) { return false; }))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestBuildIndexWhenAbandoned (PrintDataTarGzUT) "
+                << "message=Expected Build to return false, got true" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    if (std::ifstream(indexFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestBuildIndexWhenAbandoned (PrintDataTarGzUT) "
+                << "message=Expected Build to leave no index file behind, file present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% PrintDataTarGzUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestValidateWhenPrintDataValid (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestValidateWhenPrintDataValid();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestValidateWhenPrintDataValid (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetFileContentsWhenFilePresent (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestGetFileContentsWhenFilePresent();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetFileContentsWhenFilePresent (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetFileContentsWhenFileNotPresent (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestGetFileContentsWhenFileNotPresent();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetFileContentsWhenFileNotPresent (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetImageForLayer (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestGetImageForLayer();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetImageForLayer (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestMoveWhenDestinationDirectoryExists (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestMoveWhenDestinationDirectoryExists();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestMoveWhenDestinationDirectoryExists (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestMoveWhenDestinationDirectoryDoesNotExist (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestMoveWhenDestinationDirectoryDoesNotExist();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestMoveWhenDestinationDirectoryDoesNotExist (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestRemoveWhenUnderlyingDataExists (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestRemoveWhenUnderlyingDataExists();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestRemoveWhenUnderlyingDataExists (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestConstructorWhenIndexMissing (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestConstructorWhenIndexMissing();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestConstructorWhenIndexMissing (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestBuildIndexWhenArchiveCorrupt (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestBuildIndexWhenArchiveCorrupt();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestBuildIndexWhenArchiveCorrupt (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestBuildIndexWhenAbandoned (PrintDataTarGzUT)" << std::endl;
+    Setup();
+    TestBuildIndexWhenAbandoned();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestBuildIndexWhenAbandoned (PrintDataTarGzUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
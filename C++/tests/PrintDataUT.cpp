@@ -94,7 +94,7 @@ void TestCreateFromNewDataWhenDownloadDirectoryContainsTarGzFile()
         return;
     }
 
-    // extracts the archive (layer count is determined by looking for slice files after extracting)
+    // indexes the archive (layer count is determined by looking for slice files in the index)
     int expectedLayerCount = 2;
     int actualLayerCount = pPrintData->GetLayerCount();
     if (expectedLayerCount != actualLayerCount)
@@ -336,6 +336,38 @@ void TestCreateFromExistingDataWhenSpecifiedFileAZipFile()
     }
 }
 
+void TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile()
+{
+    std::cout << "PrintDataUT TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile" << std::endl;
+
+    // Staging a tar.gz file leaves it alongside its index
+    Copy("resources/print.tar.gz", testDownloadDir);
+    PrintFileStorage storage(testDownloadDir);
+    delete PrintData::CreateFromNewData(storage, testStagingDir, "new_name");
+    
+    boost::scoped_ptr<PrintData> pPrintData(PrintData::CreateFromExistingData(testStagingDir + "/new_name"));
+
+    if (!pPrintData)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile (PrintDataUT) "
+                << "message=got NULL pointer when attempting to create instance from indexed tar.gz file"
+                << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    int expectedLayerCount = 2;
+    int actualLayerCount = pPrintData->GetLayerCount();
+    if (expectedLayerCount != actualLayerCount)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile (PrintDataUT) "
+                << "message=Layer count incorrect after creating PrintData instance, expected "
+                << expectedLayerCount << ", got " << actualLayerCount << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
 void TestCreateFromExistingDataWhenSpecifiedFileACorruptZipFile()
 {
     std::cout << "PrintDataUT TestCreateFromExistingDataWhenSpecifiedFileACorruptZipFile" << std::endl;
@@ -406,6 +438,12 @@ int main(int argc, char** argv) {
     TearDown();
     std::cout << "%TEST_FINISHED% time=0 TestCreateFromExistingDataWhenSpecifiedFileAZipFile (PrintDataUT)" << std::endl;
     
+    std::cout << "%TEST_STARTED% TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile (PrintDataUT)" << std::endl;
+    Setup();
+    TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestCreateFromExistingDataWhenSpecifiedFileAnIndexedTarGzFile (PrintDataUT)" << std::endl;
+    
     std::cout << "%TEST_STARTED% TestCreateFromExistingDataWhenSpecifiedFileACorruptZipFile (PrintDataUT)" << std::endl;
     Setup();
     TestCreateFromExistingDataWhenSpecifiedFileACorruptZipFile();
@@ -23,6 +23,7 @@
 
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "support/FileUtils.hpp"
 #include <PrintDataZip.h>
@@ -275,6 +276,114 @@ void TestRemoveWhenUnderlyingDataDoesNotExist()
     }
 }
 
+void TestRemoveWhenFileNotOwned()
+{
+    std::cout << "PrintDataZipUT TestRemoveWhenFileNotOwned" << std::endl;
+ 
+    Copy("resources/print.zip", testDir);
+
+    PrintDataZip printData(testDir + "/print.zip", false);
+    
+    if (!printData.Remove())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestRemoveWhenFileNotOwned (PrintDataZipUT) "
+                << "message=Expected Remove to return true, got false" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+
+    std::string printFile = testDir + "/print.zip";
+    if (!std::ifstream(printFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestRemoveWhenFileNotOwned (PrintDataZipUT) "
+                << "message=Expected Remove to leave print data it does not own, file not present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+void TestGetImageForLayerWhenReadAhead()
+{
+    std::cout << "PrintDataZipUT TestGetImageForLayerWhenReadAhead" << std::endl;
+ 
+    Copy("resources/print.zip", testDir);
+
+    std::string printFile = testDir + "/print.zip";
+    PrintDataZip printData(printFile, false, 2);
+    
+    // read both layers ahead, then make the underlying file unreadable, as if
+    // the drive holding it had been removed
+    printData.ReadAhead(0);
+    printData.AwaitReadAhead();
+    truncate(printFile.c_str(), 0);
+    
+    Magick::Image image;
+    for (int layer = 1; layer <= 2; layer++)
+    {
+        if (!printData.GetImageForLayer(layer, &image))
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayerWhenReadAhead (PrintDataZipUT) "
+                    << "message=Expected GetImageForLayer to return true for layer read ahead, got false for layer "
+                    << layer << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+}
+
+void TestGetImageForLayerWhenCopied()
+{
+    std::cout << "PrintDataZipUT TestGetImageForLayerWhenCopied" << std::endl;
+ 
+    Copy("resources/print.zip", testDir);
+
+    std::string printFile = testDir + "/print.zip";
+    std::string copyFile = testDir + "/copy.zip";
+    {
+        PrintDataZip printData(printFile, false, 1, copyFile);
+
+        if (!printData.IsOnRemovableStorage())
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayerWhenCopied (PrintDataZipUT) "
+                    << "message=Expected IsOnRemovableStorage to return true before copying, got false" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+        
+        // read only the first layer ahead, but let the whole file be copied, 
+        // then make the original unreadable, as if the drive holding it had 
+        // been removed
+        printData.ReadAhead(0);
+        printData.AwaitReadAhead();
+        truncate(printFile.c_str(), 0);
+
+        if (printData.IsOnRemovableStorage())
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayerWhenCopied (PrintDataZipUT) "
+                    << "message=Expected IsOnRemovableStorage to return false after copying, got true" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+
+        Magick::Image image;
+        if (!printData.GetImageForLayer(2, &image))
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayerWhenCopied (PrintDataZipUT) "
+                    << "message=Expected GetImageForLayer to return true for layer not read ahead, got false" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+            return;
+        }
+    }
+    
+    if (std::ifstream(copyFile.c_str()))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestGetImageForLayerWhenCopied (PrintDataZipUT) "
+                << "message=Expected copy to be removed along with the print data, file present" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
 int main(int argc, char** argv) {
     std::cout << "%SUITE_STARTING% PrintDataZipUT" << std::endl;
     std::cout << "%SUITE_STARTED%" << std::endl;
@@ -333,6 +442,24 @@ int main(int argc, char** argv) {
     TearDown();
     std::cout << "%TEST_FINISHED% time=0 TestRemoveWhenUnderlyingDataDoesNotExist (PrintDataZipUT)" << std::endl;
 
+    std::cout << "%TEST_STARTED% TestRemoveWhenFileNotOwned (PrintDataZipUT)" << std::endl;
+    Setup();
+    TestRemoveWhenFileNotOwned();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestRemoveWhenFileNotOwned (PrintDataZipUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetImageForLayerWhenReadAhead (PrintDataZipUT)" << std::endl;
+    Setup();
+    TestGetImageForLayerWhenReadAhead();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetImageForLayerWhenReadAhead (PrintDataZipUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestGetImageForLayerWhenCopied (PrintDataZipUT)" << std::endl;
+    Setup();
+    TestGetImageForLayerWhenCopied();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestGetImageForLayerWhenCopied (PrintDataZipUT)" << std::endl;
+
     std::cout << "%SUITE_FINISHED% time=0" << std::endl;
 
     return (mainReturnValue);
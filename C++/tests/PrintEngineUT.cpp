@@ -44,6 +44,7 @@
 #include "Timer.h"
 #include "FrameBuffer.h"
 #include "Projector.h"
+#include "PrintDataLoader.h"
 
 #define STATE_NAME  PrinterStatus::GetStateName
 #define SETTINGS (PrinterSettings::Instance())
@@ -178,13 +179,14 @@ void test1() {
     NullI2C_Device nullI2cDevice;
     Motor motor(nullI2cDevice);
     PrinterStatusQueue printerStatusQueue;
+    PrintDataLoader printDataLoader;
     Timer timer1;
     Timer timer2;
     Timer timer3;
     Timer timer4;
     Projector projector(nullI2cDevice);
-    PrintEngine pe(false, motor, projector, printerStatusQueue, timer1, timer2,
-                   timer3, timer4);
+    PrintEngine pe(false, motor, projector, printerStatusQueue, printDataLoader,
+                   timer1, timer2, timer3, timer4);
     pe.Begin();
     
     PrinterStateMachine* pPSM = pe.GetStateMachine();
@@ -881,6 +883,74 @@ void test1() {
     std::cout << "\ttest completed" << std::endl;
 }
 
+void test2() {
+    unsigned char mcSuccess = MC_STATUS_SUCCESS;
+    char gpioHigh = '1';
+    char gpioLow = '0';
+    
+    std::cout << "PrintEngineUT test 2" << std::endl;
+    
+    SETTINGS.Set(SKIP_REDUNDANT_HOMING, 1);
+    
+    NullI2C_Device nullI2cDevice;
+    Motor motor(nullI2cDevice);
+    PrinterStatusQueue printerStatusQueue;
+    PrintDataLoader printDataLoader;
+    Timer timer1;
+    Timer timer2;
+    Timer timer3;
+    Timer timer4;
+    Projector projector(nullI2cDevice);
+    PrintEngine pe(false, motor, projector, printerStatusQueue, printDataLoader,
+                   timer1, timer2, timer3, timer4);
+    pe.Begin();
+    
+    // positions aren't known on startup, so the motors must be homed 
+    PrinterStateMachine* pPSM = pe.GetStateMachine();
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomingState)))
+        return;
+    
+    ((ICallback*)&pe)->Callback(MotorInterrupt, EventData(mcSuccess));
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomeState)))
+        return;
+    
+    if (!pe.MotorsAtHome())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (PrintEngineUT) message=motors not at home after homing completed" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    std::cout << "	about to reset with motors already at home" << std::endl;
+    pPSM->process_event(EvReset());
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomeState)))
+        return;
+    
+    std::cout << "	about to open and close the door" << std::endl;
+    ((ICallback*)&pe)->Callback(DoorInterrupt, EventData(gpioHigh)); 
+    ((ICallback*)&pe)->Callback(DoorInterrupt, EventData(gpioLow)); 
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomeState)))
+        return;
+    
+    if (pe.MotorsAtHome())
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (PrintEngineUT) message=motors still at home after door opened" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    // the tray may have been moved, so it must be homed again
+    pPSM->process_event(EvReset());
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomingState)))
+        return;
+    
+    ((ICallback*)&pe)->Callback(MotorInterrupt, EventData(mcSuccess));
+    if (!ConfimExpectedState(pPSM, STATE_NAME(HomeState)))
+        return;
+
+    std::cout << "	test completed" << std::endl;
+}
+
 int main(int argc, char** argv) {
     std::cout << "%SUITE_STARTING% PrintEngineUT" << std::endl;
     std::cout << "%SUITE_STARTED%" << std::endl;
@@ -891,6 +961,12 @@ int main(int argc, char** argv) {
     TearDown();
     std::cout << "%TEST_FINISHED% time=0 test1 (PrintEngineUT)" << std::endl;
 
+    std::cout << "%TEST_STARTED% test2 (PrintEngineUT)" << std::endl;
+    Setup();
+    test2();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 test2 (PrintEngineUT)" << std::endl;
+
     std::cout << "%SUITE_FINISHED% time=0" << std::endl;
 
     return (mainReturnValue);
@@ -0,0 +1,379 @@
+//  File:   ProjectorUT.cpp
+//  Tests Projector
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "support/FileUtils.hpp"
+#include <Projector.h>
+#include <I_I2C_Device.h>
+#include <Hardware.h>
+#include <Settings.h>
+#include <mock_hardware/Shared.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+std::string tempDir;
+
+// Emulates a projector with pattern mode support on the I2C bus, and records
+// the data written to each register.
+class MockProjectorI2C_Device : public I_I2C_Device
+{
+public:
+    // the data written to each register, in the order it was written
+    mutable std::map<unsigned char, std::vector<std::vector<unsigned char>>>
+                                                                        writes;
+    // registers to which the next write fails
+    mutable std::set<unsigned char> failNextWrite;
+    // whether the video stays frozen, as when the projector never syncs up
+    bool videoFrozen = false;
+
+    bool Write(unsigned char data) const { return true; }
+    
+    bool Write(unsigned char registerAddress, unsigned char data) const
+    {
+        return Write(registerAddress, &data, 1);
+    }
+    
+    bool Write(unsigned char registerAddress, const unsigned char* data, 
+               int length) const
+    {
+        unsigned char reg = registerAddress & ~PROJECTOR_WRITE_BIT;
+        writes[reg].push_back(std::vector<unsigned char>(data, data + length));
+        return failNextWrite.erase(reg) == 0;
+    }
+    
+    unsigned char Read(unsigned char registerAddress) const { return 0x00; }
+    
+    bool Read(unsigned char registerAddress, unsigned char* data, 
+              int length) const { return true; }
+    
+    unsigned char ReadWhenReady(unsigned char registerAddress,
+                                unsigned char readyStatus) const
+    {
+        switch (registerAddress)
+        {
+            case PROJECTOR_HW_STATUS_REG:
+                return PROJECTOR_INIT_ERROR;
+            case PROJECTOR_SYSTEM_STATUS_REG:
+                return PROJECTOR_SYSTEM_MEMORY_FLAG;
+            case PROJECTOR_MAIN_STATUS_REG:
+                return PROJECTOR_SEQUENCER_RUNNING | 
+                       (videoFrozen ? PROJECTOR_VIDEO_FROZEN : 0);
+            default:
+                return 0x00;
+        }
+    }
+    
+    bool ReadWhenReady(unsigned char registerAddress, unsigned char* data, 
+                       int length, unsigned char readyStatus) const
+    {
+        std::fill(data, data + length, 0);
+        if (registerAddress == PROJECTOR_FW_VERSION_REG && length >= 4)
+        {
+            data[3] = CURRENT_PROJECTOR_FW_MAJ_VERSION;
+            data[2] = CURRENT_PROJECTOR_FW_MIN_VERSION;
+        }
+        return true;
+    }
+    
+    // the number of writes to the given register
+    size_t WriteCount(unsigned char registerAddress) const
+    {
+        return writes[registerAddress].size();
+    }
+};
+
+void Fail(const char* testName, const std::string& message)
+{
+    std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+            << " (ProjectorUT) message=" << message << std::endl;
+    mainReturnValue = EXIT_FAILURE;
+}
+
+void CheckWriteCount(const char* testName, 
+                     const MockProjectorI2C_Device& i2c, 
+                     unsigned char registerAddress, size_t expected)
+{
+    size_t actual = i2c.WriteCount(registerAddress);
+    if (actual != expected)
+    {
+        std::ostringstream message;
+        message << "Expected " << expected << " writes to register 0x" 
+                << std::hex << static_cast<int>(registerAddress) << std::dec 
+                << ", got " << actual;
+        Fail(testName, message.str());
+    }
+}
+
+// Check the number of patterns the last programmed sequence shows, and that 
+// it shows them once rather than repeating them.
+void CheckSequenceFrames(const char* testName, 
+                         const MockProjectorI2C_Device& i2c, int expected)
+{
+    if (i2c.WriteCount(PROJECTOR_PATTERN_LUT_CTL_REG) == 0)
+    {
+        Fail(testName, "Expected sequence to be programmed");
+        return;
+    }
+    
+    const std::vector<unsigned char>& lut = 
+                                i2c.writes[PROJECTOR_PATTERN_LUT_CTL_REG].back();
+    if (lut[2] + 1 != expected || lut[1] != 0)
+        Fail(testName, "Expected sequence of " + std::to_string(expected) + 
+                       " frames, got " + std::to_string(lut[2] + 1));
+}
+
+void Setup()
+{
+    tempDir = CreateTempDir();
+    PrinterSettings::Instance().Set(PROJECTOR_LED_CURRENT, 100);
+    
+    // capture frames rather than writing them to image files
+    setenv(FRAME_CAPTURE_LOG_VAR, (tempDir + "/frames.log").c_str(), 1);
+}
+
+void TearDown()
+{
+    RemoveDir(tempDir);
+}
+
+void TestRepeatedLEDOnWritesOnce()
+{
+    std::cout << "ProjectorUT TestRepeatedLEDOnWritesOnce" << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    
+    projector.ShowWhite();
+    projector.ShowWhite();
+    projector.ShowWhite();
+    
+    // the current and polarity are only written the first time, but the LEDs 
+    // are enabled every time, since a change of source may disable them
+    CheckWriteCount("TestRepeatedLEDOnWritesOnce", i2c, 
+                    PROJECTOR_LED_CURRENT_REG, 1);
+    CheckWriteCount("TestRepeatedLEDOnWritesOnce", i2c, 
+                    PROJECTOR_LED_PWM_POLARITY_REG, 1);
+    CheckWriteCount("TestRepeatedLEDOnWritesOnce", i2c, 
+                    PROJECTOR_LED_ENABLE_REG, 4);   // includes off in ctor
+    
+    // a change of the current setting is written
+    PrinterSettings::Instance().Set(PROJECTOR_LED_CURRENT, 101);
+    projector.ShowWhite();
+    CheckWriteCount("TestRepeatedLEDOnWritesOnce", i2c, 
+                    PROJECTOR_LED_CURRENT_REG, 2);
+    PrinterSettings::Instance().Set(PROJECTOR_LED_CURRENT, 100);
+}
+
+void TestModeChangeInvalidatesShadow()
+{
+    std::cout << "ProjectorUT TestModeChangeInvalidatesShadow" << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    
+    projector.ShowWhite();
+    projector.EnterProgramMode(true);
+    projector.ShowWhite();
+    
+    CheckWriteCount("TestModeChangeInvalidatesShadow", i2c, 
+                    PROJECTOR_LED_CURRENT_REG, 2);
+    CheckWriteCount("TestModeChangeInvalidatesShadow", i2c, 
+                    PROJECTOR_LED_PWM_POLARITY_REG, 2);
+}
+
+void TestFailedWriteInvalidatesShadow()
+{
+    std::cout << "ProjectorUT TestFailedWriteInvalidatesShadow" << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    
+    i2c.failNextWrite.insert(PROJECTOR_LED_CURRENT_REG);
+    projector.ShowWhite();
+    // the failed write may have left the register holding any value
+    projector.ShowWhite();
+    projector.ShowWhite();
+    
+    CheckWriteCount("TestFailedWriteInvalidatesShadow", i2c, 
+                    PROJECTOR_LED_CURRENT_REG, 2);
+    CheckWriteCount("TestFailedWriteInvalidatesShadow", i2c, 
+                    PROJECTOR_LED_PWM_POLARITY_REG, 1);
+}
+
+void TestNoVideoSyncFailsModeChange()
+{
+    std::cout << "ProjectorUT TestNoVideoSyncFailsModeChange" << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    
+    i2c.videoFrozen = true;
+    if (projector.SetPatternMode())
+        Fail("TestNoVideoSyncFailsModeChange", 
+             "Expected pattern mode to fail without video sync");
+}
+
+void TestCanTimeExposure()
+{
+    std::cout << "ProjectorUT TestCanTimeExposure" << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    
+    if (projector.CanTimeExposure(1.0))
+        Fail("TestCanTimeExposure", "Expected no timing outside pattern mode");
+    
+    if (!projector.SetPatternMode())
+    {
+        Fail("TestCanTimeExposure", "Unable to set pattern mode");
+        return;
+    }
+    
+    // the pattern LUT holds 128 frames of 1/60 s
+    if (!projector.CanTimeExposure(2.13))
+        Fail("TestCanTimeExposure", "Expected 2.13 s exposure to be timed");
+    if (projector.CanTimeExposure(2.2))
+        Fail("TestCanTimeExposure", "Expected 2.2 s exposure not to be timed");
+}
+
+void TestPreparedExposureStartsWithoutProgramming()
+{
+    std::cout << "ProjectorUT TestPreparedExposureStartsWithoutProgramming" 
+              << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    if (!projector.SetPatternMode())
+    {
+        Fail("TestPreparedExposureStartsWithoutProgramming", 
+             "Unable to set pattern mode");
+        return;
+    }
+    
+    // half a second is 30 frames
+    if (!projector.PrepareTimedExposure(0.5))
+        Fail("TestPreparedExposureStartsWithoutProgramming", 
+             "Unable to prepare exposure");
+    CheckSequenceFrames("TestPreparedExposureStartsWithoutProgramming", i2c, 
+                        30);
+    
+    i2c.writes.clear();
+    if (!projector.StartTimedExposure(0.5))
+        Fail("TestPreparedExposureStartsWithoutProgramming", 
+             "Unable to start exposure");
+    
+    CheckWriteCount("TestPreparedExposureStartsWithoutProgramming", i2c, 
+                    PROJECTOR_PATTERN_LUT_CTL_REG, 0);
+    CheckWriteCount("TestPreparedExposureStartsWithoutProgramming", i2c, 
+                    PROJECTOR_PATTERN_LUT_DATA_REG, 0);
+    
+    // the sequence is stopped and started again
+    const std::vector<std::vector<unsigned char>>& starts = 
+                                        i2c.writes[PROJECTOR_PATTERN_START_REG];
+    if (starts.size() != 2 || starts[0][0] != PROJECTOR_STOP_PATTERN_SEQ ||
+        starts[1][0] != PROJECTOR_START_PATTERN_SEQ)
+        Fail("TestPreparedExposureStartsWithoutProgramming", 
+             "Expected sequence to be stopped and started");
+}
+
+void TestUnpreparedExposureProgramsSequence()
+{
+    std::cout << "ProjectorUT TestUnpreparedExposureProgramsSequence" 
+              << std::endl;
+    
+    MockProjectorI2C_Device i2c;
+    Projector projector(i2c);
+    if (!projector.SetPatternMode())
+    {
+        Fail("TestUnpreparedExposureProgramsSequence", 
+             "Unable to set pattern mode");
+        return;
+    }
+    
+    // an exposure time different from the prepared one, such as the 
+    // remainder of an interrupted exposure, is programmed when it starts
+    projector.PrepareTimedExposure(0.5);
+    i2c.writes.clear();
+    if (!projector.StartTimedExposure(0.25))
+        Fail("TestUnpreparedExposureProgramsSequence", 
+             "Unable to start exposure");
+    
+    CheckWriteCount("TestUnpreparedExposureProgramsSequence", i2c, 
+                    PROJECTOR_PATTERN_LUT_CTL_REG, 1);
+    CheckSequenceFrames("TestUnpreparedExposureProgramsSequence", i2c, 15);
+    
+    // showing an image any other way restores the repeating sequence
+    projector.ShowWhite();
+    const std::vector<unsigned char>& lut = 
+                                i2c.writes[PROJECTOR_PATTERN_LUT_CTL_REG].back();
+    if (lut[1] != 1)
+        Fail("TestUnpreparedExposureProgramsSequence", 
+             "Expected repeating sequence to be restored");
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% ProjectorUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    Setup();
+
+    std::cout << "%TEST_STARTED% TestRepeatedLEDOnWritesOnce (ProjectorUT)" << std::endl;
+    TestRepeatedLEDOnWritesOnce();
+    std::cout << "%TEST_FINISHED% time=0 TestRepeatedLEDOnWritesOnce (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestModeChangeInvalidatesShadow (ProjectorUT)" << std::endl;
+    TestModeChangeInvalidatesShadow();
+    std::cout << "%TEST_FINISHED% time=0 TestModeChangeInvalidatesShadow (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestFailedWriteInvalidatesShadow (ProjectorUT)" << std::endl;
+    TestFailedWriteInvalidatesShadow();
+    std::cout << "%TEST_FINISHED% time=0 TestFailedWriteInvalidatesShadow (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestNoVideoSyncFailsModeChange (ProjectorUT)" << std::endl;
+    TestNoVideoSyncFailsModeChange();
+    std::cout << "%TEST_FINISHED% time=0 TestNoVideoSyncFailsModeChange (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestCanTimeExposure (ProjectorUT)" << std::endl;
+    TestCanTimeExposure();
+    std::cout << "%TEST_FINISHED% time=0 TestCanTimeExposure (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestPreparedExposureStartsWithoutProgramming (ProjectorUT)" << std::endl;
+    TestPreparedExposureStartsWithoutProgramming();
+    std::cout << "%TEST_FINISHED% time=0 TestPreparedExposureStartsWithoutProgramming (ProjectorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestUnpreparedExposureProgramsSequence (ProjectorUT)" << std::endl;
+    TestUnpreparedExposureProgramsSequence();
+    std::cout << "%TEST_FINISHED% time=0 TestUnpreparedExposureProgramsSequence (ProjectorUT)" << std::endl;
+
+    TearDown();
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
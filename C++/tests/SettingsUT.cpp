@@ -29,6 +29,7 @@
 
 #include "support/FileUtils.hpp"
 #include <Settings.h>
+#include <Shared.h>
 
 int mainReturnValue = EXIT_SUCCESS;
 
@@ -472,6 +473,85 @@ void test1() {
     }
 }
 
+void TestLoadMissingSettings()
+{
+    std::cout << "SettingsUT TestLoadMissingSettings" << std::endl;
+    
+    // a settings file lacking most settings, as after a firmware upgrade 
+    // that adds several new ones
+    std::string path = tempDir + "/MissingSettingsUT";
+    std::ofstream file(path.c_str());
+    file << "{\"" << SETTINGS_ROOT_KEY << "\":{\"" << LAYER_THICKNESS << 
+            "\":15,\"" << JOB_NAME_SETTING << "\":\"OldJobName\"}}";
+    file.close();
+    
+    Settings settings(path);
+    ErrorHandler eh;
+    settings.SetErrorHandler(&eh);
+    
+    // the missing settings are added with their default values, and those 
+    // present are kept
+    Settings reloaded(path);
+    reloaded.SetErrorHandler(&eh);
+    for (int i = 0; i < 2; i++)
+    {
+        Settings& s = i == 0 ? settings : reloaded;
+        if (s.GetInt(LAYER_THICKNESS) != 15 ||
+            s.GetString(JOB_NAME_SETTING) != "OldJobName" ||
+            s.GetInt(BURN_IN_LAYERS) != 1 ||
+            s.GetDouble(MODEL_EXPOSURE) != 2.5 ||
+            s.GetString(DOWNLOAD_DIR) != "/var/smith/download")
+        {
+            std::cout << "%TEST_FAILED% time=0 testname=TestLoadMissingSettings (SettingsUT) message=wrong values after adding missing settings to " 
+                      << (i == 0 ? "loaded" : "saved") << " settings" << std::endl;
+            mainReturnValue = EXIT_FAILURE;
+        }
+    }
+    
+    if (gotError)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestLoadMissingSettings (SettingsUT) message=unexpected error" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        gotError = false;
+    }
+}
+
+void TestSetFromText()
+{
+    std::cout << "SettingsUT TestSetFromText" << std::endl;
+    
+    std::string testSettingsPath = tempDir + "/SetFromTextUT";
+    
+    Settings settings(testSettingsPath);
+    ErrorHandler eh;
+    settings.SetErrorHandler(&eh);
+    
+    // values are converted to the type of each setting
+    if (!settings.SetFromText(JOB_NAME_SETTING, "WhosYerDaddy") ||
+        !settings.SetFromText(LAYER_THICKNESS, "42") ||
+        !settings.SetFromText(MODEL_EXPOSURE, "3.14"))
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestSetFromText (SettingsUT) message=valid setting not set" << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+    VerifyModSettings(settings);
+    
+    // the change isn't persisted
+    Settings savedSettings(testSettingsPath);
+    VerifyDefaults(savedSettings);
+    
+    // values that can't be converted to the setting's type are rejected
+    settings.SetFromText(LAYER_THICKNESS, "42x");
+    VerifyExpectedError("setting int from invalid text");
+    settings.SetFromText(LAYER_THICKNESS, "");
+    VerifyExpectedError("setting int from empty text");
+    settings.SetFromText(MODEL_EXPOSURE, "pi");
+    VerifyExpectedError("setting double from invalid text");
+    settings.SetFromText("WhosYerMama", "42");
+    VerifyExpectedError("setting non-existent setting from text");
+    VerifyModSettings(settings);
+}
+
 int main(int argc, char** argv) {
     std::cout << "%SUITE_STARTING% SettingsUT" << std::endl;
     std::cout << "%SUITE_STARTED%" << std::endl;
@@ -482,6 +562,18 @@ int main(int argc, char** argv) {
     TearDown();
     std::cout << "%TEST_FINISHED% time=0 test1 (SettingsUT)" << std::endl;
 
+    std::cout << "%TEST_STARTED% TestLoadMissingSettings (SettingsUT)" << std::endl;
+    Setup();
+    TestLoadMissingSettings();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestLoadMissingSettings (SettingsUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestSetFromText (SettingsUT)" << std::endl;
+    Setup();
+    TestSetFromText();
+    TearDown();
+    std::cout << "%TEST_FINISHED% time=0 TestSetFromText (SettingsUT)" << std::endl;
+
     std::cout << "%SUITE_FINISHED% time=0" << std::endl;
 
     return (mainReturnValue);
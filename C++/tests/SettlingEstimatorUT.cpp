@@ -0,0 +1,158 @@
+//  File:   SettlingEstimatorUT.cpp
+//  Tests SettlingEstimator
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <iostream>
+
+#include <SettlingEstimator.h>
+
+int mainReturnValue = EXIT_SUCCESS;
+
+void CheckDelay(const char* testName, const SettlingEstimator& estimator,
+                LayerType type, double litFraction, int expectedMS)
+{
+    int delayMS = estimator.GetDelayMS(2000, 500, type, litFraction);
+    if (delayMS != expectedMS)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=" << testName 
+                << " (SettlingEstimatorUT) message=Expected delay of " 
+                << expectedMS << " ms, got " << delayMS << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+    }
+}
+
+void TestNoHistoryUsesConfiguredDelay()
+{
+    std::cout << "SettlingEstimatorUT TestNoHistoryUsesConfiguredDelay" << std::endl;
+
+    SettlingEstimator estimator;
+    CheckDelay("TestNoHistoryUsesConfiguredDelay", estimator, Model, 0.0, 2000);
+}
+
+void TestOnlyModelLayersShortened()
+{
+    std::cout << "SettlingEstimatorUT TestOnlyModelLayersShortened" << std::endl;
+
+    SettlingEstimator estimator;
+    for (int i = 0; i < 20; i++)
+        estimator.LayerCompleted();
+    
+    CheckDelay("TestOnlyModelLayersShortened", estimator, First, 0.0, 2000);
+    CheckDelay("TestOnlyModelLayersShortened", estimator, BurnIn, 0.0, 2000);
+    // a small area after enough jam-free layers gets the largest reduction
+    CheckDelay("TestOnlyModelLayersShortened", estimator, Model, 0.0, 500);
+    CheckDelay("TestOnlyModelLayersShortened", estimator, Model, 0.125, 1250);
+    // a large area always gets the full delay
+    CheckDelay("TestOnlyModelLayersShortened", estimator, Model, 0.5, 2000);
+}
+
+void TestReductionGrowsWithHistory()
+{
+    std::cout << "SettlingEstimatorUT TestReductionGrowsWithHistory" << std::endl;
+
+    SettlingEstimator estimator;
+    for (int i = 0; i < 5; i++)
+        estimator.LayerCompleted();
+    
+    // half way to full confidence, so half of the 1500 ms reduction
+    CheckDelay("TestReductionGrowsWithHistory", estimator, Model, 0.0, 1250);
+}
+
+void TestJamRestoresFullDelay()
+{
+    std::cout << "SettlingEstimatorUT TestJamRestoresFullDelay" << std::endl;
+
+    SettlingEstimator estimator;
+    for (int i = 0; i < 20; i++)
+        estimator.LayerCompleted();
+    
+    estimator.Jammed();
+    CheckDelay("TestJamRestoresFullDelay", estimator, Model, 0.0, 2000);
+    
+    // completing the jammed layer doesn't count as a success
+    estimator.LayerCompleted();
+    CheckDelay("TestJamRestoresFullDelay", estimator, Model, 0.0, 2000);
+    
+    estimator.LayerCompleted();
+    CheckDelay("TestJamRestoresFullDelay", estimator, Model, 0.0, 1850);
+    
+    estimator.Reset();
+    CheckDelay("TestJamRestoresFullDelay", estimator, Model, 0.0, 2000);
+}
+
+void TestMinimumRespected()
+{
+    std::cout << "SettlingEstimatorUT TestMinimumRespected" << std::endl;
+
+    SettlingEstimator estimator;
+    for (int i = 0; i < 20; i++)
+        estimator.LayerCompleted();
+    
+    int delayMS = estimator.GetDelayMS(2000, 1000, Model, 0.0);
+    if (delayMS != 1000)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMinimumRespected (SettlingEstimatorUT) "
+                << "message=Expected delay limited to minimum of 1000 ms, got " 
+                << delayMS << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+    
+    // a configured delay below the minimum is never lengthened
+    delayMS = estimator.GetDelayMS(200, 1000, Model, 0.0);
+    if (delayMS != 200)
+    {
+        std::cout << "%TEST_FAILED% time=0 testname=TestMinimumRespected (SettlingEstimatorUT) "
+                << "message=Expected configured delay of 200 ms, got " 
+                << delayMS << std::endl;
+        mainReturnValue = EXIT_FAILURE;
+        return;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "%SUITE_STARTING% SettlingEstimatorUT" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestNoHistoryUsesConfiguredDelay (SettlingEstimatorUT)" << std::endl;
+    TestNoHistoryUsesConfiguredDelay();
+    std::cout << "%TEST_FINISHED% time=0 TestNoHistoryUsesConfiguredDelay (SettlingEstimatorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestOnlyModelLayersShortened (SettlingEstimatorUT)" << std::endl;
+    TestOnlyModelLayersShortened();
+    std::cout << "%TEST_FINISHED% time=0 TestOnlyModelLayersShortened (SettlingEstimatorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestReductionGrowsWithHistory (SettlingEstimatorUT)" << std::endl;
+    TestReductionGrowsWithHistory();
+    std::cout << "%TEST_FINISHED% time=0 TestReductionGrowsWithHistory (SettlingEstimatorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestJamRestoresFullDelay (SettlingEstimatorUT)" << std::endl;
+    TestJamRestoresFullDelay();
+    std::cout << "%TEST_FINISHED% time=0 TestJamRestoresFullDelay (SettlingEstimatorUT)" << std::endl;
+
+    std::cout << "%TEST_STARTED% TestMinimumRespected (SettlingEstimatorUT)" << std::endl;
+    TestMinimumRespected();
+    std::cout << "%TEST_FINISHED% time=0 TestMinimumRespected (SettlingEstimatorUT)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (mainReturnValue);
+}
@@ -0,0 +1,208 @@
+//  File:   Benchmark.hpp
+//  Times repeated operations and compares the results against a stored
+//  baseline, for use in performance regression tests
+//
+//  This file is part of the Ember firmware.
+//
+//  Copyright 2016 Autodesk, Inc. <http://ember.autodesk.com/>
+//    
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE USEFUL,
+//  BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE IMPLIED WARRANTY OF
+//  MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.  SEE THE
+//  GNU GENERAL PUBLIC LICENSE FOR MORE DETAILS.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/filestream.h>
+#include <rapidjson/filereadstream.h>
+#include <rapidjson/prettywriter.h>
+
+#include <utils.h>
+
+// minimum time spent on each timed repetition of a benchmark
+constexpr double MIN_BENCHMARK_TIME_SEC = 0.2;
+// number of timed repetitions, the fastest of which is reported
+constexpr int BENCHMARK_REPETITIONS = 5;
+constexpr int LOAD_BUF_LEN = 1024;
+
+constexpr const char* BENCHMARKS_KEY = "benchmarks";
+constexpr const char* NS_PER_OP_KEY = "ns_per_op";
+constexpr const char* ITERATIONS_KEY = "iterations";
+
+// Prevent the compiler from discarding a value that the benchmark computes
+// but never uses.
+template <typename T>
+inline void KeepAlive(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    double nsPerOp;
+    long iterations;
+};
+
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(const std::string& filter) : _filter(filter) {}
+
+    // Time the given operation, if its name matches the filter.  The number
+    // of iterations is doubled until a repetition takes long enough to be 
+    // timed reliably, then the fastest of several repetitions is recorded, 
+    // as it is the one least disturbed by other activity on the system.
+    template <typename Operation>
+    void Run(const std::string& name, Operation op)
+    {
+        if (name.find(_filter) == std::string::npos)
+            return;
+        
+        long iterations = 1;
+        double elapsed = TimeIterations(op, iterations);
+        while (elapsed < MIN_BENCHMARK_TIME_SEC)
+        {
+            iterations *= 2;
+            elapsed = TimeIterations(op, iterations);
+        }
+        
+        double best = elapsed;
+        for (int i = 1; i < BENCHMARK_REPETITIONS; i++)
+        {
+            elapsed = TimeIterations(op, iterations);
+            if (elapsed < best)
+                best = elapsed;
+        }
+        
+        BenchmarkResult result = {name, best * 1e9 / iterations, iterations};
+        _results.push_back(result);
+        std::cout << name << ": " << result.nsPerOp << " ns/op (" 
+                  << iterations << " iterations)" << std::endl;
+    }
+
+    // Write the results as JSON to the given file.  The output can be used 
+    // directly as a baseline for later runs.
+    bool WriteResults(const std::string& path) const
+    {
+        FILE* pFile = fopen(path.c_str(), "w");
+        if (pFile == NULL)
+        {
+            std::cerr << "can't write benchmark results to " << path 
+                      << std::endl;
+            return false;
+        }
+        
+        rapidjson::FileStream fs(pFile);
+        rapidjson::PrettyWriter<rapidjson::FileStream> writer(fs);
+        writer.StartObject();
+        writer.String(BENCHMARKS_KEY);
+        writer.StartObject();
+        for (std::vector<BenchmarkResult>::const_iterator it = 
+                _results.begin(); it != _results.end(); it++)
+        {
+            writer.String(it->name.c_str());
+            writer.StartObject();
+            writer.String(NS_PER_OP_KEY);
+            writer.Double(it->nsPerOp);
+            writer.String(ITERATIONS_KEY);
+            writer.Int64(it->iterations);
+            writer.EndObject();
+        }
+        writer.EndObject();
+        writer.EndObject();
+        fputs("\n", pFile);
+        fclose(pFile);
+        return true;
+    }
+
+    // Compare the results against those in the given baseline file, and 
+    // return the number of benchmarks that took longer than their baseline 
+    // time by more than the given fraction.  Once a baseline has been 
+    // recorded, benchmarks missing from it are counted as regressions too, so
+    // that a new or renamed benchmark can't pass without a baseline time to 
+    // check it against.  Until then, the missing baseline is only reported.
+    int CompareToBaseline(const std::string& path, double tolerance) const
+    {
+        FILE* pFile = fopen(path.c_str(), "r");
+        if (pFile == NULL)
+        {
+            std::cerr << "can't read benchmark baseline " << path << std::endl;
+            return -1;
+        }
+        
+        char buf[LOAD_BUF_LEN];
+        rapidjson::FileReadStream frs(pFile, buf, LOAD_BUF_LEN);
+        rapidjson::Document doc;
+        doc.ParseStream(frs);
+        fclose(pFile);
+        
+        if (doc.HasParseError() || !doc.IsObject() || 
+            !doc.HasMember(BENCHMARKS_KEY) || !doc[BENCHMARKS_KEY].IsObject())
+        {
+            std::cerr << "invalid benchmark baseline " << path << std::endl;
+            return -1;
+        }
+        
+        const rapidjson::Value& baseline = doc[BENCHMARKS_KEY];
+        if (baseline.MemberBegin() == baseline.MemberEnd())
+        {
+            std::cout << "no baseline recorded in " << path 
+                      << ", copy the results there from the target hardware"
+                      << std::endl;
+            return 0;
+        }
+        
+        int regressions = 0;
+        for (std::vector<BenchmarkResult>::const_iterator it = 
+                _results.begin(); it != _results.end(); it++)
+        {
+            const char* name = it->name.c_str();
+            if (!baseline.HasMember(name) || 
+                !baseline[name].HasMember(NS_PER_OP_KEY))
+            {
+                std::cout << name << ": no baseline REGRESSION" << std::endl;
+                regressions++;
+                continue;
+            }
+            
+            double baselineNs = baseline[name][NS_PER_OP_KEY].GetDouble();
+            double change = (it->nsPerOp - baselineNs) / baselineNs;
+            bool regressed = change > tolerance;
+            if (regressed)
+                regressions++;
+            
+            std::cout << name << ": " << (change >= 0.0 ? "+" : "") 
+                      << change * 100.0 << "% vs. baseline " << baselineNs 
+                      << " ns/op" << (regressed ? " REGRESSION" : "") 
+                      << std::endl;
+        }
+        return regressions;
+    }
+
+private:
+    template <typename Operation>
+    double TimeIterations(Operation& op, long iterations)
+    {
+        double start = GetSeconds();
+        for (long i = 0; i < iterations; i++)
+            op();
+        return GetSeconds() - start;
+    }
+
+    std::string _filter;
+    std::vector<BenchmarkResult> _results;
+};
@@ -25,6 +25,8 @@
 #include <time.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <string.h>
+#include <errno.h>
 #include <string>
 #include <fcntl.h>
 #include <dirent.h>
@@ -32,6 +34,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <atomic>
 #include <stdlib.h>
 #include <ifaddrs.h>
 #include <netinet/in.h> 
@@ -63,14 +66,42 @@ using namespace rapidjson;
 #include "Hardware.h"
 #include "Build.h"
 
+// when not negative, the time in seconds returned by GetSeconds and 
+// GetMillis instead of the system clock, for replaying recorded events.
+// Atomic since it may be read from threads other than the one replaying.
+std::atomic<double> virtualSeconds(-1.0);
+
 // Get the current time in millliseconds
 long GetMillis(){
+    double seconds = virtualSeconds.load();
+    if (seconds >= 0.0)
+        return seconds * 1000;
+    
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     // printf("time = %d sec + %ld nsec\n", now.tv_sec, now.tv_nsec);
     return now.tv_sec * 1000 + now.tv_nsec / 1000000;
 }
 
+// Get the current time in seconds, with sub-millisecond resolution
+double GetSeconds()
+{
+    double seconds = virtualSeconds.load();
+    if (seconds >= 0.0)
+        return seconds;
+    
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Set the time returned by GetSeconds and GetMillis, or use the system clock 
+// again if the given time is negative
+void SetVirtualSeconds(double seconds)
+{
+    virtualSeconds = seconds;
+}
+
 long startTime = 0;
 
 // Start the stopwatch timer
@@ -277,6 +308,33 @@ bool Copy(const std::string& sourcePath,
     return true;
 }
 
+// Take ownership of the file specified by sourcePath, moving it to 
+// destinationPath (a full file path) without copying its contents when both
+// are on the same file system.  Otherwise the file is copied and the source 
+// removed.  Returns false if the file could not be moved, in which case the 
+// source is left in place.
+bool Adopt(const std::string& sourcePath, const std::string& destinationPath)
+{
+    if (rename(sourcePath.c_str(), destinationPath.c_str()) == 0)
+        return true;
+    
+    if (errno != EXDEV)
+    {
+        std::cerr << "could not move file (" << sourcePath << ") to (" 
+                  << destinationPath << "): " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    if (!Copy(sourcePath, destinationPath))
+    {
+        remove(destinationPath.c_str());
+        return false;
+    }
+    
+    remove(sourcePath.c_str());
+    return true;
+}
+
 // Makes a directory if it does not exist
 int MkdirCheck(const std::string& path)
 {
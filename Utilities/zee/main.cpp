@@ -24,13 +24,17 @@
 #include <cstdlib>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <stdexcept>
 
 #include <Hardware.h>
 #include <Motor.h>
 #include <MotorController.h>
 #include <Settings.h>
 #include <LayerSettings.h>
+#include <MotionTuner.h>
 #include "I2C_Device.h"
+#include "GPIO_Interrupt.h"
 
 using namespace std;
 
@@ -63,6 +67,7 @@ void LoadCurrentLayerSettings()
     firstLS.ApproachZJerk = settings.GetInt(FL_APPROACH_Z_JERK);
     firstLS.ApproachMicronsPerSec = settings.GetInt(FL_APPROACH_Z_SPEED);
     firstLS.LayerThicknessMicrons = settings.GetInt(LAYER_THICKNESS);
+    firstLS.Type = First;
 
     burninLS.PressMicrons = settings.GetInt(BI_PRESS);
     burninLS.PressMicronsPerSec = settings.GetInt(BI_PRESS_SPEED);
@@ -81,6 +86,7 @@ void LoadCurrentLayerSettings()
     burninLS.ApproachZJerk = settings.GetInt(BI_APPROACH_Z_JERK);
     burninLS.ApproachMicronsPerSec = settings.GetInt(BI_APPROACH_Z_SPEED);
     burninLS.LayerThicknessMicrons = settings.GetInt(LAYER_THICKNESS);
+    burninLS.Type = BurnIn;
 
     modelLS.PressMicrons = settings.GetInt(ML_PRESS);
     modelLS.PressMicronsPerSec = settings.GetInt(ML_PRESS_SPEED);
@@ -99,6 +105,163 @@ void LoadCurrentLayerSettings()
     modelLS.ApproachZJerk = settings.GetInt(ML_APPROACH_Z_JERK);
     modelLS.ApproachMicronsPerSec = settings.GetInt(ML_APPROACH_Z_SPEED);
     modelLS.LayerThicknessMicrons = settings.GetInt(LAYER_THICKNESS);
+    modelLS.Type = Model;
+}
+
+void getPinInput();
+
+// Runs one separation and approach of a motion profile being tuned, verifying 
+// that the tray passed the rotation sensor and that the motor controller 
+// reported success for both moves.  The approach returns the build head to 
+// the height it started from, rather than a layer higher, so that trials 
+// don't raise it further each time.
+class TuningTrial : public IMotionTrial
+{
+public:
+    TuningTrial(Motor& motor, const I_I2C_Device& i2cDevice) :
+    _motor(motor),
+    _i2cDevice(i2cDevice),
+    _rotationSensor(ROTATION_SENSOR_PIN, GPIO_INTERRUPT_EDGE_FALLING)
+    {
+    }
+    
+    bool Run(const CurrentLayerSettings& cls)
+    {
+        // discard any edge seen before this separation
+        _rotationSensor.Read();
+        
+        _motor.Separate(cls);
+        getPinInput();
+        bool succeeded = GotRotationEdge() && MotionSucceeded();
+        
+        if(succeeded)
+        {
+            CurrentLayerSettings sameLayer = cls;
+            sameLayer.LayerThicknessMicrons = 0;
+            _motor.Approach(sameLayer);
+            getPinInput();
+            succeeded = MotionSucceeded();
+        }
+        
+        printf("separation at %d RPM, %d microns/s: %s\n", cls.SeparationRPM,
+               cls.SeparationMicronsPerSec, succeeded ? "OK" : "failed");
+        
+        if(!succeeded)
+        {
+            // get the tray back to a known position before going on
+            _motor.GoToStartPosition();
+            getPinInput();
+        }
+        return succeeded;
+    }
+    
+private:
+    // the sysfs GPIO signals an edge with POLLPRI until its value is read
+    bool GotRotationEdge()
+    {
+        // as when printing, there's nothing to check without jam detection 
+        // or on old hardware lacking the sensor
+        if(settings.GetInt(DETECT_JAMS) == 0 || 
+           settings.GetInt(HARDWARE_REV) == 0)
+            return true;
+        
+        struct pollfd fds = {_rotationSensor.GetFileDescriptor(), POLLPRI, 0};
+        return poll(&fds, 1, 0) == 1 && (fds.revents & POLLPRI);
+    }
+    
+    bool MotionSucceeded()
+    {
+        return _i2cDevice.Read(MC_STATUS_REG) == MC_STATUS_SUCCESS;
+    }
+    
+    Motor& _motor;
+    const I_I2C_Device& _i2cDevice;
+    GPIO_Interrupt _rotationSensor;
+};
+
+// Find and record the fastest reliable separation and approach profiles for 
+// each layer type, starting from the current settings.  Requires a tray 
+// (without resin) and build head to be in place.
+void AutoTune(Motor& motor, const I_I2C_Device& i2cDevice)
+{
+    const CurrentLayerSettings* layers[] = {&firstLS, &burninLS, &modelLS};
+    const char* layerNames[] = {"first", "burn-in", "model"};
+    
+    try
+    {
+        TuningTrial trial(motor, i2cDevice);
+        MotionTuner tuner(settings, trial);
+
+        motor.GoToStartPosition();
+        getPinInput();
+
+        for(int i = 0; i < 3; i++)
+        {
+            double factor = tuner.Tune(*layers[i]);
+            if(factor == 0.0)
+                printf("current %s layer profile isn't reliable, "
+                       "so it wasn't changed\n", layerNames[i]);
+            else
+                printf("recorded %s layer profile at %.0f%% of previous "
+                       "speeds and jerks\n", layerNames[i], factor * 100.0);
+        }
+
+        motor.GoHome();
+        getPinInput();
+    }
+    catch(const std::exception& e)
+    {
+        printf("Unable to tune motion profiles: %s\n", e.what());
+    }
+    
+    // use the recorded profiles for any further commands
+    LoadCurrentLayerSettings();
+}
+
+// names of the motor controller's profiled interrupt service routines and 
+// state machine events, in the order of their profiling registers
+const char* profiledISRNames[] = {"DDA ISR", "exec ISR", "load ISR", 
+                                  "I2C ISR"};
+const char* profiledEventNames[MC_PROFILE_EVENT_COUNT] = {
+    "ResetRequested", "HomeZAxisRequested", "HomeRAxisRequested", 
+    "MoveZAxisRequested", "MoveRAxisRequested", "DisableRequested", 
+    "EnableRequested", "SetZAxisSettingRequested", "SetRAxisSettingRequested",
+    "InterruptRequested", "AxisLimitReached", "MotionComplete", 
+    "PauseRequested", "ResumeRequested", "ClearRequested", "ErrorEncountered",
+    "DecelerationStarted", "AxisAtLimit"};
+
+// Print the CPU cycles the motor controller has spent in each of its 
+// interrupt service routines and state machine events, which it only 
+// accounts for when its firmware is built with PROFILE=1
+void PrintProfile(const I_I2C_Device& i2cDevice)
+{
+    printf("%-26s %10s %10s %10s\n", "", "max cycles", "avg cycles", "calls");
+    
+    for(uint8_t reg = MC_PROFILE_DDA_ISR_REG; 
+        reg < MC_PROFILE_REG_HIGH_FENCEPOST; reg++)
+    {
+        unsigned char data[MC_PROFILE_DATA_SIZE];
+        if(!i2cDevice.Read(reg, data, MC_PROFILE_DATA_SIZE))
+        {
+            printf("Unable to read profiling register 0x%x\n", reg);
+            return;
+        }
+        
+        // the data is little-endian
+        uint32_t maxTicks = data[0] | (data[1] << 8);
+        uint32_t calls = data[2] | (data[3] << 8);
+        uint32_t totalTicks = data[4] | (data[5] << 8) | (data[6] << 16) | 
+                              (static_cast<uint32_t>(data[7]) << 24);
+        
+        const char* name = reg < MC_PROFILE_EVENT_REG ? 
+                        profiledISRNames[reg - MC_PROFILE_DDA_ISR_REG] :
+                        profiledEventNames[reg - MC_PROFILE_EVENT_REG];
+        printf("%-26s %10u %10u %10u\n", name, 
+               maxTicks * MC_PROFILE_CYCLES_PER_TICK,
+               calls > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(
+                    totalTicks) * MC_PROFILE_CYCLES_PER_TICK / calls) : 0,
+               calls);
+    }
 }
 
 /// Parse input and send appropriate command to motor controller.  Returns true 
@@ -196,6 +359,14 @@ bool SendCommand(char* cmd, Motor& motor, const I_I2C_Device& i2cDevice)
             case 'D':   // disable
                 MotorCommand(MC_GENERAL_REG, MC_DISABLE).Send(i2cDevice);                
                 break;
+                
+            case 'O':   // print profile of motor controller CPU usage
+                PrintProfile(i2cDevice);
+                break;
+                
+            case 'A':   // auto-tune separation and approach profiles
+                AutoTune(motor, i2cDevice);
+                break;
                     
             default:
                 printf("Unknown command: %c\n", cmd[0]);
@@ -35,8 +35,12 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/_ext/56246743/GPIO_Interrupt.o \
 	${OBJECTDIR}/_ext/56246743/I2C_Device.o \
+	${OBJECTDIR}/_ext/56246743/LayerArena.o \
 	${OBJECTDIR}/_ext/56246743/Logger.o \
+	${OBJECTDIR}/_ext/56246743/Metrics.o \
+	${OBJECTDIR}/_ext/56246743/MotionTuner.o \
 	${OBJECTDIR}/_ext/56246743/Motor.o \
 	${OBJECTDIR}/_ext/56246743/MotorCommand.o \
 	${OBJECTDIR}/_ext/56246743/PrinterStatus.o \
@@ -70,16 +74,36 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/zee: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/zee ${OBJECTFILES} ${LDLIBSOPTIONS} -lrt -ltar -lz -liw
 
+${OBJECTDIR}/_ext/56246743/GPIO_Interrupt.o: ../../C++/GPIO_Interrupt.cpp 
+	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/GPIO_Interrupt.o ../../C++/GPIO_Interrupt.cpp
+
 ${OBJECTDIR}/_ext/56246743/I2C_Device.o: ../../C++/I2C_Device.cpp 
 	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/I2C_Device.o ../../C++/I2C_Device.cpp
 
+${OBJECTDIR}/_ext/56246743/LayerArena.o: ../../C++/LayerArena.cpp 
+	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/LayerArena.o ../../C++/LayerArena.cpp
+
 ${OBJECTDIR}/_ext/56246743/Logger.o: ../../C++/Logger.cpp 
 	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/Logger.o ../../C++/Logger.cpp
 
+${OBJECTDIR}/_ext/56246743/Metrics.o: ../../C++/Metrics.cpp 
+	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/Metrics.o ../../C++/Metrics.cpp
+
+${OBJECTDIR}/_ext/56246743/MotionTuner.o: ../../C++/MotionTuner.cpp 
+	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../../C++/include -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/56246743/MotionTuner.o ../../C++/MotionTuner.cpp
+
 ${OBJECTDIR}/_ext/56246743/Motor.o: ../../C++/Motor.cpp 
 	${MKDIR} -p ${OBJECTDIR}/_ext/56246743
 	${RM} "$@.d"
@@ -7,6 +7,7 @@ module Smith
   STATUS_TO_WEB_PIPE = '/tmp/StatusToWebPipe'
   ROOT_DIR = '/var/smith'
   SETTINGS_FILE = '/config/settings'
+  PRINT_FILE_HANDOFF_DIR = '/handoff'
   TEMP_SETTINGS_FILE = '/tmp/print_settings'
   PRIMARY_REGISTRATION_INFO_FILE = '/tmp/printer_registration'
   PRINTER_STATUS_FILE = '/run/printer_status'
@@ -19,6 +20,7 @@ module Smith
   CMD_RESET_PRINTER = 'RESET'
   CMD_REFRESH_SETTINGS = 'REFRESH'
   CMD_APPLY_SETTINGS = 'APPLYSETTINGS'
+  CMD_SET_SETTING = 'SET'
   CMD_TEST = 'TEST'
   CMD_CAL_IMAGE = 'CALIMAGE'
   CMD_EXIT = 'EXIT'
@@ -28,6 +30,7 @@ module Smith
   CMD_START_PRINT_DATA_LOAD = 'STARTPRINTDATALOAD'
   CMD_SHOW_PRINT_DATA_LOADED = 'SHOWPRINTDATALOADED'
   CMD_PROCESS_PRINT_DATA = 'PROCESSPRINTDATA'
+  CMD_ADOPT_PRINT_DATA = 'ADOPTPRINTDATA'
   CMD_REGISTRATION_CODE = 'DISPLAYPRIMARYREGISTRATIONCODE'
   CMD_REGISTERED = 'PRIMARYREGISTRATIONSUCCEEDED'
   CMD_SHOW_WIRELESS_CONNECTING = 'SHOWWIRELESSCONNECTING'
@@ -26,6 +26,10 @@ module Smith
     class CommunicationError < StandardError; end
     class InvalidState < StandardError; end
 
+    # Writes to the command pipe of up to PIPE_BUF bytes are atomic, longer
+    # commands could be interleaved with those from other writers
+    MAX_COMMAND_BYTES = 4096
+
     module_function
 
     def serial_number
@@ -48,10 +52,35 @@ module Smith
       send_command(CMD_PROCESS_PRINT_DATA)
     end
 
+    # Hand the print file at path over to smith, which moves it into the print
+    # data directory as file_name (rather than having it copied there) and
+    # then processes it
+    def adopt_print_data(path, file_name)
+      send_command("#{CMD_ADOPT_PRINT_DATA} #{path} #{file_name}")
+    end
+
     def apply_settings_file
       send_command(CMD_APPLY_SETTINGS)
     end
 
+    # Apply settings given as a hash, inline if the command fits in a single
+    # write to the command pipe and through the settings file otherwise
+    def apply_settings(settings)
+      command = "#{CMD_APPLY_SETTINGS} #{settings.to_json}"
+      if command.bytesize + 1 > MAX_COMMAND_BYTES
+        write_settings_file(settings)
+        apply_settings_file
+      else
+        send_command(command)
+      end
+    end
+
+    # Change a single setting in smith's memory without saving it, although
+    # smith saves it along with the next change to any other setting
+    def set_setting(name, value)
+      send_command("#{CMD_SET_SETTING} #{name} #{value}")
+    end
+
     def show_loaded
       send_command(CMD_SHOW_PRINT_DATA_LOADED)
     end
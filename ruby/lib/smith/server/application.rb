@@ -21,6 +21,8 @@
 #  You should have received a copy of the GNU General Public License
 #  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+require 'tempfile'
+require 'fileutils'
 require 'sinatra/base'
 require 'sinatra/partial'
 require 'sinatra/contrib'
@@ -46,6 +48,15 @@ module Smith
       register Sinatra::RespondWith
       use Rack::Flash
 
+      # Receive uploads in the hand-off directory rather than /tmp, which is a
+      # separate mount, so smith can move uploaded print files into place
+      use Rack::Config do |env|
+        env['rack.multipart.tempfile_factory'] = lambda do |filename, content_type|
+          FileUtils.mkdir_p(Settings.print_file_handoff_dir)
+          Tempfile.new(['RackMultipart', File.extname(filename)], Settings.print_file_handoff_dir)
+        end
+      end
+
       set :app_file, __FILE__
       set :partial_template_engine, :erb
       set :bind, '0.0.0.0'
@@ -28,9 +28,13 @@ module Smith
       VALID_FILE_REGEXES = [/\A.+?\.tar\.gz\z/i, /\A.+?\.zip\z/i]
 
       helpers do
-        def copy_print_file
-          FileUtils.copy(@print_file[:tempfile].path,
-            File.join(Settings.print_data_dir, @print_file[:filename]))
+        # Link the uploaded file, which is received in the hand-off directory,
+        # under a second name that smith takes ownership of, so it survives the
+        # tempfile being closed and can be moved into place without copying
+        def hand_off_print_file
+          path = "#{@print_file[:tempfile].path}.adopt"
+          File.link(@print_file[:tempfile].path, path)
+          path
         end
 
         def validate_print_file
@@ -53,9 +57,10 @@ module Smith
           Printer.validate_can_load_print_data
           Printer.purge_print_data_dir
           Printer.show_loading
-          copy_print_file
-          Printer.process_print_data
+          handoff_path = hand_off_print_file
+          Printer.adopt_print_data(handoff_path, @print_file[:filename])
         rescue Smith::Printer::CommunicationError, Smith::Printer::InvalidState => e
+          FileUtils.rm_f(handoff_path) if handoff_path
           flash.now[:error] = e.message
           respond_with :new_print_file_upload do |f|
             f.json { error 500, flash_json }
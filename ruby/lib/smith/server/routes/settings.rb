@@ -40,8 +40,7 @@ module Smith
         content_type 'application/json'
         begin
           request.body.rewind
-          Printer.write_settings_file(JSON.parse(request.body.read))
-          Printer.apply_settings_file
+          Printer.apply_settings(JSON.parse(request.body.read))
           status 200
         rescue JSON::ParserError => e
           halt 400, { error: 'Unable to parse body as JSON' }.to_json
@@ -50,6 +49,22 @@ module Smith
         end
       end
 
+      # Change a single setting, given its value as plain text in the body
+      put '/settings/:name' do
+        content_type 'application/json'
+        request.body.rewind
+        value = request.body.read
+        if params[:name] !~ /\A\w+\z/ || value =~ /[\r\n\0]/
+          halt 400, { error: 'Invalid setting name or value' }.to_json
+        end
+        begin
+          Printer.set_setting(params[:name], value)
+          status 200
+        rescue Smith::Printer::CommunicationError => e
+          halt 500, { error: e.message }.to_json
+        end
+      end
+
     end
   end
 end
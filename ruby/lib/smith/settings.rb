@@ -80,6 +80,10 @@ module Smith
     # Print file download/upload directory
     print_data_dir: '/var/smith/download',
 
+    # Directory that uploaded print files are received in to be handed over to
+    # smith, on the same mount as print_data_dir
+    print_file_handoff_dir: "#{ROOT_DIR}#{PRINT_FILE_HANDOFF_DIR}",
+
     # Firmware images directory
     firmware_dir: '/main/firmware',
 
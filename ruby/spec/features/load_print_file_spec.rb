@@ -29,13 +29,19 @@ module Smith
 
     let(:print_file) { resource 'print.tar.gz' }
     let(:stale_print_file) { File.join(print_data_dir, 'old_print.tar.gz') }
-    let(:uploaded_print_file) { File.join(print_data_dir, 'print.tar.gz') }
+    let(:uploaded_file_name) { 'print.tar.gz' }
     let(:response_body) { JSON.parse(last_response.body, symbolize_names: true) }
 
     def assert_print_file_processed
-      expect(File.read(uploaded_print_file)).to eq(File.read(print_file))
       expect(next_command_in_command_pipe).to eq(CMD_START_PRINT_DATA_LOAD)
-      expect(next_command_in_command_pipe).to eq(CMD_PROCESS_PRINT_DATA)
+      command, handoff_path, file_name = next_command_in_command_pipe.split(' ', 3)
+      expect(command).to eq(CMD_ADOPT_PRINT_DATA)
+      expect(file_name).to eq(uploaded_file_name)
+      # uploads are received where smith accepts hand-offs from
+      expect(File.dirname(handoff_path)).to eq(print_file_handoff_dir)
+      # the uploaded file is handed over intact for smith to move into place
+      expect(File.read(handoff_path)).to eq(File.read(print_file))
+      FileUtils.rm_f(handoff_path)
     end
 
     context 'when communication via command pipe is possible' do
@@ -72,7 +78,7 @@ module Smith
 
         let(:print_file) { resource 'print.zip' }
         let(:stale_print_file) { File.join(print_data_dir, 'old_print.zip') }
-        let(:uploaded_print_file) { File.join(print_data_dir, 'print.zip') }
+        let(:uploaded_file_name) { 'print.zip' }
 
         scenario 'user loads print file when printer is ready' do
           # Create a stale print file
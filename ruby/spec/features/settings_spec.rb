@@ -67,15 +67,39 @@ module Smith
 
             expect(last_response.status).to eq(200)
 
-            # writes temp settings file
-            expect(File.file?(temp_settings_file)).to eq(true)
+            # sends command to smith to apply the settings given inline
+            expect(next_command_in_command_pipe).to eq("#{CMD_APPLY_SETTINGS} #{settings.to_json}")
+
+            # does not need the temp settings file
+            expect(File.file?(temp_settings_file)).to eq(false)
+          end
+
+          scenario 'update settings too large to send inline' do
+            large_settings = { SETTINGS_ROOT_KEY => { 'JobName' => 'x' * Printer::MAX_COMMAND_BYTES } }
+            put '/settings', large_settings.to_json
+
+            expect(last_response.status).to eq(200)
 
             # writes specified settings to temp settings file
-            expect(JSON.parse(File.read(temp_settings_file))).to eq(settings)
+            expect(JSON.parse(File.read(temp_settings_file))).to eq(large_settings)
 
             # sends command to smith to apply settings written to temp settings file
             expect(next_command_in_command_pipe).to eq(CMD_APPLY_SETTINGS)
           end
+
+          scenario 'update single setting successfully' do
+            put '/settings/ModelExposureSec', '3.2'
+
+            expect(last_response.status).to eq(200)
+            expect(next_command_in_command_pipe).to eq("#{CMD_SET_SETTING} ModelExposureSec 3.2")
+          end
+
+          scenario 'value of single setting spans lines' do
+            put '/settings/JobName', "first\nsecond"
+
+            expect(last_response.status).to eq(400)
+            expect(parsed_response_body[:error]).to match(/Invalid setting name or value/i)
+          end
         end
 
         context 'when communication via command pipe is not possible' do
@@ -86,6 +110,14 @@ module Smith
 
             expect(parsed_response_body[:error]).to match(/Unable to send command/i)
           end
+
+          scenario 'fail to update single setting' do
+            put '/settings/ModelExposureSec', '3.2'
+
+            expect(last_response.status).to eq(500)
+
+            expect(parsed_response_body[:error]).to match(/Unable to send command/i)
+          end
         end
       end
 
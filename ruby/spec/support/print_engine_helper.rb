@@ -31,6 +31,7 @@ module PrintEngineHelper
       include FileHelper
       let(:command_pipe) { tmp_dir 'command_pipe' }
       let(:print_data_dir) { tmp_dir 'print_data' }
+      let(:print_file_handoff_dir) { tmp_dir 'handoff' }
       let(:printer_status_file) { tmp_dir 'printer_status' }
 
       # Helper methods provided by this module require a temporary directory
@@ -88,6 +89,7 @@ module PrintEngineHelper
 
   def create_print_data_dir
     FileUtils.mkdir(Smith::Settings.print_data_dir = print_data_dir)
+    Smith::Settings.print_file_handoff_dir = print_file_handoff_dir
   end
 
   def keys_to_symbols(hash)
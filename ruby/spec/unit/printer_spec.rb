@@ -76,6 +76,41 @@ module Smith
 
     end
 
+    context 'when applying settings' do
+
+      include_context 'print engine ready'
+
+      let(:temp_settings_file) { tmp_dir 'temp_settings' }
+
+      before { Settings.settings_file = temp_settings_file }
+
+      it 'sends settings that fit in one write inline' do
+        settings = { SETTINGS_ROOT_KEY => { 'ModelExposureSec' => 3.2 } }
+        subject.apply_settings(settings)
+        expect(next_command_in_command_pipe).to eq("#{CMD_APPLY_SETTINGS} #{settings.to_json}")
+        expect(File.file?(temp_settings_file)).to eq(false)
+      end
+
+      it 'sends larger settings through the settings file' do
+        settings = { SETTINGS_ROOT_KEY => { 'JobName' => 'x' * Printer::MAX_COMMAND_BYTES } }
+        subject.apply_settings(settings)
+        expect(next_command_in_command_pipe).to eq(CMD_APPLY_SETTINGS)
+        expect(JSON.parse(File.read(temp_settings_file))).to eq(settings)
+      end
+
+    end
+
+    context 'when setting a single setting' do
+
+      include_context 'print engine ready'
+
+      it 'sends the name and value' do
+        subject.set_setting('ModelExposureSec', 3.2)
+        expect(next_command_in_command_pipe).to eq("#{CMD_SET_SETTING} ModelExposureSec 3.2")
+      end
+
+    end
+
     context 'when getting status' do
      
       context 'when status file exists' do 
@@ -222,8 +222,20 @@ module Tests
   MC_ROT_ACTION_REG = 0xA3
   MC_Z_SETTINGS_REG = 0xA4
   MC_Z_ACTION_REG = 0xA5
-  MC_COMMAND_REG_HIGH_FENCEPOST = 0xA6
+  MC_SEQUENCE_REG = 0xA6
+  MC_COMMAND_REG_HIGH_FENCEPOST = 0xA7
   MC_STATUS_REG = 0x30
+  MC_QUEUE_REG = 0x31
+  MC_PROFILE_REG_LOW_FENCEPOST = 0x3F
+  MC_PROFILE_DDA_ISR_REG = 0x40
+  MC_PROFILE_EXEC_ISR_REG = 0x41
+  MC_PROFILE_LOAD_ISR_REG = 0x42
+  MC_PROFILE_I2C_ISR_REG = 0x43
+  MC_PROFILE_EVENT_REG = 0x44
+  MC_PROFILE_EVENT_COUNT = 18
+  MC_PROFILE_REG_HIGH_FENCEPOST = 0x56
+  MC_PROFILE_DATA_SIZE = 8
+  MC_PROFILE_CYCLES_PER_TICK = 8
   MC_GENERAL_LOW_FENCEPOST = 0
   MC_INTERRUPT = 1
   MC_RESET = 2
@@ -242,6 +254,9 @@ module Tests
   MC_MOVE = 1
   MC_HOME = 2
   MC_ACTION_HIGH_FENCEPOST = 3
+  MC_TAG = 1
+  MC_SEQUENCE_HIGH_FENCEPOST = 2
+  MC_MAX_TAG = 255
   MC_STATUS_SUCCESS = 0
   MC_STATUS_ERROR = 1
   MC_STATUS_EAGAIN = 2
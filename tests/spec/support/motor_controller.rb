@@ -139,7 +139,8 @@ module Tests
       @z_axis_settings = AxisSettings.new # holds the current z axis settings
       @enabled = false                    # flag recording whether or not the motor controller is enabled
       @movements = []                     # array holding movement requests sent to motor controller
-      @interrupt_requests = 0             # number of interrupt requests sent to motor controller
+      @interrupt_requests = []            # tags of interrupt requests sent to motor controller (0 if untagged)
+      @last_completed_tag = 0             # tag of the last interrupt request responded to
       @read_status_requested = false      # synchronization flag
       @cleared = false                    # has motor controller received an MC_CLEAR command
       @paused = false                     # is motor controller paused
@@ -189,10 +190,11 @@ module Tests
     # Raises an exception if the motor controller did not receive an interrupt request within the synchronization timeout
     # Blocks (with timeout) until the motor controller receives an interrupt request
     def respond_to_interrupt_request
-      if synchronize { @interrupt_requests > 0 }
+      if synchronize { @interrupt_requests.any? }
+        tag = @interrupt_requests.shift
+        @last_completed_tag = tag unless tag == 0
         @interrupt_read_pipe.write('1')
         @interrupt_read_pipe.flush
-        @interrupt_requests -= 1
         synchronize { @read_status_requested }
         @read_status_requested = false
       else
@@ -217,6 +219,14 @@ module Tests
         return
       end
 
+      if unpacked_data == MC_QUEUE_REG && !@buffer.has_partial_command?
+        # write last completed tag and free command slots to pipe that main firmware reads I2C data from
+        # commands are handled as soon as they arrive, so all of the buffer's slots are always free
+        @i2c_read_pipe.write([@last_completed_tag, CommandBuffer::COMMAND_CAPACITY].pack('CC'))
+        @i2c_read_pipe.flush
+        return
+      end
+
       @buffer.add(data)
 
       if @buffer.has_command?
@@ -233,6 +243,8 @@ module Tests
             settings_command(command.action, command.parameter, @z_axis_settings)
           when MC_Z_ACTION_REG
             action_command(command.action, command.parameter, @z_axis_settings, :z)
+          when MC_SEQUENCE_REG
+            sequence_command(command.action, command.parameter)
           else
             @status = MC_STATUS_COMMAND_UNKNOWN
         end
@@ -266,7 +278,7 @@ module Tests
     def general_command(action)
       case action
         when MC_INTERRUPT
-          @interrupt_requests += 1
+          @interrupt_requests << 0
         when MC_RESET
           @r_axis_settings.reset
           @z_axis_settings.reset
@@ -303,6 +315,16 @@ module Tests
       end
     end
 
+    # Processes commands sent to the sequence register
+    def sequence_command(action, parameter)
+      case action
+        when MC_TAG
+          @interrupt_requests << parameter
+        else
+          @status = MC_STATUS_COMMAND_UNKNOWN
+      end
+    end
+
     # Processes commands sent to an action register
     def action_command(action, parameter, axis_settings, axis)
       case action